@@ -0,0 +1,691 @@
+/*
+ * ConnectionCommands.cpp - implementation of ConnectionCommands class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QLocale>
+#include <QMetaEnum>
+#include <QTimer>
+#include <QtConcurrent>
+
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
+#include "AuthenticationManager.h"
+#include "ComputerControlInterface.h"
+#include "ConnectionCommands.h"
+#include "VncConnection.h"
+#include "VncConnectionReactor.h"
+#include "VncConnectionScheduler.h"
+#include "VncCursorShapeCache.h"
+
+
+ConnectionCommands::ConnectionCommands( QObject* parent ) :
+	QObject( parent ),
+	m_commands( {
+		{ statisticsCommand(), tr( "Show transport statistics of connections to remote hosts" ) },
+		{ reconnectCommand(), tr( "Measure the connection handshake rate when reconnecting to remote hosts" ) },
+		{ inputCommand(), tr( "Measure the latency of input events sent to remote hosts" ) }
+	} )
+{
+}
+
+
+
+QStringList ConnectionCommands::commands() const
+{
+	return m_commands.keys();
+}
+
+
+
+QString ConnectionCommands::commandHelp( const QString& command ) const
+{
+	return m_commands.value( command );
+}
+
+
+
+CommandLinePluginInterface::RunResult ConnectionCommands::handle_help( const QStringList& arguments )
+{
+	const auto command = arguments.value( 0 );
+	if( command.isEmpty() )
+	{
+		error( tr("Please specify the command to display help for.") );
+		return NoResult;
+	}
+
+	if( command == statisticsCommand() )
+	{
+		printUsage( commandLineModuleName(), statisticsCommand(),
+					{ { tr("HOST ADDRESSES"), {} } },
+					{ { tr("DURATION"), {} }, { tr("MODE"), {} } } );
+
+		printDescription( tr("Connects to the Veyon Server on all specified hosts (separated by commas) like "
+							  "Veyon Master does in monitoring mode and displays the amount of transferred data, "
+							  "framebuffer update rates, throughput, round trip and decoding times, the current "
+							  "(adaptive) quality and compression level as well as the received data per encoding "
+							  "after the specified number of seconds (default: %1). "
+							  "Additionally the number of threads and the CPU time used by this process are displayed "
+							  "which allows comparing the thread-per-connection model with shared I/O threads "
+							  "(VncConnection/IoThreadCount) against a larger number of hosts. If \"%2\" is specified "
+							  "as mode, framebuffer updates are requested like in the remote view instead (pipelined "
+							  "update requests), which allows measuring the achievable frame rate with additional "
+							  "latency, e.g. added via \"tc qdisc add dev lo root netem delay 20ms\".")
+						  .arg( DefaultMeasurementDuration ).arg( liveMode() ) );
+
+		printExamples( commandLineModuleName(), statisticsCommand(),
+					   {
+						   { tr( "Measure connections to two computers for 30 seconds" ),
+							   { QStringLiteral("192.168.1.2,192.168.1.3"), QStringLiteral("30") }
+						   },
+						   { tr( "Measure the frame rate of a remote view to a local Veyon Server for 10 seconds" ),
+							   { QStringLiteral("localhost"), QStringLiteral("10"), liveMode() }
+						   }
+					   } );
+
+		return NoResult;
+	}
+
+	if( command == reconnectCommand() )
+	{
+		printUsage( commandLineModuleName(), reconnectCommand(),
+					{ { tr("HOST ADDRESSES"), {} } },
+					{ { tr("ROUNDS"), {} } } );
+
+		printDescription( tr("Connects to the Veyon Server on all specified hosts (separated by commas) simultaneously "
+							  "for the specified number of rounds (default: %1) and displays the achieved number of "
+							  "connection handshakes per second. The measurement is performed once with full "
+							  "authentications and once with authentication tickets. Authentication tickets "
+							  "have to be enabled on the hosts by setting Authentication/TicketLifetime.").arg( DefaultReconnectRounds ) );
+
+		printExamples( commandLineModuleName(), reconnectCommand(),
+					   {
+						   { tr( "Reconnect to two computers 50 times" ),
+							   { QStringLiteral("192.168.1.2,192.168.1.3"), QStringLiteral("50") }
+						   }
+					   } );
+
+		return NoResult;
+	}
+
+	if( command == inputCommand() )
+	{
+		printUsage( commandLineModuleName(), inputCommand(),
+					{ { tr("HOST ADDRESSES"), {} } },
+					{ { tr("EVENTS"), {} }, { tr("THREADS"), {} } } );
+
+		printDescription( tr("Connects to the Veyon Server on all specified hosts (separated by commas) and sends "
+							  "the specified number of input events (default: %1) from the specified number of "
+							  "threads (default: %2) to each of them as fast as possible. Mostly pointer motions "
+							  "and occasional presses and releases of the Shift key are sent, so only use test "
+							  "computers. Afterwards the number of sent, coalesced and deferred events, the number "
+							  "of event allocations, the average and maximum time between queueing and "
+							  "sending an event as well as the number of writes to the TLS socket and the number "
+							  "of times it has been flushed (i.e. batches of TLS records written) are displayed.")
+						  .arg( DefaultInputEventCount ).arg( DefaultInputThreadCount ) );
+
+		printExamples( commandLineModuleName(), inputCommand(),
+					   {
+						   { tr( "Send 100000 events from 8 threads to a local Veyon Server" ),
+							   { QStringLiteral("localhost"), QStringLiteral("100000"), QStringLiteral("8") }
+						   }
+					   } );
+
+		return NoResult;
+	}
+
+	error( tr("The specified command does not exist or no help is available for it.") );
+
+	return NoResult;
+}
+
+
+
+CommandLinePluginInterface::RunResult ConnectionCommands::handle_statistics( const QStringList& arguments )
+{
+	if( arguments.isEmpty() )
+	{
+		return NotEnoughArguments;
+	}
+
+	const auto hosts = parseHosts( arguments[0] );
+
+	bool durationValid = true;
+	const auto duration = arguments.count() > 1 ? arguments[1].toInt( &durationValid ) : DefaultMeasurementDuration;
+	const auto mode = arguments.value( 2, monitoringMode() );
+
+	if( hosts.isEmpty() || durationValid == false || duration <= 0 ||
+		( mode != monitoringMode() && mode != liveMode() ) )
+	{
+		return InvalidArguments;
+	}
+
+	const auto updateMode = mode == liveMode() ? ComputerControlInterface::UpdateMode::Live
+											   : ComputerControlInterface::UpdateMode::Monitoring;
+
+	if( initializeCredentials() == false )
+	{
+		return Failed;
+	}
+
+	ComputerControlInterfaceList computerControlInterfaces;
+	computerControlInterfaces.reserve( hosts.count() );
+
+	for( const auto& host : hosts )
+	{
+		Computer computer;
+		computer.setHostAddress( host );
+
+		auto computerControlInterface = ComputerControlInterface::Pointer::create( computer );
+		computerControlInterface->start( {}, updateMode );
+		computerControlInterfaces.append( computerControlInterface );
+	}
+
+	info( tr("Measuring for %1 seconds...").arg( duration ) );
+
+	const auto initialResourceUsage = processResourceUsage();
+
+	QEventLoop eventLoop;
+	QTimer::singleShot( duration * 1000, &eventLoop, &QEventLoop::quit );
+	eventLoop.exec();
+
+	const auto resourceUsage = processResourceUsage();
+
+	const QLocale locale;
+	const auto formatTime = [&locale]( qint64 nanoseconds ) {
+		return tr( "%1 ms" ).arg( locale.toString( qreal( nanoseconds ) / ( 1000 * 1000 ), 'f', 1 ) );
+	};
+
+	TableHeader tableHeader( { tr("Host"), tr("Received"), tr("Sent"), tr("Receive rate"), tr("Updates/s"),
+							   tr("Throughput"), tr("Round trip time"), tr("Decode time"), tr("Quality"), tr("Encodings") } );
+	TableRows tableRows;
+	tableRows.reserve( computerControlInterfaces.count() );
+
+	for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+	{
+		const auto host = computerControlInterface->computer().hostAddress();
+
+		if( computerControlInterface->state() != ComputerControlInterface::State::Connected )
+		{
+			tableRows.append( { host, tr("not connected") } );
+			continue;
+		}
+
+		const auto statistics = computerControlInterface->transportStatistics();
+
+		QStringList encodings;
+		for( auto it = statistics.encodingBytes.constBegin(), end = statistics.encodingBytes.constEnd(); it != end; ++it )
+		{
+			encodings.append( QStringLiteral("%1: %2").arg( it.key(), locale.formattedDataSize( qint64(it.value()) ) ) );
+		}
+
+		// report averages over the whole measurement rather than the current rates
+		tableRows.append( {
+			host,
+			locale.formattedDataSize( qint64(statistics.bytesReceived) ),
+			locale.formattedDataSize( qint64(statistics.bytesSent) ),
+			tr( "%1/s" ).arg( locale.formattedDataSize( qint64(statistics.bytesReceived) / duration ) ),
+			locale.toString( qreal(statistics.framebufferUpdates) / duration, 'f', 1 ),
+			tr( "%1/s" ).arg( locale.formattedDataSize( statistics.throughput ) ),
+			formatTime( statistics.roundTripTime ),
+			formatTime( statistics.decodeTime ),
+			tr( "%1 (compression level %2)" )
+				.arg( QLatin1String( QMetaEnum::fromType<VncConnectionConfiguration::Quality>().valueToKey( int(statistics.quality) ) ) )
+				.arg( statistics.compressLevel ),
+			encodings.join( QStringLiteral(", ") )
+		} );
+	}
+
+	for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+	{
+		computerControlInterface->stop();
+	}
+
+	printTable( Table( tableHeader, tableRows ) );
+
+	const auto cursorShapeCacheStatistics = VncCursorShapeCache::instance()->statistics();
+	if( cursorShapeCacheStatistics.lookups > 0 )
+	{
+		info( tr( "Cursor shape cache: %1 of %2 lookups served from cache, %3 saved" )
+				  .arg( cursorShapeCacheStatistics.hits )
+				  .arg( cursorShapeCacheStatistics.lookups )
+				  .arg( locale.formattedDataSize( qint64(cursorShapeCacheStatistics.savedBytes) ) ) );
+	}
+
+	printSchedulerStatistics();
+
+	if( resourceUsage.threads >= 0 && resourceUsage.cpuTime >= 0 )
+	{
+		const auto reactor = VncConnectionReactor::instance();
+		info( tr( "Process: %1 threads (%2 shared I/O threads), %3 % CPU" )
+				  .arg( resourceUsage.threads )
+				  .arg( reactor ? reactor->threadCount() : 0 )
+				  .arg( locale.toString( qreal( resourceUsage.cpuTime - initialResourceUsage.cpuTime ) / ( duration * 10 ), 'f', 1 ) ) );
+	}
+
+	return NoResult;
+}
+
+
+
+CommandLinePluginInterface::RunResult ConnectionCommands::handle_reconnect( const QStringList& arguments )
+{
+	if( arguments.isEmpty() )
+	{
+		return NotEnoughArguments;
+	}
+
+	const auto hosts = parseHosts( arguments[0] );
+
+	bool roundsValid = true;
+	const auto rounds = arguments.count() > 1 ? arguments[1].toInt( &roundsValid ) : DefaultReconnectRounds;
+
+	if( hosts.isEmpty() || roundsValid == false || rounds <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	if( initializeCredentials() == false )
+	{
+		return Failed;
+	}
+
+	info( tr("Measuring full handshakes...") );
+	const auto fullHandshakes = measureHandshakes( hosts, rounds, false );
+
+	info( tr("Measuring fast reconnects...") );
+	const auto fastReconnects = measureHandshakes( hosts, rounds, true );
+
+	const QLocale locale;
+	const auto formatRow = [&locale]( const QString& mode, const HandshakeMeasurement& measurement ) -> QStringList {
+		const auto seconds = qreal(measurement.duration) / 1000;
+		return {
+			mode,
+			locale.toString( measurement.successful ),
+			locale.toString( measurement.failed ),
+			tr( "%1 s" ).arg( locale.toString( seconds, 'f', 2 ) ),
+			seconds > 0 ? locale.toString( measurement.successful / seconds, 'f', 1 ) : QString()
+		};
+	};
+
+	printTable( Table( { tr("Mode"), tr("Handshakes"), tr("Failed"), tr("Duration"), tr("Handshakes/s") },
+					   {
+						   formatRow( tr("Full handshake"), fullHandshakes ),
+						   formatRow( tr("Fast reconnect"), fastReconnects )
+					   } ) );
+
+	printSchedulerStatistics();
+
+	return NoResult;
+}
+
+
+
+CommandLinePluginInterface::RunResult ConnectionCommands::handle_input( const QStringList& arguments )
+{
+	if( arguments.isEmpty() )
+	{
+		return NotEnoughArguments;
+	}
+
+	const auto hosts = parseHosts( arguments[0] );
+
+	bool eventCountValid = true;
+	bool threadCountValid = true;
+	const auto eventCount = arguments.count() > 1 ? arguments[1].toInt( &eventCountValid ) : DefaultInputEventCount;
+	const auto threadCount = arguments.count() > 2 ? arguments[2].toInt( &threadCountValid ) : DefaultInputThreadCount;
+
+	if( hosts.isEmpty() || eventCountValid == false || threadCountValid == false || eventCount <= 0 || threadCount <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	if( initializeCredentials() == false )
+	{
+		return Failed;
+	}
+
+	ComputerControlInterfaceList computerControlInterfaces;
+	computerControlInterfaces.reserve( hosts.count() );
+
+	for( const auto& host : hosts )
+	{
+		Computer computer;
+		computer.setHostAddress( host );
+
+		auto computerControlInterface = ComputerControlInterface::Pointer::create( computer );
+		computerControlInterface->start( {}, ComputerControlInterface::UpdateMode::Live );
+		computerControlInterfaces.append( computerControlInterface );
+	}
+
+	const auto isConnected = []( const ComputerControlInterface::Pointer& computerControlInterface ) {
+		return computerControlInterface->state() == ComputerControlInterface::State::Connected;
+	};
+
+	waitFor( [&]() {
+		return std::all_of( computerControlInterfaces.cbegin(), computerControlInterfaces.cend(), isConnected );
+	}, ReconnectTimeout );
+
+	QList<VncConnection *> connections;
+	for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+	{
+		if( isConnected( computerControlInterface ) )
+		{
+			connections.append( computerControlInterface->vncConnection() );
+		}
+	}
+
+	info( tr("Sending %1 events from %2 threads to %3 hosts...").arg( eventCount ).arg( threadCount ).arg( connections.count() ) );
+
+	QThreadPool threadPool;
+	threadPool.setMaxThreadCount( threadCount );
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<QFuture<void>> producers;
+	for( int thread = 0; thread < threadCount; ++thread )
+	{
+		const auto threadEventCount = eventCount / threadCount + ( thread < eventCount % threadCount ? 1 : 0 );
+
+		producers.append( QtConcurrent::run( &threadPool, [=]() {
+			for( int i = 0; i < threadEventCount; ++i )
+			{
+				for( auto connection : connections )
+				{
+					if( i % InputKeyEventInterval == InputKeyEventInterval - 1 )
+					{
+						connection->keyEvent( InputKey, ( i / InputKeyEventInterval ) % 2 == 0 );
+					}
+					else
+					{
+						connection->mouseEvent( i % 1024, thread * 16, 0 );
+					}
+				}
+			}
+		} ) );
+	}
+
+	for( auto& producer : producers )
+	{
+		producer.waitForFinished();
+	}
+
+	waitFor( [&]() {
+		return std::all_of( connections.cbegin(), connections.cend(), []( const VncConnection* connection ) {
+			return connection->isEventQueueEmpty();
+		} );
+	}, ReconnectTimeout );
+
+	const auto elapsed = timer.elapsed();
+
+	const QLocale locale;
+	const auto formatTime = [&locale]( quint64 nanoseconds ) {
+		return tr( "%1 ms" ).arg( locale.toString( qreal( nanoseconds ) / ( 1000 * 1000 ), 'f', 2 ) );
+	};
+
+	TableRows tableRows;
+	tableRows.reserve( computerControlInterfaces.count() );
+
+	for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+	{
+		const auto host = computerControlInterface->computer().hostAddress();
+
+		if( isConnected( computerControlInterface ) == false )
+		{
+			tableRows.append( { host, tr("not connected") } );
+			continue;
+		}
+
+		const auto transportStatistics = computerControlInterface->transportStatistics();
+		const auto& statistics = transportStatistics.eventQueue;
+
+		tableRows.append( {
+			host,
+			locale.toString( statistics.enqueuedEvents ),
+			locale.toString( statistics.sentEvents ),
+			locale.toString( statistics.coalescedEvents ),
+			locale.toString( statistics.overflowedEvents ),
+			locale.toString( statistics.allocatedEvents ),
+			formatTime( statistics.averageLatency ),
+			formatTime( statistics.maximumLatency ),
+			locale.toString( transportStatistics.socketWrites ),
+			locale.toString( transportStatistics.socketFlushes ),
+			locale.toString( qreal( transportStatistics.socketFlushes ) * 1000 / qMax<qint64>( 1, elapsed ), 'f', 0 )
+		} );
+	}
+
+	for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+	{
+		computerControlInterface->stop();
+	}
+
+	printTable( Table( { tr("Host"), tr("Queued"), tr("Sent"), tr("Coalesced"), tr("Deferred"),
+						 tr("Allocations"), tr("Average latency"), tr("Maximum latency"),
+						 tr("Socket writes"), tr("TLS flushes"), tr("Flushes/s") }, tableRows ) );
+
+	info( tr( "Queued %1 events per second" ).arg(
+			  locale.toString( qreal( eventCount ) * connections.count() * 1000 / qMax<qint64>( 1, elapsed ), 'f', 0 ) ) );
+
+	return NoResult;
+}
+
+
+
+QStringList ConnectionCommands::parseHosts( const QString& hostList )
+{
+	QStringList hosts;
+	for( const auto& host : hostList.split( QLatin1Char(',') ) )
+	{
+		if( host.trimmed().isEmpty() == false )
+		{
+			hosts.append( host.trimmed() );
+		}
+	}
+
+	return hosts;
+}
+
+
+
+ConnectionCommands::ProcessResourceUsage ConnectionCommands::processResourceUsage()
+{
+	ProcessResourceUsage usage;
+
+#ifdef Q_OS_LINUX
+	QFile status( QStringLiteral("/proc/self/status") );
+	if( status.open( QFile::ReadOnly ) )
+	{
+		const auto threadsKey = QByteArrayLiteral("Threads:");
+		for( const auto& line : status.readAll().split( '\n' ) )
+		{
+			if( line.startsWith( threadsKey ) )
+			{
+				usage.threads = line.mid( threadsKey.size() ).trimmed().toInt();
+				break;
+			}
+		}
+	}
+
+	rusage resourceUsage{};
+	if( getrusage( RUSAGE_SELF, &resourceUsage ) == 0 )
+	{
+		usage.cpuTime = ( qint64(resourceUsage.ru_utime.tv_sec) + resourceUsage.ru_stime.tv_sec ) * 1000 +
+						( resourceUsage.ru_utime.tv_usec + resourceUsage.ru_stime.tv_usec ) / 1000;
+	}
+#endif
+
+	return usage;
+}
+
+
+
+bool ConnectionCommands::initializeCredentials()
+{
+	if( VeyonCore::authenticationManager().initializeCredentials() == false ||
+		VeyonCore::authenticationManager().initializedPlugin()->checkCredentials() == false )
+	{
+		error( tr("Failed to initialize credentials") );
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void ConnectionCommands::printSchedulerStatistics()
+{
+	const auto statistics = VncConnectionScheduler::instance()->statistics();
+
+	info( tr( "Connection scheduler: %1 handshakes waited %2 ms on average (maximum: %3 ms), "
+			  "%4 of %5 connection attempts failed, %6 hosts currently backed off" )
+			  .arg( statistics.handshakes )
+			  .arg( statistics.averageQueueTime )
+			  .arg( statistics.maximumQueueTime )
+			  .arg( statistics.failures )
+			  .arg( statistics.successes + statistics.failures )
+			  .arg( statistics.backedOffHosts ) );
+}
+
+
+
+void ConnectionCommands::waitFor( const std::function<bool()>& condition, int timeout )
+{
+	QElapsedTimer timeoutTimer;
+	timeoutTimer.start();
+
+	QEventLoop eventLoop;
+	QTimer pollTimer;
+	QObject::connect( &pollTimer, &QTimer::timeout, &eventLoop, [&]() {
+		if( condition() || timeoutTimer.hasExpired( timeout ) )
+		{
+			eventLoop.quit();
+		}
+	} );
+	pollTimer.start( ReconnectStatePollInterval );
+	eventLoop.exec();
+}
+
+
+
+ConnectionCommands::HandshakeMeasurement ConnectionCommands::measureHandshakes( const QStringList& hosts, int rounds,
+																				 bool fastReconnect )
+{
+	const auto isFinished = []( const ComputerControlInterface::Pointer& computerControlInterface ) {
+		switch( computerControlInterface->state() )
+		{
+		case ComputerControlInterface::State::Connected:
+		case ComputerControlInterface::State::HostOffline:
+		case ComputerControlInterface::State::HostNameResolutionFailed:
+		case ComputerControlInterface::State::ServerNotRunning:
+		case ComputerControlInterface::State::AuthenticationFailed:
+			return true;
+		default:
+			break;
+		}
+		return false;
+	};
+
+	VeyonCore::authenticationManager().clearAuthenticationTickets();
+
+	HandshakeMeasurement measurement;
+
+	// servers do not issue tickets to connections authenticated by a ticket, therefore every measured
+	// round with fast reconnects is preceded by a round obtaining authentication tickets
+	const auto totalRounds = fastReconnect ? rounds * 2 : rounds;
+
+	for( int roundIndex = 0; roundIndex < totalRounds; ++roundIndex )
+	{
+		const auto measured = fastReconnect == false || roundIndex % 2 == 1;
+
+		if( fastReconnect == false )
+		{
+			VeyonCore::authenticationManager().clearAuthenticationTickets();
+		}
+
+		ComputerControlInterfaceList computerControlInterfaces;
+		computerControlInterfaces.reserve( hosts.count() );
+
+		QElapsedTimer roundTimer;
+		roundTimer.start();
+
+		for( const auto& host : hosts )
+		{
+			Computer computer;
+			computer.setHostAddress( host );
+
+			auto computerControlInterface = ComputerControlInterface::Pointer::create( computer );
+			computerControlInterface->start();
+			computerControlInterfaces.append( computerControlInterface );
+		}
+
+		waitFor( [&]() {
+			return std::all_of( computerControlInterfaces.cbegin(), computerControlInterfaces.cend(), isFinished );
+		}, ReconnectTimeout );
+
+		const auto roundDuration = roundTimer.elapsed();
+
+		if( measured )
+		{
+			measurement.duration += roundDuration;
+			for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+			{
+				if( computerControlInterface->state() == ComputerControlInterface::State::Connected )
+				{
+					++measurement.successful;
+				}
+				else
+				{
+					++measurement.failed;
+				}
+			}
+		}
+
+		if( measured == false )
+		{
+			// wait for the tickets for the next round which are requested after connecting
+			waitFor( [&]() {
+				return std::all_of( computerControlInterfaces.cbegin(), computerControlInterfaces.cend(),
+									[]( const ComputerControlInterface::Pointer& computerControlInterface ) {
+					return computerControlInterface->state() != ComputerControlInterface::State::Connected ||
+						   VeyonCore::authenticationManager().hasAuthenticationTicket(
+							   computerControlInterface->vncConnection()->serverAddress() );
+				} );
+			}, ReconnectTimeout );
+		}
+
+		for( const auto& computerControlInterface : std::as_const(computerControlInterfaces) )
+		{
+			computerControlInterface->stop();
+		}
+	}
+
+	return measurement;
+}
@@ -0,0 +1,151 @@
+/*
+ * ConnectionCommands.h - declaration of ConnectionCommands class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "CommandLinePluginInterface.h"
+#include "CommandLineIO.h"
+
+class ConnectionCommands : public QObject, CommandLinePluginInterface, PluginInterface, CommandLineIO
+{
+	Q_OBJECT
+	Q_INTERFACES(PluginInterface CommandLinePluginInterface)
+public:
+	explicit ConnectionCommands( QObject* parent = nullptr );
+	~ConnectionCommands() override = default;
+
+	Plugin::Uid uid() const override
+	{
+		return Plugin::Uid{ QStringLiteral("f1bca5c0-c063-4526-a71a-5ee6a1cbbf26") };
+	}
+
+	QVersionNumber version() const override
+	{
+		return QVersionNumber( 1, 0 );
+	}
+
+	QString name() const override
+	{
+		return QStringLiteral( "ConnectionCommands" );
+	}
+
+	QString description() const override
+	{
+		return tr( "Connection-related CLI operations" );
+	}
+
+	QString vendor() const override
+	{
+		return QStringLiteral( "Veyon Community" );
+	}
+
+	QString copyright() const override
+	{
+		return QStringLiteral( "Tobias Junghans" );
+	}
+
+	QString commandLineModuleName() const override
+	{
+		return QStringLiteral( "connection" );
+	}
+
+	QString commandLineModuleHelp() const override
+	{
+		return tr( "Commands for analyzing connections to remote computers" );
+	}
+
+	QStringList commands() const override;
+	QString commandHelp( const QString& command ) const override;
+
+public Q_SLOTS:
+	CommandLinePluginInterface::RunResult handle_help( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_statistics( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_reconnect( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_input( const QStringList& arguments );
+
+private:
+	struct ProcessResourceUsage
+	{
+		int threads{-1};
+		qint64 cpuTime{-1}; // milliseconds
+	};
+
+	struct HandshakeMeasurement
+	{
+		int successful{0};
+		int failed{0};
+		qint64 duration{0};
+	};
+
+	static QString statisticsCommand()
+	{
+		return QStringLiteral("statistics");
+	}
+
+	static QString monitoringMode()
+	{
+		return QStringLiteral("monitoring");
+	}
+
+	static QString liveMode()
+	{
+		return QStringLiteral("live");
+	}
+
+	static QString reconnectCommand()
+	{
+		return QStringLiteral("reconnect");
+	}
+
+	static QString inputCommand()
+	{
+		return QStringLiteral("input");
+	}
+
+	static QStringList parseHosts( const QString& hostList );
+	static ProcessResourceUsage processResourceUsage();
+	bool initializeCredentials();
+	void printSchedulerStatistics();
+
+	// processes events until the condition is met or the timeout expired
+	static void waitFor( const std::function<bool()>& condition, int timeout );
+
+	// connects to all hosts simultaneously for the given number of rounds
+	static HandshakeMeasurement measureHandshakes( const QStringList& hosts, int rounds, bool fastReconnect );
+
+	static constexpr auto DefaultMeasurementDuration = 10;
+	static constexpr auto DefaultReconnectRounds = 10;
+	static constexpr auto ReconnectTimeout = 30000;
+	static constexpr auto ReconnectStatePollInterval = 10;
+	static constexpr auto DefaultInputEventCount = 10000;
+	static constexpr auto DefaultInputThreadCount = 4;
+	// send a key event after this number of pointer events
+	static constexpr auto InputKeyEventInterval = 16;
+	static constexpr uint InputKey = 0xffe1; // XK_Shift_L
+
+	const QMap<QString, QString> m_commands;
+
+};
@@ -27,6 +27,7 @@
 #include <openssl/crypto.h>
 
 #include "ConfigCommands.h"
+#include "ConnectionCommands.h"
 #include "FeatureCommands.h"
 #include "Logger.h"
 #include "PluginCommands.h"
@@ -86,6 +87,7 @@ int main( int argc, char **argv )
 
 	auto core = new VeyonCore( app, VeyonCore::Component::CLI, QStringLiteral("CLI") );
 	VeyonCore::pluginManager().registerExtraPluginInterface( new ConfigCommands( core ) );
+	VeyonCore::pluginManager().registerExtraPluginInterface( new ConnectionCommands( core ) );
 	VeyonCore::pluginManager().registerExtraPluginInterface( new FeatureCommands( core ) );
 	VeyonCore::pluginManager().registerExtraPluginInterface( new PluginCommands( core ) );
 	VeyonCore::pluginManager().registerExtraPluginInterface( new ServiceControlCommands( core ) );
@@ -38,18 +38,22 @@
 
 
 AccessControlProvider::AccessControlProvider() :
-	m_accessControlRules(),
+	AccessControlProvider(VeyonCore::config().accessControlRules())
+{
+}
+
+
+
+AccessControlProvider::AccessControlProvider( const QJsonArray& accessControlRules ) :
 	m_userGroupsBackend(VeyonCore::userGroupsBackendManager().configuredBackend()),
 	m_networkObjectDirectory(VeyonCore::networkObjectDirectoryManager().configuredDirectory()),
 	m_useDomainUserGroups(VeyonCore::config().useDomainUserGroups())
 {
-	const QJsonArray accessControlRules = VeyonCore::config().accessControlRules();
-
-	m_accessControlRules.reserve( accessControlRules.size() );
+	m_compiledRules.reserve( accessControlRules.size() );
 
 	for (const auto& accessControlRule : accessControlRules)
 	{
-		m_accessControlRules.append(AccessControlRule::Pointer::create(accessControlRule));
+		m_compiledRules.append(compileRule(AccessControlRule::Pointer::create(accessControlRule)));
 	}
 }
 
@@ -200,8 +204,12 @@ AccessControlRule::Pointer AccessControlProvider::processAccessControlRules(cons
 {
 	vDebug() << "processing rules for" << accessingUser << accessingComputer << localUser << localComputer << connectedUsers << authMethodUid;
 
-	for (const auto& rule : std::as_const(m_accessControlRules))
+	Decision decision{accessingUser, accessingComputer, localUser, localComputer, connectedUsers, authMethodUid};
+
+	for (const auto& compiledRule : std::as_const(m_compiledRules))
 	{
+		const auto& rule = compiledRule.rule;
+
 		// rule disabled?
 		if (rule->action() == AccessControlRule::Action::None)
 		{
@@ -209,8 +217,7 @@ AccessControlRule::Pointer AccessControlProvider::processAccessControlRules(cons
 			continue;
 		}
 
-		if (rule->areConditionsIgnored() ||
-			matchConditions(*rule, accessingUser, accessingComputer, localUser, localComputer, connectedUsers, authMethodUid))
+		if (rule->areConditionsIgnored() || matchConditions(compiledRule, decision))
 		{
 			vDebug() << "rule" << rule->name() << "matched with action" << rule->action();
 			return rule;
@@ -233,12 +240,19 @@ bool AccessControlProvider::isAccessToLocalComputerDenied() const
 		return false;
 	}
 
-	for (const auto& rule : std::as_const(m_accessControlRules))
+	const QString noAccessingUser;
+	const QString noAccessingComputer;
+	const auto localUser = VeyonCore::platform().userFunctions().currentUser();
+	const auto localComputer = HostAddress::localFQDN();
+	const QStringList noConnectedUsers;
+
+	Decision decision{noAccessingUser, noAccessingComputer, localUser, localComputer, noConnectedUsers, {}};
+
+	for (const auto& compiledRule : std::as_const(m_compiledRules))
 	{
-		if (matchConditions(*rule, {}, {},
-							VeyonCore::platform().userFunctions().currentUser(), HostAddress::localFQDN(), {}, {}))
+		if (matchConditions(compiledRule, decision))
 		{
-			switch (rule->action())
+			switch (compiledRule.rule->action())
 			{
 			case AccessControlRule::Action::Deny:
 				return true;
@@ -256,89 +270,159 @@ bool AccessControlProvider::isAccessToLocalComputerDenied() const
 
 
 
-bool AccessControlProvider::isMemberOfUserGroup( const QString &user,
-												 const QString &groupName ) const
+/*!
+ * \brief Returns whether any rule refers to the given condition (optionally only with the given subject) so that callers know which inputs can influence decisions at all
+ */
+bool AccessControlProvider::isConditionUsed( AccessControlRule::Condition condition, AccessControlRule::Subject subject ) const
 {
-	return matchList(m_userGroupsBackend->groupsOfUser(user, m_useDomainUserGroups), groupName);
-}
-
+	for (const auto& compiledRule : std::as_const(m_compiledRules))
+	{
+		if (compiledRule.rule->areConditionsIgnored())
+		{
+			continue;
+		}
 
+		for (const auto& compiledCondition : compiledRule.conditions)
+		{
+			if (compiledCondition.condition == condition &&
+				(subject == AccessControlRule::Subject::None || compiledCondition.subject == subject))
+			{
+				return true;
+			}
+		}
+	}
 
-bool AccessControlProvider::isLocatedAt( const QString &computer, const QString &locationName ) const
-{
-	return matchList(locationsOfComputer(computer), locationName);
+	return false;
 }
 
 
 
-bool AccessControlProvider::haveGroupsInCommon( const QString &userOne, const QString &userTwo ) const
+AccessControlProvider::CompiledRule AccessControlProvider::compileRule( const AccessControlRule::Pointer& rule )
 {
-	const auto userOneGroups = m_userGroupsBackend->groupsOfUser( userOne, m_useDomainUserGroups );
-	const auto userTwoGroups = m_userGroupsBackend->groupsOfUser( userTwo, m_useDomainUserGroups );
-
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-	const auto userOneGroupSet = QSet<QString>{ userOneGroups.begin(), userOneGroups.end() };
-	const auto userTwoGroupSet = QSet<QString>{ userTwoGroups.begin(), userTwoGroups.end() };
-#else
-	const auto userOneGroupSet = userOneGroups.toSet();
-	const auto userTwoGroupSet = userTwoGroups.toSet();
-#endif
+	using Condition = AccessControlRule::Condition;
+	using Subject = AccessControlRule::Subject;
+
+	// conditions which do not require any lookups come first, followed by
+	// conditions querying the platform and finally the ones querying the
+	// user groups backend and the network object directory
+	static const std::initializer_list<Condition> conditionsByCost{
+		Condition::AuthenticationMethod,
+		Condition::AccessFromSameUser,
+		Condition::AccessFromAlreadyConnectedUser,
+		Condition::ComputerAlreadyBeingAccessed,
+		Condition::UserSession,
+		Condition::AccessedUserLoggedInLocally,
+		Condition::NoUserLoggedInLocally,
+		Condition::NoUserLoggedInRemotely,
+		Condition::AccessFromLocalHost,
+		Condition::MemberOfGroup,
+		Condition::GroupsInCommon,
+		Condition::LocatedAt,
+		Condition::LocationsInCommon,
+	};
+
+	CompiledRule compiledRule{rule, {}};
+
+	for (const auto condition : conditionsByCost)
+	{
+		if (rule->isConditionEnabled(condition) == false)
+		{
+			continue;
+		}
 
-	return userOneGroupSet.intersects( userTwoGroupSet );
-}
+		CompiledCondition compiledCondition;
+		compiledCondition.condition = condition;
+		compiledCondition.inverted = rule->isConditionInverted(condition);
 
+		const auto subject = rule->subject(condition);
 
+		switch (condition)
+		{
+		case Condition::AuthenticationMethod:
+			compiledCondition.authMethodUid = Plugin::Uid(rule->argument(condition));
+			break;
+		case Condition::MemberOfGroup:
+			if (subject == Subject::AccessingUser || subject == Subject::LocalUser)
+			{
+				compiledCondition.subject = subject;
+			}
+			compiledCondition.argument = compilePattern(rule->argument(condition));
+			break;
+		case Condition::LocatedAt:
+			if (subject == Subject::AccessingComputer || subject == Subject::LocalComputer)
+			{
+				compiledCondition.subject = subject;
+			}
+			compiledCondition.argument = compilePattern(rule->argument(condition));
+			break;
+		default:
+			break;
+		}
 
-bool AccessControlProvider::haveSameLocations( const QString &computerOne, const QString &computerTwo ) const
-{
-	const auto computerOneLocations = locationsOfComputer( computerOne );
-	const auto computerTwoLocations = locationsOfComputer( computerTwo );
+		compiledRule.conditions.append(compiledCondition);
+	}
 
-	return computerOneLocations.isEmpty() == false &&
-			computerOneLocations == computerTwoLocations;
+	return compiledRule;
 }
 
 
 
-bool AccessControlProvider::isLocalHost( const QString &accessingComputer ) const
+AccessControlProvider::Pattern AccessControlProvider::compilePattern( const QString& pattern )
 {
-	return HostAddress( accessingComputer ).isLocalHost();
-}
-
+	if (pattern.startsWith(QLatin1Char('/')) && pattern.endsWith(QLatin1Char('/')) &&
+		pattern.length() > 2)
+	{
+		return {pattern, QRegularExpression(pattern.mid(1, pattern.length() - 2)), true};
+	}
 
+	if (pattern.endsWith(QLatin1Char('*')))
+	{
+		const QRegularExpression rx(pattern);
+		if (rx.isValid())
+		{
+			return {pattern, rx, true};
+		}
+	}
 
-bool AccessControlProvider::isLocalUser( const QString &accessingUser, const QString &localUser ) const
-{
-	return accessingUser.isEmpty() == false &&
-			accessingUser == localUser;
+	return {pattern, {}, false};
 }
 
 
 
-bool AccessControlProvider::isNoUserLoggedInLocally() const
+QStringList AccessControlProvider::lookupGroupsOfUser( Decision& decision, const QString& user ) const
 {
-	return VeyonCore::platform().userFunctions().isAnyUserLoggedInLocally() == false;
+	auto it = decision.groupsOfUser.constFind(user);
+	if (it == decision.groupsOfUser.constEnd())
+	{
+		it = decision.groupsOfUser.insert(user, m_userGroupsBackend->groupsOfUser(user, m_useDomainUserGroups));
+	}
+
+	return *it;
 }
 
 
 
-bool AccessControlProvider::isNoUserLoggedInRemotely() const
+QStringList AccessControlProvider::lookupLocationsOfComputer( Decision& decision, const QString& computer ) const
 {
-	return VeyonCore::platform().userFunctions().isAnyUserLoggedInRemotely() == false;
+	auto it = decision.locationsOfComputer.constFind(computer);
+	if (it == decision.locationsOfComputer.constEnd())
+	{
+		it = decision.locationsOfComputer.insert(computer, locationsOfComputer(computer));
+	}
+
+	return *it;
 }
 
 
 
-QString AccessControlProvider::lookupSubject( AccessControlRule::Subject subject,
-											  const QString &accessingUser, const QString &accessingComputer,
-											  const QString &localUser, const QString &localComputer ) const
+QString AccessControlProvider::lookupSubject( AccessControlRule::Subject subject, const Decision& decision )
 {
 	switch( subject )
 	{
-	case AccessControlRule::Subject::AccessingUser: return accessingUser;
-	case AccessControlRule::Subject::AccessingComputer: return accessingComputer;
-	case AccessControlRule::Subject::LocalUser: return localUser;
-	case AccessControlRule::Subject::LocalComputer: return localComputer;
+	case AccessControlRule::Subject::AccessingUser: return decision.accessingUser;
+	case AccessControlRule::Subject::AccessingComputer: return decision.accessingComputer;
+	case AccessControlRule::Subject::LocalUser: return decision.localUser;
+	case AccessControlRule::Subject::LocalComputer: return decision.localComputer;
 	default: break;
 	}
 
@@ -347,166 +431,137 @@ QString AccessControlProvider::lookupSubject( AccessControlRule::Subject subject
 
 
 
-bool AccessControlProvider::matchConditions( const AccessControlRule &rule,
-											 const QString& accessingUser, const QString& accessingComputer,
-											 const QString& localUser, const QString& localComputer,
-											 const QStringList& connectedUsers, Plugin::Uid authMethodUid ) const
+bool AccessControlProvider::matchConditions( const CompiledRule& compiledRule, Decision& decision ) const
 {
-	vDebug() << rule.toJson();
-
-	AccessControlRule::Condition condition{AccessControlRule::Condition::None};
-
-	if( rule.isConditionEnabled( AccessControlRule::Condition::AuthenticationMethod ) )
+	// do not match the rule if no conditions are set at all
+	if (compiledRule.conditions.isEmpty())
 	{
-		condition = AccessControlRule::Condition::AuthenticationMethod;
+		return false;
+	}
 
-		const auto allowedAuthMethod = Plugin::Uid( rule.argument( AccessControlRule::Condition::AuthenticationMethod ) );
-		if( authMethodUid.isNull() ||
-			allowedAuthMethod.isNull() ||
-			( authMethodUid == allowedAuthMethod ) == rule.isConditionInverted(condition) )
+	for (const auto& condition : compiledRule.conditions)
+	{
+		if (matchCondition(condition, decision) == false)
 		{
 			return false;
 		}
 	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::MemberOfGroup ) )
-	{
-		condition = AccessControlRule::Condition::MemberOfGroup;
+	return true;
+}
 
-		const auto condition = AccessControlRule::Condition::MemberOfGroup;
-		const auto user = lookupSubject( rule.subject( condition ), accessingUser, {}, localUser, {} );
-		const auto group = rule.argument( condition );
 
-		if( user.isEmpty() || group.isEmpty() ||
-			isMemberOfUserGroup( user, group ) == rule.isConditionInverted(condition) )
-		{
-			return false;
-		}
-	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::GroupsInCommon ) )
+bool AccessControlProvider::matchCondition( const CompiledCondition& condition, Decision& decision ) const
+{
+	const auto inverted = condition.inverted;
+
+	switch (condition.condition)
 	{
-		condition = AccessControlRule::Condition::GroupsInCommon;
+	case AccessControlRule::Condition::AuthenticationMethod:
+		return decision.authMethodUid.isNull() == false &&
+			   condition.authMethodUid.isNull() == false &&
+			   (decision.authMethodUid == condition.authMethodUid) != inverted;
 
-		if( accessingUser.isEmpty() || localUser.isEmpty() ||
-			haveGroupsInCommon( accessingUser, localUser ) == rule.isConditionInverted(condition) )
-		{
-			return false;
-		}
+	case AccessControlRule::Condition::MemberOfGroup:
+	{
+		const auto user = lookupSubject(condition.subject, decision);
+		return user.isEmpty() == false && condition.argument.text.isEmpty() == false &&
+			   matchList(lookupGroupsOfUser(decision, user), condition.argument) != inverted;
 	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::LocatedAt ) )
+	case AccessControlRule::Condition::GroupsInCommon:
 	{
-		condition = AccessControlRule::Condition::LocatedAt;
-
-		const auto computer = lookupSubject( rule.subject( condition ), {}, accessingComputer, {}, localComputer );
-		const auto location = rule.argument( condition );
-
-		if( computer.isEmpty() || location.isEmpty() ||
-			isLocatedAt( computer, location ) == rule.isConditionInverted(condition) )
+		if (decision.accessingUser.isEmpty() || decision.localUser.isEmpty())
 		{
 			return false;
 		}
-	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::LocationsInCommon ) )
-	{
-		condition = AccessControlRule::Condition::LocationsInCommon;
+		const auto accessingUserGroups = lookupGroupsOfUser(decision, decision.accessingUser);
+		const auto localUserGroups = lookupGroupsOfUser(decision, decision.localUser);
 
-		if( accessingComputer.isEmpty() || localComputer.isEmpty() ||
-			haveSameLocations( accessingComputer, localComputer ) == rule.isConditionInverted(condition) )
-		{
-			return false;
-		}
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+		const auto accessingUserGroupSet = QSet<QString>{ accessingUserGroups.begin(), accessingUserGroups.end() };
+		const auto localUserGroupSet = QSet<QString>{ localUserGroups.begin(), localUserGroups.end() };
+#else
+		const auto accessingUserGroupSet = accessingUserGroups.toSet();
+		const auto localUserGroupSet = localUserGroups.toSet();
+#endif
+
+		return accessingUserGroupSet.intersects(localUserGroupSet) != inverted;
 	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::AccessFromLocalHost ) )
+	case AccessControlRule::Condition::LocatedAt:
 	{
-		condition = AccessControlRule::Condition::AccessFromLocalHost;
-
-		if( isLocalHost( accessingComputer ) == rule.isConditionInverted(condition) )
-		{
-			return false;
-		}
+		const auto computer = lookupSubject(condition.subject, decision);
+		return computer.isEmpty() == false && condition.argument.text.isEmpty() == false &&
+			   matchList(lookupLocationsOfComputer(decision, computer), condition.argument) != inverted;
 	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::AccessFromSameUser ) )
+	case AccessControlRule::Condition::LocationsInCommon:
 	{
-		condition = AccessControlRule::Condition::AccessFromSameUser;
-
-		if( isLocalUser( accessingUser, localUser ) == rule.isConditionInverted(condition) )
+		if (decision.accessingComputer.isEmpty() || decision.localComputer.isEmpty())
 		{
 			return false;
 		}
-	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::AccessFromAlreadyConnectedUser ) )
-	{
-		condition = AccessControlRule::Condition::AccessFromAlreadyConnectedUser;
+		const auto accessingComputerLocations = lookupLocationsOfComputer(decision, decision.accessingComputer);
+		const auto localComputerLocations = lookupLocationsOfComputer(decision, decision.localComputer);
 
-		if( connectedUsers.contains( accessingUser ) == rule.isConditionInverted(condition) )
-		{
-			return false;
-		}
+		return (accessingComputerLocations.isEmpty() == false &&
+				accessingComputerLocations == localComputerLocations) != inverted;
 	}
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::AccessedUserLoggedInLocally ) )
-	{
-		condition = AccessControlRule::Condition::AccessedUserLoggedInLocally;
-
-		if( VeyonCore::platform().sessionFunctions().currentSessionIsRemote() == rule.isConditionInverted(condition) )
+	case AccessControlRule::Condition::AccessFromLocalHost:
+		if (decision.isAccessFromLocalHost.has_value() == false)
 		{
-			return false;
+			decision.isAccessFromLocalHost = HostAddress(decision.accessingComputer).isLocalHost();
 		}
-	}
+		return *decision.isAccessFromLocalHost != inverted;
 
-	if( rule.isConditionEnabled( AccessControlRule::Condition::NoUserLoggedInLocally ) )
-	{
-		condition = AccessControlRule::Condition::NoUserLoggedInLocally;
+	case AccessControlRule::Condition::AccessFromSameUser:
+		return (decision.accessingUser.isEmpty() == false &&
+				decision.accessingUser == decision.localUser) != inverted;
 
-		if( isNoUserLoggedInLocally() == rule.isConditionInverted(condition) )
+	case AccessControlRule::Condition::AccessFromAlreadyConnectedUser:
+		return decision.connectedUsers.contains(decision.accessingUser) != inverted;
+
+	case AccessControlRule::Condition::AccessedUserLoggedInLocally:
+		if (decision.isCurrentSessionRemote.has_value() == false)
 		{
-			return false;
+			decision.isCurrentSessionRemote = VeyonCore::platform().sessionFunctions().currentSessionIsRemote();
 		}
-	}
-
-	if( rule.isConditionEnabled( AccessControlRule::Condition::NoUserLoggedInRemotely ) )
-	{
-		condition = AccessControlRule::Condition::NoUserLoggedInRemotely;
+		return *decision.isCurrentSessionRemote != inverted;
 
-		if( isNoUserLoggedInRemotely() == rule.isConditionInverted(condition) )
+	case AccessControlRule::Condition::NoUserLoggedInLocally:
+		if (decision.isAnyUserLoggedInLocally.has_value() == false)
 		{
-			return false;
+			decision.isAnyUserLoggedInLocally = VeyonCore::platform().userFunctions().isAnyUserLoggedInLocally();
 		}
-	}
-
-	if( rule.isConditionEnabled( AccessControlRule::Condition::UserSession ) )
-	{
-		condition = AccessControlRule::Condition::UserSession;
+		return *decision.isAnyUserLoggedInLocally == inverted;
 
-		if( VeyonCore::platform().sessionFunctions().currentSessionHasUser() == rule.isConditionInverted(condition) )
+	case AccessControlRule::Condition::NoUserLoggedInRemotely:
+		if (decision.isAnyUserLoggedInRemotely.has_value() == false)
 		{
-			return false;
+			decision.isAnyUserLoggedInRemotely = VeyonCore::platform().userFunctions().isAnyUserLoggedInRemotely();
 		}
-	}
-
-	if (rule.isConditionEnabled(AccessControlRule::Condition::ComputerAlreadyBeingAccessed))
-	{
-		condition = AccessControlRule::Condition::ComputerAlreadyBeingAccessed;
+		return *decision.isAnyUserLoggedInRemotely == inverted;
 
-		if (!connectedUsers.isEmpty() == rule.isConditionInverted(condition))
+	case AccessControlRule::Condition::UserSession:
+		if (decision.hasCurrentSessionUser.has_value() == false)
 		{
-			return false;
+			decision.hasCurrentSessionUser = VeyonCore::platform().sessionFunctions().currentSessionHasUser();
 		}
-	}
+		return *decision.hasCurrentSessionUser != inverted;
 
-	// do not match the rule if no conditions are set at all
-	if( condition == AccessControlRule::Condition::None )
-	{
-		return false;
+	case AccessControlRule::Condition::ComputerAlreadyBeingAccessed:
+		return decision.connectedUsers.isEmpty() == inverted;
+
+	default:
+		break;
 	}
 
-	return true;
+	return false;
 }
 
 
@@ -526,22 +581,12 @@ QStringList AccessControlProvider::objectNames( const NetworkObjectList& objects
 
 
 
-bool AccessControlProvider::matchList(const QStringList& list, const QString& pattern)
+bool AccessControlProvider::matchList( const QStringList& list, const Pattern& pattern )
 {
-	if (pattern.startsWith(QLatin1Char('/')) && pattern.endsWith(QLatin1Char('/')) &&
-		pattern.length() > 2)
+	if (pattern.isRegExp)
 	{
-		return list.indexOf(QRegularExpression(pattern.mid(1, pattern.length() - 2))) >= 0;
-	}
-
-	if (pattern.endsWith(QLatin1Char('*')))
-	{
-		const QRegularExpression rx(pattern);
-		if (rx.isValid())
-		{
-			return list.indexOf(rx) >= 0;
-		}
+		return list.indexOf(pattern.regExp) >= 0;
 	}
 
-	return list.contains(pattern);
+	return list.contains(pattern.text);
 }
@@ -24,6 +24,11 @@
 
 #pragma once
 
+#include <QJsonArray>
+#include <QRegularExpression>
+
+#include <optional>
+
 #include "AccessControlRule.h"
 #include "NetworkObject.h"
 #include "Plugin.h"
@@ -46,6 +51,7 @@ public:
 	};
 
 	AccessControlProvider();
+	explicit AccessControlProvider( const QJsonArray& accessControlRules );
 
 	QStringList userGroups() const;
 	QStringList locations() const;
@@ -65,35 +71,74 @@ public:
 
 	bool isAccessToLocalComputerDenied() const;
 
+	bool isConditionUsed( AccessControlRule::Condition condition,
+						  AccessControlRule::Subject subject = AccessControlRule::Subject::None ) const;
+
 	static QByteArray accessControlMessageScheme()
 	{
 		return QByteArrayLiteral("vacm://");
 	}
 
 private:
-	bool isMemberOfUserGroup( const QString& user, const QString& groupName ) const;
-	bool isLocatedAt( const QString& computer, const QString& locationName ) const;
-	bool haveGroupsInCommon( const QString& userOne, const QString& userTwo ) const;
-	bool haveSameLocations( const QString& computerOne, const QString& computerTwo ) const;
-	bool isLocalHost( const QString& accessingComputer ) const;
-	bool isLocalUser( const QString& accessingUser, const QString& localUser ) const;
-	bool isNoUserLoggedInLocally() const;
-	bool isNoUserLoggedInRemotely() const;
-
-	QString lookupSubject( AccessControlRule::Subject subject,
-						   const QString& accessingUser, const QString& accessingComputer,
-						   const QString& localUser, const QString& localComputer ) const;
-
-	bool matchConditions( const AccessControlRule& rule,
-						  const QString& accessingUser, const QString& accessingComputer,
-						  const QString& localUser, const QString& localComputer,
-						  const QStringList& connectedUsers,
-						  Plugin::Uid authMethodUid ) const;
+	// condition argument which is either compared literally or matched as a precompiled regular expression
+	struct Pattern
+	{
+		QString text;
+		QRegularExpression regExp;
+		bool isRegExp{false};
+	};
+
+	struct CompiledCondition
+	{
+		AccessControlRule::Condition condition{AccessControlRule::Condition::None};
+		bool inverted{false};
+		AccessControlRule::Subject subject{AccessControlRule::Subject::None};
+		Pattern argument;
+		Plugin::Uid authMethodUid;
+	};
+
+	// enabled conditions of a rule ordered by evaluation cost so that cheap checks are done first
+	struct CompiledRule
+	{
+		AccessControlRule::Pointer rule;
+		QVector<CompiledCondition> conditions;
+	};
+
+	// inputs of a single access control decision along with the results of all lookups
+	// done so far so that each of them is performed at most once per decision
+	struct Decision
+	{
+		const QString& accessingUser;
+		const QString& accessingComputer;
+		const QString& localUser;
+		const QString& localComputer;
+		const QStringList& connectedUsers;
+		Plugin::Uid authMethodUid;
+
+		QHash<QString, QStringList> groupsOfUser{};
+		QHash<QString, QStringList> locationsOfComputer{};
+		std::optional<bool> isAccessFromLocalHost{};
+		std::optional<bool> isCurrentSessionRemote{};
+		std::optional<bool> hasCurrentSessionUser{};
+		std::optional<bool> isAnyUserLoggedInLocally{};
+		std::optional<bool> isAnyUserLoggedInRemotely{};
+	};
+
+	static CompiledRule compileRule( const AccessControlRule::Pointer& rule );
+	static Pattern compilePattern( const QString& pattern );
+
+	QStringList lookupGroupsOfUser( Decision& decision, const QString& user ) const;
+	QStringList lookupLocationsOfComputer( Decision& decision, const QString& computer ) const;
+
+	static QString lookupSubject( AccessControlRule::Subject subject, const Decision& decision );
+
+	bool matchConditions( const CompiledRule& compiledRule, Decision& decision ) const;
+	bool matchCondition( const CompiledCondition& condition, Decision& decision ) const;
 
 	static QStringList objectNames( const NetworkObjectList& objects );
-	static bool matchList(const QStringList& list, const QString& pattern);
+	static bool matchList( const QStringList& list, const Pattern& pattern );
 
-	QList<AccessControlRule::Pointer> m_accessControlRules{};
+	QVector<CompiledRule> m_compiledRules{};
 	UserGroupsBackendInterface* m_userGroupsBackend;
 	NetworkObjectDirectory* m_networkObjectDirectory;
 	bool m_useDomainUserGroups;
@@ -166,3 +166,54 @@ bool AuthenticationManager::initializeCredentials()
 
 	return false;
 }
+
+
+
+void AuthenticationManager::setAuthenticationTicket( const QString& serverAddress, const QByteArray& ticket, int lifetime )
+{
+	QMutexLocker locker( &m_authenticationTicketsMutex );
+
+	if( ticket.isEmpty() || lifetime <= 0 )
+	{
+		m_authenticationTickets.remove( serverAddress );
+		return;
+	}
+
+	m_authenticationTickets[serverAddress] = { ticket, QDeadlineTimer( qint64(lifetime) * 1000 ) };
+}
+
+
+
+QByteArray AuthenticationManager::takeAuthenticationTicket( const QString& serverAddress )
+{
+	QMutexLocker locker( &m_authenticationTicketsMutex );
+
+	// tickets are valid for a single authentication only
+	const auto ticket = m_authenticationTickets.take( serverAddress );
+	if( ticket.expiry.hasExpired() )
+	{
+		return {};
+	}
+
+	return ticket.data;
+}
+
+
+
+bool AuthenticationManager::hasAuthenticationTicket( const QString& serverAddress )
+{
+	QMutexLocker locker( &m_authenticationTicketsMutex );
+
+	const auto it = m_authenticationTickets.constFind( serverAddress );
+
+	return it != m_authenticationTickets.constEnd() && it->expiry.hasExpired() == false;
+}
+
+
+
+void AuthenticationManager::clearAuthenticationTickets()
+{
+	QMutexLocker locker( &m_authenticationTicketsMutex );
+
+	m_authenticationTickets.clear();
+}
@@ -24,6 +24,9 @@
 
 #pragma once
 
+#include <QDeadlineTimer>
+#include <QMutex>
+
 #include "AuthenticationPluginInterface.h"
 
 class VEYON_CORE_EXPORT AuthenticationManager : public QObject
@@ -68,9 +71,31 @@ public:
 		return m_initializedPlugin;
 	}
 
+	// pseudo authentication method for presenting a ticket issued by the server after a
+	// previous successful authentication instead of performing the full authentication again
+	static Plugin::Uid ticketAuthMethodUid()
+	{
+		return Plugin::Uid{QStringLiteral("3bc0e6f8-0d0c-4c64-9c3e-4e2ba7e5d7a1")};
+	}
+
+	// client side storage of tickets received from servers (identified by host and port)
+	void setAuthenticationTicket( const QString& serverAddress, const QByteArray& ticket, int lifetime );
+	QByteArray takeAuthenticationTicket( const QString& serverAddress );
+	bool hasAuthenticationTicket( const QString& serverAddress );
+	void clearAuthenticationTickets();
+
 private:
+	struct AuthenticationTicket
+	{
+		QByteArray data;
+		QDeadlineTimer expiry;
+	};
+
 	const QMap<LegacyAuthType, Plugin::Uid> m_legacyAuthTypes;
 	Plugins m_plugins{};
 	AuthenticationPluginInterface* m_initializedPlugin{nullptr};
 
+	QMutex m_authenticationTicketsMutex;
+	QHash<QString, AuthenticationTicket> m_authenticationTickets;
+
 };
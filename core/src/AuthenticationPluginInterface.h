@@ -43,7 +43,8 @@ public:
 	virtual bool hasCredentials() const = 0;
 	virtual bool checkCredentials() const = 0;
 
-	// server side authentication
+	// server side authentication - called in a worker thread with a detached copy of the
+	// client and a buffer instead of the socket as I/O device of the message
 	virtual VncServerClient::AuthState performAuthentication( VncServerClient* client, VariantArrayMessage& message ) const = 0;
 
 	// client side authentication
@@ -22,6 +22,7 @@
  *
  */
 
+#include "AuthenticationManager.h"
 #include "BuiltinFeatures.h"
 #include "ComputerControlInterface.h"
 #include "Computer.h"
@@ -51,6 +52,9 @@ ComputerControlInterface::ComputerControlInterface( const Computer& computer, in
 		setServerVersion(VeyonCore::ApplicationVersion::Unknown);
 	});
 
+	m_authenticationTicketTimer.setSingleShot(true);
+	connect(&m_authenticationTicketTimer, &QTimer::timeout, this, &ComputerControlInterface::updateAuthenticationTicket);
+
 	connect(&m_statePollingTimer, &QTimer::timeout, this, [this]() {
 		updateUser();
 		updateSessionInfo();
@@ -90,8 +94,8 @@ void ComputerControlInterface::start( QSize scaledFramebufferSize, UpdateMode up
 		{
 			Q_EMIT framebufferUpdated( QRect( x, y, w, h ) );
 		} );
-		connect( vncConnection, &VncConnection::framebufferUpdateComplete, this, [this]() {
-			resetWatchdog();
+		connect( vncConnection, &VncConnection::framebufferUpdateComplete, this, &ComputerControlInterface::resetWatchdog );
+		connect( vncConnection, &VncConnection::scaledFramebufferUpdated, this, [this]() {
 			++m_timestamp;
 			Q_EMIT scaledFramebufferUpdated();
 		} );
@@ -131,6 +135,7 @@ void ComputerControlInterface::stop()
 
 	m_pingTimer.stop();
 	m_connectionWatchdogTimer.stop();
+	m_authenticationTicketTimer.stop();
 
 	m_state = State::Disconnected;
 }
@@ -165,6 +170,8 @@ void ComputerControlInterface::setScaledFramebufferSize( QSize scaledFramebuffer
 		vncConnection()->setScaledSize( m_scaledFramebufferSize );
 	}
 
+	updateThumbnailSize();
+
 	++m_timestamp;
 
 	Q_EMIT scaledFramebufferUpdated();
@@ -216,6 +223,7 @@ void ComputerControlInterface::setServerVersion(VeyonCore::ApplicationVersion ve
 	const auto statePollingInterval = VeyonCore::config().computerStatePollingInterval();
 
 	setQuality();
+	updateAuthenticationTicket();
 
 	if (m_serverVersion >= VeyonCore::ApplicationVersion::Version_4_7 &&
 		statePollingInterval <= 0)
@@ -240,6 +248,24 @@ void ComputerControlInterface::setServerVersion(VeyonCore::ApplicationVersion ve
 
 
 
+void ComputerControlInterface::setAuthenticationTicket(const QByteArray& ticket, int lifetime)
+{
+	if (vncConnection() == nullptr)
+	{
+		return;
+	}
+
+	VeyonCore::authenticationManager().setAuthenticationTicket(vncConnection()->serverAddress(), ticket, lifetime);
+
+	// renew the single-use ticket before it expires so that it can be used whenever the connection drops
+	if (ticket.isEmpty() == false && lifetime > 0)
+	{
+		m_authenticationTicketTimer.start(lifetime * 1000 / 2);
+	}
+}
+
+
+
 void ComputerControlInterface::setUserInformation(const QString& userLoginName, const QString& userFullName)
 {
 	if (userLoginName != m_userLoginName ||
@@ -311,6 +337,18 @@ bool ComputerControlInterface::isMessageQueueEmpty()
 
 
 
+VncConnection::Statistics ComputerControlInterface::transportStatistics() const
+{
+	if( vncConnection() )
+	{
+		return vncConnection()->statistics();
+	}
+
+	return {};
+}
+
+
+
 void ComputerControlInterface::setUpdateMode( UpdateMode updateMode )
 {
 	m_updateMode = updateMode;
@@ -321,6 +359,7 @@ void ComputerControlInterface::setUpdateMode( UpdateMode updateMode )
 	if (vncConnection())
 	{
 		vncConnection()->setSkipHostPing(m_updateMode == UpdateMode::Basic || m_updateMode == UpdateMode::FeatureControlOnly);
+		vncConnection()->setPriority(connectionPriority());
 	}
 }
 
@@ -402,6 +441,73 @@ void ComputerControlInterface::setMinimumFramebufferUpdateInterval()
 	if (m_serverVersion >= VeyonCore::ApplicationVersion::Version_4_7)
 	{
 		VeyonCore::builtinFeatures().monitoringMode().setMinimumFramebufferUpdateInterval({weakPointer()}, updateInterval);
+
+		// let the server send updates in live mode without waiting for a request each time
+		const auto continuousUpdates = m_updateMode == UpdateMode::Live;
+		if (continuousUpdates || (vncConnection() && vncConnection()->hasContinuousFramebufferUpdates()))
+		{
+			VeyonCore::builtinFeatures().monitoringMode().setContinuousFramebufferUpdates({weakPointer()}, continuousUpdates);
+		}
+	}
+
+	updateThumbnailSize();
+	updateBandwidthLimit();
+}
+
+
+
+void ComputerControlInterface::updateThumbnailSize()
+{
+	if (VeyonCore::config().computerMonitoringServerSideScaling() == false ||
+		m_serverVersion < VeyonCore::ApplicationVersion::Version_4_8)
+	{
+		return;
+	}
+
+	// let the server send images at the displayed size only - in live mode (e.g. remote access)
+	// the full resolution is required
+	const auto thumbnails = m_updateMode == UpdateMode::Monitoring || m_updateMode == UpdateMode::Basic;
+
+	VeyonCore::builtinFeatures().monitoringMode().setThumbnailSize({weakPointer()},
+																   thumbnails ? m_scaledFramebufferSize : QSize{});
+}
+
+
+
+void ComputerControlInterface::updateBandwidthLimit()
+{
+	if (m_serverVersion < VeyonCore::ApplicationVersion::Version_4_8)
+	{
+		return;
+	}
+
+	// limits are configured in kB/s
+	const auto bandwidthLimit = m_updateMode == UpdateMode::Live ? VeyonCore::config().remoteAccessBandwidthLimit()
+																 : VeyonCore::config().computerMonitoringBandwidthLimit();
+
+	VeyonCore::builtinFeatures().monitoringMode().setBandwidthLimit({weakPointer()}, qMax(0, bandwidthLimit) * 1000);
+}
+
+
+
+void ComputerControlInterface::updateAuthenticationTicket()
+{
+	m_authenticationTicketTimer.stop();
+
+	if (vncConnection() && state() == State::Connected &&
+		m_serverVersion >= VeyonCore::ApplicationVersion::Version_4_8)
+	{
+		VeyonCore::builtinFeatures().monitoringMode().requestAuthenticationTicket({weakPointer()});
+	}
+}
+
+
+
+void ComputerControlInterface::setContinuousFramebufferUpdates(bool enabled)
+{
+	if (vncConnection())
+	{
+		vncConnection()->setContinuousFramebufferUpdates(enabled);
 	}
 }
 
@@ -410,6 +516,8 @@ void ComputerControlInterface::setMinimumFramebufferUpdateInterval()
 void ComputerControlInterface::setQuality()
 {
 	auto quality = VncConnectionConfiguration::Quality::Highest;
+	auto minimumQuality = quality;
+	auto reducedColorDepth = false;
 
 	if (m_serverVersion >= VeyonCore::ApplicationVersion::Version_4_8)
 	{
@@ -418,27 +526,53 @@ void ComputerControlInterface::setQuality()
 		case UpdateMode::Disabled:
 		case UpdateMode::FeatureControlOnly:
 			quality = VncConnectionConfiguration::Quality::Lowest;
+			minimumQuality = quality;
 			break;
 
 		case UpdateMode::Basic:
 		case UpdateMode::Monitoring:
 			quality = VeyonCore::config().computerMonitoringImageQuality();
+			minimumQuality = VeyonCore::config().computerMonitoringAdaptiveImageQuality() ?
+								 VeyonCore::config().computerMonitoringMinimumImageQuality() : quality;
+			reducedColorDepth = VeyonCore::config().computerMonitoringReducedColorDepth();
 			break;
 
 		case UpdateMode::Live:
 			quality = VeyonCore::config().remoteAccessImageQuality();
+			minimumQuality = VeyonCore::config().remoteAccessAdaptiveImageQuality() ?
+								 VeyonCore::config().remoteAccessMinimumImageQuality() : quality;
 			break;
 		}
 	}
 
 	if (vncConnection())
 	{
-		vncConnection()->setQuality(quality);
+		vncConnection()->setReducedColorDepth(reducedColorDepth);
+		vncConnection()->setQuality(quality, minimumQuality);
 	}
 }
 
 
 
+VncConnection::Priority ComputerControlInterface::connectionPriority() const
+{
+	switch (m_updateMode)
+	{
+	case UpdateMode::Live:
+		return VncConnection::Priority::Interactive;
+	case UpdateMode::Basic:
+	case UpdateMode::Monitoring:
+		return VncConnection::Priority::Visible;
+	case UpdateMode::Disabled:
+	case UpdateMode::FeatureControlOnly:
+		break;
+	}
+
+	return VncConnection::Priority::Background;
+}
+
+
+
 void ComputerControlInterface::resetWatchdog()
 {
 	if( state() == State::Connected )
@@ -120,6 +120,8 @@ public:
 
 	void setServerVersion(VeyonCore::ApplicationVersion version);
 
+	void setAuthenticationTicket(const QByteArray& ticket, int lifetime);
+
 	const QString& userLoginName() const
 	{
 		return m_userLoginName;
@@ -176,12 +178,17 @@ public:
 	void sendFeatureMessage(const FeatureMessage& featureMessage);
 	bool isMessageQueueEmpty();
 
+	VncConnection::Statistics transportStatistics() const;
+
 	void setUpdateMode( UpdateMode updateMode );
+
 	UpdateMode updateMode() const
 	{
 		return m_updateMode;
 	}
 
+	void setContinuousFramebufferUpdates(bool enabled);
+
 	void setProperty(QUuid propertyId, const QVariant& data);
 
 	QVariant queryProperty(QUuid propertyId);
@@ -202,7 +209,11 @@ public:
 private:
 	void ping();
 	void setMinimumFramebufferUpdateInterval();
+	void updateThumbnailSize();
+	void updateBandwidthLimit();
+	void updateAuthenticationTicket();
 	void setQuality();
+	VncConnection::Priority connectionPriority() const;
 	void resetWatchdog();
 	void restartConnection();
 
@@ -242,6 +253,7 @@ private:
 
 	VeyonCore::ApplicationVersion m_serverVersion{VeyonCore::ApplicationVersion::Unknown};
 	QTimer m_serverVersionQueryTimer{this};
+	QTimer m_authenticationTicketTimer{this};
 
 	QString m_accessControlMessage{};
 	QTimer m_statePollingTimer{this};
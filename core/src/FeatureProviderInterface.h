@@ -162,6 +162,10 @@ public:
 
 	/*!
 	 * \brief Send asynchronous messages (e.g. notifications or state updates) to client
+	 *
+	 * Called once for every new connection and afterwards only after
+	 * VeyonServerInterface::notifyAsyncFeatureStateChanged() has been called, i.e. implementations
+	 * have to call it whenever the state to be sent has changed.
 	 */
 	virtual void sendAsyncFeatureMessages(VeyonServerInterface& server, const MessageContext& messageContext)
 	{
@@ -0,0 +1,307 @@
+/*
+ * FramebufferScaler.cpp - implementation of FramebufferScaler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <array>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define FRAMEBUFFER_SCALER_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define FRAMEBUFFER_SCALER_NEON
+#include <arm_neon.h>
+#endif
+
+#include "FramebufferScaler.h"
+
+// Every implementation only differs in how source rows are summed up per channel (which is where nearly all of
+// the time is spent). As all sums are exact integers, the results of all implementations are bit-identical.
+
+using RowAccumulator = void(*)( const uint8_t* row, uint32_t* sums, int pixelCount );
+
+static constexpr int BytesPerPixel = 4;
+
+
+static void accumulateRowScalar( const uint8_t* row, uint32_t* sums, int pixelCount )
+{
+	for( int i = 0; i < pixelCount * BytesPerPixel; ++i )
+	{
+		sums[i] += row[i];
+	}
+}
+
+
+
+#ifdef FRAMEBUFFER_SCALER_X86
+static void accumulateRowSSE2( const uint8_t* row, uint32_t* sums, int pixelCount )
+{
+	const auto zero = _mm_setzero_si128();
+
+	int x = 0;
+	for( ; x + 4 <= pixelCount; x += 4 )
+	{
+		const auto pixels = _mm_loadu_si128( reinterpret_cast<const __m128i *>( row + x * BytesPerPixel ) );
+		const auto low = _mm_unpacklo_epi8( pixels, zero );
+		const auto high = _mm_unpackhi_epi8( pixels, zero );
+
+		auto s = reinterpret_cast<__m128i *>( sums + x * BytesPerPixel );
+		_mm_storeu_si128( s + 0, _mm_add_epi32( _mm_loadu_si128( s + 0 ), _mm_unpacklo_epi16( low, zero ) ) );
+		_mm_storeu_si128( s + 1, _mm_add_epi32( _mm_loadu_si128( s + 1 ), _mm_unpackhi_epi16( low, zero ) ) );
+		_mm_storeu_si128( s + 2, _mm_add_epi32( _mm_loadu_si128( s + 2 ), _mm_unpacklo_epi16( high, zero ) ) );
+		_mm_storeu_si128( s + 3, _mm_add_epi32( _mm_loadu_si128( s + 3 ), _mm_unpackhi_epi16( high, zero ) ) );
+	}
+
+	accumulateRowScalar( row + x * BytesPerPixel, sums + x * BytesPerPixel, pixelCount - x );
+}
+
+
+
+__attribute__((target("avx2")))
+static void accumulateRowAVX2( const uint8_t* row, uint32_t* sums, int pixelCount )
+{
+	int x = 0;
+	for( ; x + 8 <= pixelCount; x += 8 )
+	{
+		const auto pixels = row + x * BytesPerPixel;
+		auto s = reinterpret_cast<__m256i *>( sums + x * BytesPerPixel );
+
+		// widen two pixels (8 channels) at a time
+		for( int i = 0; i < 4; ++i )
+		{
+			const auto channels = _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i *>( pixels + i * 8 ) ) );
+			_mm256_storeu_si256( s + i, _mm256_add_epi32( _mm256_loadu_si256( s + i ), channels ) );
+		}
+	}
+
+	accumulateRowSSE2( row + x * BytesPerPixel, sums + x * BytesPerPixel, pixelCount - x );
+}
+#endif
+
+
+
+#ifdef FRAMEBUFFER_SCALER_NEON
+static void accumulateRowNEON( const uint8_t* row, uint32_t* sums, int pixelCount )
+{
+	int x = 0;
+	for( ; x + 4 <= pixelCount; x += 4 )
+	{
+		const auto pixels = vld1q_u8( row + x * BytesPerPixel );
+		const auto low = vmovl_u8( vget_low_u8( pixels ) );
+		const auto high = vmovl_u8( vget_high_u8( pixels ) );
+
+		auto s = sums + x * BytesPerPixel;
+		vst1q_u32( s + 0, vaddq_u32( vld1q_u32( s + 0 ), vmovl_u16( vget_low_u16( low ) ) ) );
+		vst1q_u32( s + 4, vaddq_u32( vld1q_u32( s + 4 ), vmovl_u16( vget_high_u16( low ) ) ) );
+		vst1q_u32( s + 8, vaddq_u32( vld1q_u32( s + 8 ), vmovl_u16( vget_low_u16( high ) ) ) );
+		vst1q_u32( s + 12, vaddq_u32( vld1q_u32( s + 12 ), vmovl_u16( vget_high_u16( high ) ) ) );
+	}
+
+	accumulateRowScalar( row + x * BytesPerPixel, sums + x * BytesPerPixel, pixelCount - x );
+}
+#endif
+
+
+
+static RowAccumulator rowAccumulator( FramebufferScaler::Implementation implementation )
+{
+	switch( implementation )
+	{
+#ifdef FRAMEBUFFER_SCALER_X86
+	case FramebufferScaler::Implementation::SSE2: return accumulateRowSSE2;
+	case FramebufferScaler::Implementation::AVX2: return accumulateRowAVX2;
+#endif
+#ifdef FRAMEBUFFER_SCALER_NEON
+	case FramebufferScaler::Implementation::NEON: return accumulateRowNEON;
+#endif
+	default:
+		break;
+	}
+
+	return accumulateRowScalar;
+}
+
+
+
+static bool isSupportedFormat( QImage::Format format )
+{
+	return format == QImage::Format_RGB32 ||
+		   format == QImage::Format_ARGB32_Premultiplied;
+}
+
+
+
+FramebufferScaler::Implementation FramebufferScaler::defaultImplementation()
+{
+	static const auto implementation = [] {
+		for( auto candidate : { Implementation::AVX2, Implementation::NEON, Implementation::SSE2 } )
+		{
+			if( isSupported( candidate ) )
+			{
+				return candidate;
+			}
+		}
+		return Implementation::Scalar;
+	}();
+
+	return implementation;
+}
+
+
+
+bool FramebufferScaler::isSupported( Implementation implementation )
+{
+	switch( implementation )
+	{
+	case Implementation::Scalar:
+		return true;
+#ifdef FRAMEBUFFER_SCALER_X86
+	case Implementation::SSE2:
+		return true;
+	case Implementation::AVX2:
+		return __builtin_cpu_supports("avx2");
+#endif
+#ifdef FRAMEBUFFER_SCALER_NEON
+	case Implementation::NEON:
+		return true;
+#endif
+	default:
+		break;
+	}
+
+	return false;
+}
+
+
+
+bool FramebufferScaler::canScale( const QImage& source, QSize targetSize )
+{
+	return source.isNull() == false &&
+		   isSupportedFormat( source.format() ) &&
+		   targetSize.isEmpty() == false &&
+		   targetSize.width() <= source.width() &&
+		   targetSize.height() <= source.height() &&
+		   // keep per-channel sums within 32 bit
+		   qint64( source.width() / targetSize.width() + 1 ) * ( source.height() / targetSize.height() + 1 ) * 255 < 0xffffffffLL;
+}
+
+
+
+QImage FramebufferScaler::scaled( const QImage& source, QSize size, Qt::AspectRatioMode aspectRatioMode,
+								  Implementation implementation )
+{
+	if( source.isNull() )
+	{
+		return {};
+	}
+
+	const auto targetSize = source.size().scaled( size, aspectRatioMode );
+
+	auto effectiveSource = source;
+	if( source.format() == QImage::Format_ARGB32 )
+	{
+		// averaging color channels requires premultiplied alpha
+		effectiveSource = source.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+	}
+
+	if( canScale( effectiveSource, targetSize ) == false )
+	{
+		return source.scaled( targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+	}
+
+	QImage target( targetSize, effectiveSource.format() );
+	scaleRect( effectiveSource, target, target.rect(), implementation );
+
+	return target;
+}
+
+
+
+void FramebufferScaler::scaleRect( const QImage& source, QImage& target, const QRect& targetRect,
+								   Implementation implementation )
+{
+	const auto rect = targetRect & target.rect();
+	if( rect.isEmpty() || source.isNull() ||
+		source.depth() != BytesPerPixel * 8 || target.depth() != BytesPerPixel * 8 )
+	{
+		return;
+	}
+
+	const auto sourceWidth = source.width();
+	const auto sourceHeight = source.height();
+	const auto targetWidth = target.width();
+	const auto targetHeight = target.height();
+
+	const auto accumulateRow = rowAccumulator( implementation );
+
+	// source columns covered by each target column of the requested area
+	std::vector<int> columnBegin( size_t(rect.width()) );
+	std::vector<int> columnEnd( size_t(rect.width()) );
+	for( int i = 0; i < rect.width(); ++i )
+	{
+		const auto dx = rect.x() + i;
+		columnBegin[size_t(i)] = int( qint64(dx) * sourceWidth / targetWidth );
+		columnEnd[size_t(i)] = qMax( columnBegin[size_t(i)] + 1, int( qint64(dx + 1) * sourceWidth / targetWidth ) );
+	}
+
+	const auto sourceX = columnBegin.front();
+	const auto sourceSpan = columnEnd.back() - sourceX;
+
+	std::vector<uint32_t> columnSums( size_t(sourceSpan) * BytesPerPixel );
+
+	for( int dy = rect.top(); dy <= rect.bottom(); ++dy )
+	{
+		const auto rowBegin = int( qint64(dy) * sourceHeight / targetHeight );
+		const auto rowEnd = qMax( rowBegin + 1, int( qint64(dy + 1) * sourceHeight / targetHeight ) );
+
+		std::fill( columnSums.begin(), columnSums.end(), 0 );
+
+		for( int y = rowBegin; y < rowEnd; ++y )
+		{
+			accumulateRow( source.constScanLine( y ) + sourceX * BytesPerPixel, columnSums.data(), sourceSpan );
+		}
+
+		auto targetPixel = target.scanLine( dy ) + rect.x() * BytesPerPixel;
+
+		for( int i = 0; i < rect.width(); ++i )
+		{
+			std::array<uint32_t, BytesPerPixel> sum{};
+			for( int x = columnBegin[size_t(i)]; x < columnEnd[size_t(i)]; ++x )
+			{
+				const auto columnSum = columnSums.data() + ( x - sourceX ) * BytesPerPixel;
+				for( int c = 0; c < BytesPerPixel; ++c )
+				{
+					sum[size_t(c)] += columnSum[c];
+				}
+			}
+
+			const auto count = uint32_t( columnEnd[size_t(i)] - columnBegin[size_t(i)] ) * uint32_t( rowEnd - rowBegin );
+			for( int c = 0; c < BytesPerPixel; ++c )
+			{
+				targetPixel[c] = uint8_t( ( sum[size_t(c)] + count / 2 ) / count );
+			}
+
+			targetPixel += BytesPerPixel;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * FramebufferScaler.h - declaration of FramebufferScaler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QImage>
+
+#include "VeyonCore.h"
+
+// area-averaging (box filter) downscaler for 32 bit framebuffers
+class VEYON_CORE_EXPORT FramebufferScaler
+{
+public:
+	enum class Implementation
+	{
+		Scalar,
+		SSE2,
+		AVX2,
+		NEON
+	};
+
+	static Implementation defaultImplementation();
+	static bool isSupported( Implementation implementation );
+
+	/** \brief Returns whether scaleRect() can be used for the given source and target parameters */
+	static bool canScale( const QImage& source, QSize targetSize );
+
+	/** \brief Returns a downscaled copy of source, falls back to QImage::scaled() if source can't be scaled directly */
+	static QImage scaled( const QImage& source, QSize size, Qt::AspectRatioMode aspectRatioMode = Qt::IgnoreAspectRatio,
+						  Implementation implementation = defaultImplementation() );
+
+	/** \brief Updates the area targetRect of target which represents the whole source image downscaled */
+	static void scaleRect( const QImage& source, QImage& target, const QRect& targetRect,
+						   Implementation implementation = defaultImplementation() );
+
+};
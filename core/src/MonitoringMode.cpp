@@ -70,6 +70,10 @@ MonitoringMode::MonitoringMode( QObject* parent ) :
 {
 	if(VeyonCore::component() == VeyonCore::Component::Server)
 	{
+		// user and session information are updated in worker threads
+		connect(this, &MonitoringMode::asyncFeatureStateChanged,
+				this, &MonitoringMode::notifyAsyncFeatureStateChanged, Qt::QueuedConnection);
+
 		connect(&m_activeFeaturesUpdateTimer, &QTimer::timeout, this, &MonitoringMode::updateActiveFeatures);
 		m_activeFeaturesUpdateTimer.start(ActiveFeaturesUpdateInterval);
 
@@ -104,6 +108,43 @@ void MonitoringMode::setMinimumFramebufferUpdateInterval(const ComputerControlIn
 
 
 
+void MonitoringMode::setContinuousFramebufferUpdates(const ComputerControlInterfaceList& computerControlInterfaces,
+													 bool enabled)
+{
+	sendFeatureMessage(FeatureMessage{m_monitoringModeFeature.uid(), Command::SetContinuousFramebufferUpdates}
+					   .addArgument(Argument::ContinuousFramebufferUpdates, enabled),
+					   computerControlInterfaces);
+}
+
+
+
+void MonitoringMode::setThumbnailSize(const ComputerControlInterfaceList& computerControlInterfaces, QSize size)
+{
+	sendFeatureMessage(FeatureMessage{m_monitoringModeFeature.uid(), Command::SetThumbnailSize}
+					   .addArgument(Argument::ThumbnailWidth, size.width())
+					   .addArgument(Argument::ThumbnailHeight, size.height()),
+					   computerControlInterfaces);
+}
+
+
+
+void MonitoringMode::setBandwidthLimit(const ComputerControlInterfaceList& computerControlInterfaces, int bytesPerSecond)
+{
+	sendFeatureMessage(FeatureMessage{m_monitoringModeFeature.uid(), Command::SetBandwidthLimit}
+					   .addArgument(Argument::BandwidthLimit, bytesPerSecond),
+					   computerControlInterfaces);
+}
+
+
+
+void MonitoringMode::requestAuthenticationTicket(const ComputerControlInterfaceList& computerControlInterfaces)
+{
+	sendFeatureMessage(FeatureMessage{m_monitoringModeFeature.uid(), Command::IssueAuthenticationTicket},
+					   computerControlInterfaces);
+}
+
+
+
 void MonitoringMode::queryApplicationVersion(const ComputerControlInterfaceList& computerControlInterfaces)
 {
 	sendFeatureMessage(FeatureMessage{m_queryApplicationVersionFeature.uid()}, computerControlInterfaces);
@@ -149,6 +190,27 @@ bool MonitoringMode::handleFeatureMessage( ComputerControlInterface::Pointer com
 			// successful ping reply implicitly handled through the featureMessageReceived() signal
 			return true;
 		}
+
+		if (message.command() == Command::SetContinuousFramebufferUpdates)
+		{
+			// servers not supporting continuous updates do not reply at all
+			computerControlInterface->setContinuousFramebufferUpdates(
+				message.argument(Argument::ContinuousFramebufferUpdates).toBool());
+			return true;
+		}
+
+		if (message.command() == Command::SetThumbnailSize)
+		{
+			// thumbnail size is applied through the framebuffer size sent by the server
+			return true;
+		}
+
+		if (message.command() == Command::IssueAuthenticationTicket)
+		{
+			computerControlInterface->setAuthenticationTicket(message.argument(Argument::AuthenticationTicket).toByteArray(),
+															  message.argument(Argument::AuthenticationTicketLifetime).toInt());
+			return true;
+		}
 	}
 
 	if (message.featureUid() == m_queryApplicationVersionFeature.uid())
@@ -239,6 +301,42 @@ bool MonitoringMode::handleFeatureMessage(VeyonServerInterface& server,
 													   message.argument(Argument::MinimumFramebufferUpdateInterval).toInt());
 			return true;
 		}
+
+		if (message.command() == Command::SetContinuousFramebufferUpdates)
+		{
+			const auto enabled = server.setContinuousFramebufferUpdates(messageContext,
+										message.argument(Argument::ContinuousFramebufferUpdates).toBool());
+
+			return server.sendFeatureMessageReply(messageContext,
+												  FeatureMessage{m_monitoringModeFeature.uid(), Command::SetContinuousFramebufferUpdates}
+												  .addArgument(Argument::ContinuousFramebufferUpdates, enabled));
+		}
+
+		if (message.command() == Command::SetThumbnailSize)
+		{
+			const auto size = server.setThumbnailSize(messageContext,
+													  QSize{message.argument(Argument::ThumbnailWidth).toInt(),
+															message.argument(Argument::ThumbnailHeight).toInt()});
+
+			return server.sendFeatureMessageReply(messageContext,
+												  FeatureMessage{m_monitoringModeFeature.uid(), Command::SetThumbnailSize}
+												  .addArgument(Argument::ThumbnailWidth, size.width())
+												  .addArgument(Argument::ThumbnailHeight, size.height()));
+		}
+
+		if (message.command() == Command::SetBandwidthLimit)
+		{
+			server.setBandwidthLimit(messageContext, message.argument(Argument::BandwidthLimit).toInt());
+			return true;
+		}
+
+		if (message.command() == Command::IssueAuthenticationTicket)
+		{
+			return server.sendFeatureMessageReply(messageContext,
+												  FeatureMessage{m_monitoringModeFeature.uid(), Command::IssueAuthenticationTicket}
+												  .addArgument(Argument::AuthenticationTicket, server.issueAuthenticationTicket(messageContext))
+												  .addArgument(Argument::AuthenticationTicketLifetime, server.authenticationTicketLifetime()));
+		}
 	}
 
 	if (message.featureUid() == m_queryApplicationVersionFeature.uid())
@@ -275,38 +373,32 @@ bool MonitoringMode::handleFeatureMessage(VeyonServerInterface& server,
 
 void MonitoringMode::sendAsyncFeatureMessages(VeyonServerInterface& server, const MessageContext& messageContext)
 {
-	const auto activeFeaturesVersion = messageContext.ioDevice()->property(activeFeaturesVersionProperty()).toInt();
+	auto& versions = asyncFeatureStateVersions(messageContext.ioDevice());
 
-	if (activeFeaturesVersion != m_activeFeaturesVersion)
+	if (versions.activeFeatures != m_activeFeaturesVersion)
 	{
 		sendActiveFeatures(server, messageContext);
-		messageContext.ioDevice()->setProperty(activeFeaturesVersionProperty(), m_activeFeaturesVersion);
+		versions.activeFeatures = m_activeFeaturesVersion;
 	}
 
 	const auto currentUserInfoVersion = m_userInfoVersion.loadAcquire();
-	const auto contextUserInfoVersion = messageContext.ioDevice()->property(userInfoVersionProperty()).toInt();
-
-	if(contextUserInfoVersion != currentUserInfoVersion)
+	if (versions.userInfo != currentUserInfoVersion)
 	{
 		sendUserInformation(server, messageContext);
-		messageContext.ioDevice()->setProperty(userInfoVersionProperty(), currentUserInfoVersion);
+		versions.userInfo = currentUserInfoVersion;
 	}
 
 	const auto currentSessionInfoVersion = m_sessionInfoVersion.loadAcquire();
-	const auto sessionInfoVersion = messageContext.ioDevice()->property(sessionInfoVersionProperty()).toInt();
-
-	if (sessionInfoVersion != currentSessionInfoVersion)
+	if (versions.sessionInfo != currentSessionInfoVersion)
 	{
 		sendSessionInfo(server, messageContext);
-		messageContext.ioDevice()->setProperty(sessionInfoVersionProperty(), currentSessionInfoVersion);
+		versions.sessionInfo = currentSessionInfoVersion;
 	}
 
-	const auto screenInfoVersion = messageContext.ioDevice()->property(screenInfoListVersionProperty()).toInt();
-
-	if (screenInfoVersion != m_screenInfoListVersion)
+	if (versions.screenInfoList != m_screenInfoListVersion)
 	{
 		sendScreenInfoList(server, messageContext);
-		messageContext.ioDevice()->setProperty(screenInfoListVersionProperty(), m_screenInfoListVersion);
+		versions.screenInfoList = m_screenInfoListVersion;
 	}
 }
 
@@ -371,6 +463,33 @@ bool MonitoringMode::sendScreenInfoList(VeyonServerInterface& server, const Mess
 
 
 
+MonitoringMode::AsyncFeatureStateVersions& MonitoringMode::asyncFeatureStateVersions(QIODevice* ioDevice)
+{
+	auto it = m_asyncFeatureStateVersions.find(ioDevice);
+	if (it == m_asyncFeatureStateVersions.end())
+	{
+		connect(ioDevice, &QObject::destroyed, this, [this, ioDevice]() {
+			m_asyncFeatureStateVersions.remove(ioDevice);
+		});
+		it = m_asyncFeatureStateVersions.insert(ioDevice, {});
+	}
+
+	return *it;
+}
+
+
+
+void MonitoringMode::notifyAsyncFeatureStateChanged()
+{
+	const auto server = VeyonCore::instance()->findChild<VeyonServerInterface *>();
+	if (server)
+	{
+		server->notifyAsyncFeatureStateChanged();
+	}
+}
+
+
+
 void MonitoringMode::updateActiveFeatures()
 {
 	const auto server = VeyonCore::instance()->findChild<VeyonServerInterface *>();
@@ -390,6 +509,7 @@ void MonitoringMode::updateActiveFeatures()
 		{
 			m_activeFeatures = activeFeatures;
 			m_activeFeaturesVersion++;
+			notifyAsyncFeatureStateChanged();
 		}
 	}
 }
@@ -412,6 +532,7 @@ void MonitoringMode::updateUserData()
 				m_userLoginName = userLoginName;
 				m_userFullName = userFullName;
 				++m_userInfoVersion;
+				Q_EMIT asyncFeatureStateChanged();
 			}
 			m_userDataLock.unlock();
 		}
@@ -450,6 +571,7 @@ void MonitoringMode::updateSessionInfo()
 		{
 			m_sessionInfo = currentSessionInfo;
 			++m_sessionInfoVersion;
+			Q_EMIT asyncFeatureStateChanged();
 		}
 		m_sessionInfoLock.unlock();
 	});
@@ -481,5 +603,6 @@ void MonitoringMode::updateScreenInfoList()
 	{
 		m_screenInfoList = screenInfoList;
 		++m_screenInfoListVersion;
+		notifyAsyncFeatureStateChanged();
 	}
 }
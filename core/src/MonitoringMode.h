@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <QHash>
 #include <QTimer>
 
 #include "FeatureProviderInterface.h"
@@ -47,6 +48,12 @@ public:
 		SessionClientAddress,
 		SessionClientName,
 		SessionMetaData,
+		ContinuousFramebufferUpdates,
+		ThumbnailWidth,
+		ThumbnailHeight,
+		AuthenticationTicket,
+		AuthenticationTicketLifetime,
+		BandwidthLimit,
 		ActiveFeaturesList = 0 // for compatibility after migration from FeatureControl
 	};
 	Q_ENUM(Argument)
@@ -98,6 +105,15 @@ public:
 	void setMinimumFramebufferUpdateInterval(const ComputerControlInterfaceList& computerControlInterfaces,
 											 int interval);
 
+	void setContinuousFramebufferUpdates(const ComputerControlInterfaceList& computerControlInterfaces,
+										 bool enabled);
+
+	void setThumbnailSize(const ComputerControlInterfaceList& computerControlInterfaces, QSize size);
+
+	void setBandwidthLimit(const ComputerControlInterfaceList& computerControlInterfaces, int bytesPerSecond);
+
+	void requestAuthenticationTicket(const ComputerControlInterfaceList& computerControlInterfaces);
+
 	void queryApplicationVersion(const ComputerControlInterfaceList& computerControlInterfaces);
 
 	void queryActiveFeatures(const ComputerControlInterfaceList& computerControlInterfaces);
@@ -134,25 +150,17 @@ private:
 	bool sendSessionInfo(VeyonServerInterface& server, const MessageContext& messageContext);
 	bool sendScreenInfoList(VeyonServerInterface& server, const MessageContext& messageContext);
 
-	static const char* activeFeaturesVersionProperty()
-	{
-		return "activeFeaturesListVersion";
-	}
-
-	static const char* userInfoVersionProperty()
-	{
-		return "userInfoVersion";
-	}
-
-	static const char* sessionInfoVersionProperty()
+	// versions of the state which has been sent to a client connection
+	struct AsyncFeatureStateVersions
 	{
-		return "sessionInfoVersion";
-	}
+		int activeFeatures{0};
+		int userInfo{0};
+		int sessionInfo{0};
+		int screenInfoList{0};
+	};
 
-	static const char* screenInfoListVersionProperty()
-	{
-		return "screenInfoListVersion";
-	}
+	AsyncFeatureStateVersions& asyncFeatureStateVersions(QIODevice* ioDevice);
+	void notifyAsyncFeatureStateChanged();
 
 	void updateActiveFeatures();
 	void updateUserData();
@@ -162,7 +170,11 @@ private:
 	enum Command
 	{
 		Ping,
-		SetMinimumFramebufferUpdateInterval
+		SetMinimumFramebufferUpdateInterval,
+		SetContinuousFramebufferUpdates,
+		SetThumbnailSize,
+		IssueAuthenticationTicket,
+		SetBandwidthLimit
 	};
 
 	static constexpr int ActiveFeaturesUpdateInterval = 250;
@@ -197,4 +209,9 @@ private:
 	QAtomicInt m_sessionInfoVersion = 0;
 	QTimer m_sessionInfoUpdateTimer;
 
+	QHash<const QIODevice *, AsyncFeatureStateVersions> m_asyncFeatureStateVersions;
+
+Q_SIGNALS:
+	void asyncFeatureStateChanged();
+
 };
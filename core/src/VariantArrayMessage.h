@@ -53,6 +53,12 @@ public:
 
 	VariantArrayMessage& write( const QVariant& v );
 
+	// raw data of a received or composed message without the size header
+	const QByteArray& data() const
+	{
+		return m_buffer.data();
+	}
+
 	QIODevice* ioDevice() const
 	{
 		return m_ioDevice;
@@ -54,6 +54,10 @@
 	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionSocketKeepaliveIdleTime, setVncConnectionSocketKeepaliveIdleTime, "SocketKeepaliveIdleTime", "VncConnection", VncConnectionConfiguration::DefaultSocketKeepaliveIdleTime, Configuration::Property::Flag::Hidden )			\
 	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionSocketKeepaliveInterval, setVncConnectionSocketKeepaliveInterval, "SocketKeepaliveInterval", "VncConnection", VncConnectionConfiguration::DefaultSocketKeepaliveInterval, Configuration::Property::Flag::Hidden )			\
 	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionSocketKeepaliveCount, setVncConnectionSocketKeepaliveCount, "SocketKeepaliveCount", "VncConnection", VncConnectionConfiguration::DefaultSocketKeepaliveCount, Configuration::Property::Flag::Hidden )			\
+	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionFramebufferUpdatesInFlight, setVncConnectionFramebufferUpdatesInFlight, "FramebufferUpdatesInFlight", "VncConnection", VncConnectionConfiguration::DefaultFramebufferUpdatesInFlight, Configuration::Property::Flag::Hidden )			\
+	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionIoThreadCount, setVncConnectionIoThreadCount, "IoThreadCount", "VncConnection", VncConnectionConfiguration::DefaultIoThreadCount, Configuration::Property::Flag::Hidden )			\
+	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionMaximumConcurrentHandshakes, setVncConnectionMaximumConcurrentHandshakes, "MaximumConcurrentHandshakes", "VncConnection", VncConnectionConfiguration::DefaultMaximumConcurrentHandshakes, Configuration::Property::Flag::Hidden )			\
+	OP( VeyonConfiguration, VeyonCore::config(), int, vncConnectionMaximumRetryInterval, setVncConnectionMaximumRetryInterval, "MaximumConnectionRetryInterval", "VncConnection", VncConnectionConfiguration::DefaultMaximumConnectionRetryInterval, Configuration::Property::Flag::Hidden )			\
 
 #define FOREACH_VEYON_UI_CONFIG_PROPERTY(OP)				\
 	OP( VeyonConfiguration, VeyonCore::config(), QString, applicationName, setApplicationName, "ApplicationName", "UI", QStringLiteral("Veyon"), Configuration::Property::Flag::Hidden )			\
@@ -120,6 +124,14 @@
 	OP( VeyonConfiguration, VeyonCore::config(), bool, modernUserInterface, setModernUserInterface, "ModernUserInterface", "Master", false, Configuration::Property::Flag::Standard )	\
 	OP( VeyonConfiguration, VeyonCore::config(), VncConnectionConfiguration::Quality, computerMonitoringImageQuality, setComputerMonitoringImageQuality, "ComputerMonitoringImageQuality", "Master", QVariant::fromValue(VncConnectionConfiguration::Quality::Medium), Configuration::Property::Flag::Standard )    \
 	OP( VeyonConfiguration, VeyonCore::config(), VncConnectionConfiguration::Quality, remoteAccessImageQuality, setRemoteAccessImageQuality, "RemoteAccessImageQuality", "Master", QVariant::fromValue(VncConnectionConfiguration::Quality::Highest), Configuration::Property::Flag::Standard )	\
+	OP( VeyonConfiguration, VeyonCore::config(), bool, computerMonitoringAdaptiveImageQuality, setComputerMonitoringAdaptiveImageQuality, "ComputerMonitoringAdaptiveImageQuality", "Master", false, Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), VncConnectionConfiguration::Quality, computerMonitoringMinimumImageQuality, setComputerMonitoringMinimumImageQuality, "ComputerMonitoringMinimumImageQuality", "Master", QVariant::fromValue(VncConnectionConfiguration::Quality::Lowest), Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), bool, remoteAccessAdaptiveImageQuality, setRemoteAccessAdaptiveImageQuality, "RemoteAccessAdaptiveImageQuality", "Master", false, Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), VncConnectionConfiguration::Quality, remoteAccessMinimumImageQuality, setRemoteAccessMinimumImageQuality, "RemoteAccessMinimumImageQuality", "Master", QVariant::fromValue(VncConnectionConfiguration::Quality::Low), Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), bool, computerMonitoringServerSideScaling, setComputerMonitoringServerSideScaling, "ComputerMonitoringServerSideScaling", "Master", false, Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), bool, computerMonitoringReducedColorDepth, setComputerMonitoringReducedColorDepth, "ComputerMonitoringReducedColorDepth", "Master", false, Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), int, computerMonitoringBandwidthLimit, setComputerMonitoringBandwidthLimit, "ComputerMonitoringBandwidthLimit", "Master", 0, Configuration::Property::Flag::Advanced )	\
+	OP( VeyonConfiguration, VeyonCore::config(), int, remoteAccessBandwidthLimit, setRemoteAccessBandwidthLimit, "RemoteAccessBandwidthLimit", "Master", 0, Configuration::Property::Flag::Advanced )	\
 	OP( VeyonConfiguration, VeyonCore::config(), int, computerMonitoringUpdateInterval, setComputerMonitoringUpdateInterval, "ComputerMonitoringUpdateInterval", "Master", 1000, Configuration::Property::Flag::Standard )	\
 	OP( VeyonConfiguration, VeyonCore::config(), int, computerMonitoringThumbnailSpacing, setComputerMonitoringThumbnailSpacing, "ComputerMonitoringThumbnailSpacing", "Master", 5, Configuration::Property::Flag::Standard )	\
 	OP( VeyonConfiguration, VeyonCore::config(), ComputerListModel::DisplayRoleContent, computerDisplayRoleContent, setComputerDisplayRoleContent, "ComputerDisplayRoleContent", "Master", QVariant::fromValue(ComputerListModel::DisplayRoleContent::UserAndComputerName), Configuration::Property::Flag::Standard )	\
@@ -147,6 +159,7 @@
 
 #define FOREACH_VEYON_AUTHENTICATION_CONFIG_PROPERTY(OP) \
 	OP( VeyonConfiguration, VeyonCore::config(), QStringList, enabledAuthenticationPlugins, setEnabledAuthenticationPlugins, "EnabledPlugins", "Authentication", QStringList(), Configuration::Property::Flag::Standard )	\
+	OP( VeyonConfiguration, VeyonCore::config(), int, authenticationTicketLifetime, setAuthenticationTicketLifetime, "TicketLifetime", "Authentication", 0, Configuration::Property::Flag::Advanced )	\
 
 #define FOREACH_VEYON_ACCESS_CONTROL_CONFIG_PROPERTY(OP)		\
 	OP( VeyonConfiguration, VeyonCore::config(), bool, isAccessRestrictedToUserGroups, setAccessRestrictedToUserGroups, "AccessRestrictedToUserGroups", "AccessControl", false , Configuration::Property::Flag::Standard )		\
@@ -239,9 +239,21 @@ int8_t VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSche
 		return false;
 	}
 
+	QByteArray authenticationTicket;
+	if( legacyAuth == false && authTypes.contains( AuthenticationManager::ticketAuthMethodUid() ) )
+	{
+		authenticationTicket = VeyonCore::authenticationManager().takeAuthenticationTicket(
+			connection->vncConnection()->serverAddress() );
+	}
+
 	VariantArrayMessage authReplyMessage( &socketDevice );
 
-	if( legacyAuth )
+	if( authenticationTicket.isEmpty() == false )
+	{
+		vDebug() << QThread::currentThreadId() << "presenting authentication ticket";
+		authReplyMessage.write( AuthenticationManager::ticketAuthMethodUid() );
+	}
+	else if( legacyAuth )
 	{
 		const auto legacyAuthType = VeyonCore::authenticationManager().toLegacyAuthType( chosenAuthPlugin );
 		vDebug() << QThread::currentThreadId() << "chose legacy authentication type:" << legacyAuthType;
@@ -259,6 +271,29 @@ int8_t VeyonConnection::handleSecTypeVeyon( rfbClient* client, uint32_t authSche
 	VariantArrayMessage authAckMessage( &socketDevice );
 	authAckMessage.receive();
 
+	if( authenticationTicket.isEmpty() == false )
+	{
+		// send ticket along with the method to fall back to if the server rejects the ticket
+		VariantArrayMessage ticketMessage( &socketDevice );
+		ticketMessage.write( authenticationTicket );
+		ticketMessage.write( chosenAuthPlugin );
+		ticketMessage.send();
+
+		VariantArrayMessage ticketReplyMessage( &socketDevice );
+		if( ticketReplyMessage.receive() == false )
+		{
+			vDebug() << QThread::currentThreadId() << "invalid authentication ticket reply received";
+			return false;
+		}
+
+		if( ticketReplyMessage.read().toBool() )
+		{
+			return TRUE;
+		}
+
+		vDebug() << QThread::currentThreadId() << "authentication ticket rejected, falling back to" << chosenAuthPlugin;
+	}
+
 	return plugins[chosenAuthPlugin]->authenticate( &socketDevice ) ? TRUE : FALSE;
 }
 
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QSize>
+
 #include "VeyonCore.h"
 
 class FeatureMessage;
@@ -50,4 +52,23 @@ public:
 
 	virtual void setMinimumFramebufferUpdateInterval(const MessageContext& context, int interval) = 0;
 
+	// returns whether continuous framebuffer updates are enabled for the connection afterwards
+	virtual bool setContinuousFramebufferUpdates(const MessageContext& context, bool enabled) = 0;
+
+	// returns the size of the downscaled framebuffer served to the connection or an empty size
+	// if the full framebuffer is served, an empty size disables downscaling
+	virtual QSize setThumbnailSize(const MessageContext& context, QSize size) = 0;
+
+	// limits the data rate of the connection by deferring framebuffer update requests, 0 disables the limit
+	virtual void setBandwidthLimit(const MessageContext& context, int bytesPerSecond) = 0;
+
+	// returns a ticket for a fast reconnect of the connection or an empty ticket if tickets are disabled
+	virtual QByteArray issueAuthenticationTicket(const MessageContext& context) = 0;
+
+	virtual int authenticationTicketLifetime() const = 0;
+
+	// makes the server send pending asynchronous feature messages to all clients, has to be called
+	// by feature providers whenever the state sent via sendAsyncFeatureMessages() has changed
+	virtual void notifyAsyncFeatureStateChanged() = 0;
+
 };
@@ -28,7 +28,8 @@ extern "C"
 #include "d3des.h"
 }
 
-#include <QBuffer>
+#include <limits>
+
 #include <QRegion>
 #include <QRegularExpression>
 #include <QTcpSocket>
@@ -82,6 +83,8 @@ VncClientProtocol::VncClientProtocol( QIODevice* socket, const Password& vncPass
 void VncClientProtocol::start()
 {
 	m_state = State::Protocol;
+
+	resetFramebufferUpdateParser();
 }
 
 
@@ -124,6 +127,9 @@ bool VncClientProtocol::setPixelFormat( rfbPixelFormat pixelFormat )
 	spf.format.greenMax = qFromBigEndian(pixelFormat.greenMax);
 	spf.format.blueMax = qFromBigEndian(pixelFormat.blueMax);
 
+	// all further updates are encoded using the new pixel format
+	m_pixelFormat = pixelFormat;
+
 	return m_socket->write( reinterpret_cast<const char *>( &spf ), sz_rfbSetPixelFormatMsg ) == sz_rfbSetPixelFormatMsg;
 }
 
@@ -179,11 +185,10 @@ void VncClientProtocol::requestFramebufferUpdate( bool incremental )
 
 bool VncClientProtocol::receiveMessage()
 {
-	if( m_socket->bytesAvailable() > MaximumMessageSize )
+	// continue receiving a framebuffer update which has not arrived completely so far
+	if( m_updateMessage.isEmpty() == false )
 	{
-		vCritical() << "Message too big or invalid";
-		m_socket->close();
-		return false;
+		return receiveFramebufferUpdateMessage();
 	}
 
 	uint8_t messageType = 0;
@@ -192,6 +197,15 @@ bool VncClientProtocol::receiveMessage()
 		return false;
 	}
 
+	// framebuffer updates are bounded per rect while being received so large updates
+	// of large framebuffers may be buffered completely
+	if( messageType != rfbFramebufferUpdate && m_socket->bytesAvailable() > MaximumMessageSize )
+	{
+		vCritical() << "Message too big or invalid";
+		m_socket->close();
+		return false;
+	}
+
 	switch( messageType )
 	{
 	case rfbFramebufferUpdate:
@@ -416,58 +430,87 @@ bool VncClientProtocol::receiveServerInitMessage()
 
 bool VncClientProtocol::receiveFramebufferUpdateMessage()
 {
-	// peek all available data and work on a local buffer so we can continously read from it
-	auto data = m_socket->peek( m_socket->bytesAvailable() );
-
-	QBuffer buffer( &data );
-	buffer.open( QBuffer::ReadOnly ); // Flawfinder: ignore
-
-	rfbFramebufferUpdateMsg message;
-	if( buffer.read( reinterpret_cast<char *>( &message ), sz_rfbFramebufferUpdateMsg ) != sz_rfbFramebufferUpdateMsg )
+	// data of the update is read from the socket step by step as it arrives so that each byte
+	// is received and parsed exactly once no matter in how many segments the update arrives
+	for(;;)
 	{
-		return false;
-	}
+		switch( m_updateParserStage )
+		{
+		case UpdateParserStage::Header:
+		{
+			if( receiveUpdateData( sz_rfbFramebufferUpdateMsg ) == false )
+			{
+				return false;
+			}
 
-	QRegion updatedRegion;
+			rfbFramebufferUpdateMsg message;
+			memcpy( &message, updateData(), sz_rfbFramebufferUpdateMsg ); // Flawfinder: ignore
+			m_updateParserPosition += sz_rfbFramebufferUpdateMsg;
 
-	const auto nRects = qFromBigEndian( message.nRects );
+			m_updateRectCount = qFromBigEndian( message.nRects );
+			m_updateRectIndex = 0;
+			m_updateRects.clear();
+			m_updatedRegion = {};
+			m_updateParserStage = UpdateParserStage::RectHeader;
+			break;
+		}
 
-	for( int i = 0; i < nRects; ++i )
-	{
-		rfbFramebufferUpdateRectHeader rectHeader;
-		if( buffer.read( reinterpret_cast<char *>( &rectHeader ), sz_rfbFramebufferUpdateRectHeader ) != sz_rfbFramebufferUpdateRectHeader )
+		case UpdateParserStage::RectHeader:
 		{
-			return false;
-		}
+			if( m_updateRectIndex >= m_updateRectCount )
+			{
+				return finishFramebufferUpdate();
+			}
 
-		rectHeader.encoding = qFromBigEndian( rectHeader.encoding );
-		rectHeader.r.w = qFromBigEndian( rectHeader.r.w );
-		rectHeader.r.h = qFromBigEndian( rectHeader.r.h );
-		rectHeader.r.x = qFromBigEndian( rectHeader.r.x );
-		rectHeader.r.y = qFromBigEndian( rectHeader.r.y );
+			if( receiveUpdateData( sz_rfbFramebufferUpdateRectHeader ) == false )
+			{
+				return false;
+			}
 
-		if( rectHeader.encoding == rfbEncodingLastRect )
-		{
+			auto& rectHeader = m_updateRectHeader;
+			memcpy( &rectHeader, updateData(), sz_rfbFramebufferUpdateRectHeader ); // Flawfinder: ignore
+			m_updateParserPosition += sz_rfbFramebufferUpdateRectHeader;
+
+			rectHeader.encoding = qFromBigEndian( rectHeader.encoding );
+			rectHeader.r.w = qFromBigEndian( rectHeader.r.w );
+			rectHeader.r.h = qFromBigEndian( rectHeader.r.h );
+			rectHeader.r.x = qFromBigEndian( rectHeader.r.x );
+			rectHeader.r.y = qFromBigEndian( rectHeader.r.y );
+
+			if( rectHeader.encoding == rfbEncodingLastRect )
+			{
+				return finishFramebufferUpdate();
+			}
+
+			m_updateRectDataOffset = m_updateParserPosition;
+			m_hextileX = rectHeader.r.x;
+			m_hextileY = rectHeader.r.y;
+			m_updateParserStage = UpdateParserStage::RectData;
 			break;
 		}
 
-		if( handleRect( buffer, rectHeader ) == false )
+		case UpdateParserStage::RectData:
 		{
-			return false;
-		}
+			switch( handleRect( m_updateRectHeader ) )
+			{
+			case ParseResult::Incomplete:
+				return false;
+			case ParseResult::Invalid:
+				resetFramebufferUpdateParser();
+				m_socket->close();
+				return false;
+			case ParseResult::Complete:
+				break;
+			}
 
-		if( isPseudoEncoding( rectHeader ) == false &&
-			rectHeader.r.x+rectHeader.r.w <= m_framebufferWidth &&
-			rectHeader.r.y+rectHeader.r.h <= m_framebufferHeight )
-		{
-			updatedRegion += QRect( rectHeader.r.x, rectHeader.r.y, rectHeader.r.w, rectHeader.r.h );
+			finishRect( m_updateRectHeader );
+
+			++m_updateRectIndex;
+			m_updateParserStage = UpdateParserStage::RectHeader;
+			break;
+		}
 		}
 	}
-
-	m_lastUpdatedRect = updatedRegion.boundingRect();
-
-	// save as much data as we read by processing rects
-	return readMessage( static_cast<int>( buffer.pos() ) );
 }
 
 
@@ -550,277 +593,340 @@ bool VncClientProtocol::readMessage( int size )
 
 
 
-bool VncClientProtocol::handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHeader rectHeader )
+bool VncClientProtocol::receiveUpdateData( qint64 size )
+{
+	const auto missing = m_updateParserPosition + size - m_updateMessage.size();
+	if( missing <= 0 )
+	{
+		return true;
+	}
+
+	const auto count = qMin( missing, m_socket->bytesAvailable() );
+	if( count <= 0 )
+	{
+		return false;
+	}
+
+	const auto oldSize = m_updateMessage.size();
+	m_updateMessage.resize( int( oldSize + count ) );
+
+	const auto received = m_socket->read( m_updateMessage.data() + oldSize, count ); // Flawfinder: ignore
+	if( received < count )
+	{
+		m_updateMessage.resize( int( oldSize + qMax<qint64>( received, 0 ) ) );
+		return false;
+	}
+
+	return count == missing;
+}
+
+
+
+void VncClientProtocol::finishRect( const rfbFramebufferUpdateRectHeader& rectHeader )
+{
+	m_updateRects.append( { rectHeader, m_updateRectDataOffset, m_updateParserPosition - m_updateRectDataOffset } );
+
+	// the y coordinate of ExtDesktopSize rects carries an error status for rejected size changes
+	if( rectHeader.encoding == rfbEncodingNewFBSize ||
+		( rectHeader.encoding == rfbEncodingExtDesktopSize && rectHeader.r.y == 0 ) )
+	{
+		m_framebufferWidth = rectHeader.r.w;
+		m_framebufferHeight = rectHeader.r.h;
+	}
+
+	if( isPseudoEncoding( rectHeader ) == false &&
+		rectHeader.r.x+rectHeader.r.w <= m_framebufferWidth &&
+		rectHeader.r.y+rectHeader.r.h <= m_framebufferHeight )
+	{
+		m_updatedRegion += QRect( rectHeader.r.x, rectHeader.r.y, rectHeader.r.w, rectHeader.r.h );
+	}
+}
+
+
+
+bool VncClientProtocol::finishFramebufferUpdate()
+{
+	m_updateMessage.truncate( m_updateParserPosition );
+
+	m_lastMessage = std::move( m_updateMessage );
+	m_lastRects = std::move( m_updateRects );
+	m_lastUpdatedRect = m_updatedRegion.boundingRect();
+
+	resetFramebufferUpdateParser();
+
+	return true;
+}
+
+
+
+void VncClientProtocol::resetFramebufferUpdateParser()
 {
-	const uint width = rectHeader.r.w;
-	const uint height = rectHeader.r.h;
+	m_updateParserStage = UpdateParserStage::Header;
+	m_updateParserPosition = 0;
+	m_updateMessage = {};
+	m_updateRects = {};
+	m_updatedRegion = {};
+}
+
 
-	const uint bytesPerPixel = m_pixelFormat.bitsPerPixel / 8;
-	const uint bytesPerRow = ( width + 7 ) / 8;
+
+VncClientProtocol::ParseResult VncClientProtocol::receiveRectData( qint64 size )
+{
+	// bound each rect by its raw size plus some margin for encoding overhead so that full updates
+	// of large framebuffers are accepted while bogus data lengths are rejected early
+	const auto& rect = m_updateRectHeader.r;
+	const auto maximumRectDataSize = MaximumMessageSize + qint64(rect.w) * qint64(rect.h) * ( m_pixelFormat.bitsPerPixel / 8 );
+
+	if( size < 0 ||
+		m_updateParserPosition - m_updateRectDataOffset + size > maximumRectDataSize ||
+		m_updateParserPosition + size > std::numeric_limits<int>::max() )
+	{
+		return ParseResult::Invalid;
+	}
+
+	if( receiveUpdateData( size ) == false )
+	{
+		return ParseResult::Incomplete;
+	}
+
+	m_updateParserPosition += int(size);
+
+	return ParseResult::Complete;
+}
+
+
+
+VncClientProtocol::ParseResult VncClientProtocol::handleRect( const rfbFramebufferUpdateRectHeader& rectHeader )
+{
+	const qint64 width = rectHeader.r.w;
+	const qint64 height = rectHeader.r.h;
+
+	const qint64 bytesPerPixel = m_pixelFormat.bitsPerPixel / 8;
+	const qint64 bytesPerRow = ( width + 7 ) / 8;
 
 	switch( rectHeader.encoding )
 	{
 	case rfbEncodingLastRect:
-		return true;
+		return ParseResult::Complete;
 
 	case rfbEncodingXCursor:
-		return width * height == 0 ||
-				( buffer.read( sz_rfbXCursorColors ).size() == sz_rfbXCursorColors &&
-				  buffer.read( size_t(2) * bytesPerRow * height ).size() == static_cast<int>( 2 * bytesPerRow * height ) );
+		return width * height == 0 ? ParseResult::Complete :
+									 receiveRectData( sz_rfbXCursorColors + 2 * bytesPerRow * height );
 
 	case rfbEncodingRichCursor:
-		return width * height == 0 ||
-				( buffer.read( size_t(width) * height * bytesPerPixel ).size() == static_cast<int>( width * height * bytesPerPixel ) &&
-				  buffer.read( size_t(bytesPerRow) * height ).size() == static_cast<int>( bytesPerRow * height ) );
+		return width * height == 0 ? ParseResult::Complete :
+									 receiveRectData( width * height * bytesPerPixel + bytesPerRow * height );
 
 	case rfbEncodingSupportedMessages:
-		return buffer.read( sz_rfbSupportedMessages ).size() == sz_rfbSupportedMessages;
+		return receiveRectData( sz_rfbSupportedMessages );
 
 	case rfbEncodingSupportedEncodings:
 	case rfbEncodingServerIdentity:
 		// width = byte count
-		return buffer.read( width ).size() == static_cast<int>( width );
+		return receiveRectData( width );
 
 	case rfbEncodingRaw:
-		return buffer.read( size_t(width) * height * bytesPerPixel ).size() == static_cast<int>( width * height * bytesPerPixel );
+		return receiveRectData( width * height * bytesPerPixel );
 
 	case rfbEncodingCopyRect:
-		return buffer.read( sz_rfbCopyRect ).size() == sz_rfbCopyRect;
+		return receiveRectData( sz_rfbCopyRect );
 
 	case rfbEncodingRRE:
-		return handleRectEncodingRRE( buffer, bytesPerPixel );
+		return handleRectEncodingRRE( bytesPerPixel, sz_rfbRectangle );
 
 	case rfbEncodingCoRRE:
-		return handleRectEncodingCoRRE( buffer, bytesPerPixel );
+		return handleRectEncodingRRE( bytesPerPixel, 4 );
 
 	case rfbEncodingHextile:
-		return handleRectEncodingHextile( buffer, rectHeader, bytesPerPixel );
+		return handleRectEncodingHextile( rectHeader, bytesPerPixel );
 
 	case rfbEncodingUltra:
 	case rfbEncodingUltraZip:
 	case rfbEncodingZlib:
-		return handleRectEncodingZlib( buffer );
-
 	case rfbEncodingZRLE:
 	case rfbEncodingZYWRLE:
-		return handleRectEncodingZRLE( buffer );
+		// rfbZlibHeader and rfbZRLEHeader both only consist of the length of the following data
+		return handleRectEncodingZlib();
 
 	case rfbEncodingTight:
-		return handleRectEncodingTight(buffer, rectHeader);
+		return handleRectEncodingTight( rectHeader );
 
 	case rfbEncodingExtDesktopSize:
-		return handleRectEncodingExtDesktopSize(buffer);
+		return handleRectEncodingExtDesktopSize();
 
 	case rfbEncodingPointerPos:
 	case rfbEncodingKeyboardLedState:
 	case rfbEncodingNewFBSize:
 		// no further data to read for this rect
-		return true;
+		return ParseResult::Complete;
 
 	default:
 		vCritical() << "Unsupported rect encoding" << rectHeader.encoding;
-		m_socket->close();
 		break;
 	}
 
-	return false;
+	return ParseResult::Invalid;
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingRRE( QBuffer& buffer, uint bytesPerPixel )
+VncClientProtocol::ParseResult VncClientProtocol::handleRectEncodingRRE( qint64 bytesPerPixel, qint64 subrectSize )
 {
-	rfbRREHeader hdr;
-
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbRREHeader ) != sz_rfbRREHeader )
+	if( receiveUpdateData( sz_rfbRREHeader ) == false )
 	{
-		return false;
+		return ParseResult::Incomplete;
 	}
 
-	const auto rectDataSize = qFromBigEndian( hdr.nSubrects ) * ( bytesPerPixel + sz_rfbRectangle );
-	const auto totalDataSize = static_cast<int>( bytesPerPixel + rectDataSize );
-
-	return totalDataSize < MaxMessageSize && buffer.read( totalDataSize ).size() == totalDataSize;
-}
-
-
-
-bool VncClientProtocol::handleRectEncodingCoRRE( QBuffer& buffer, uint bytesPerPixel )
-{
 	rfbRREHeader hdr;
+	memcpy( &hdr, updateData(), sz_rfbRREHeader ); // Flawfinder: ignore
 
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbRREHeader ) != sz_rfbRREHeader )
-	{
-		return false;
-	}
-
-	const auto rectDataSize = qFromBigEndian( hdr.nSubrects ) * ( bytesPerPixel + 4 );
-	const auto totalDataSize = static_cast<int>( bytesPerPixel + rectDataSize );
-
-	return totalDataSize < MaxMessageSize && buffer.read( totalDataSize ).size() == totalDataSize;
-
+	// background pixel followed by the subrects
+	return receiveRectData( sz_rfbRREHeader + bytesPerPixel + qFromBigEndian( hdr.nSubrects ) * ( bytesPerPixel + subrectSize ) );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingHextile( QBuffer& buffer,
-													const rfbFramebufferUpdateRectHeader rectHeader,
-													uint bytesPerPixel )
+VncClientProtocol::ParseResult VncClientProtocol::handleRectEncodingHextile( const rfbFramebufferUpdateRectHeader& rectHeader,
+																			 qint64 bytesPerPixel )
 {
 	const uint rx = rectHeader.r.x;
 	const uint ry = rectHeader.r.y;
 	const uint rw = rectHeader.r.w;
 	const uint rh = rectHeader.r.h;
 
-	for( uint y = ry; y < ry+rh; y += 16 )
+	// parse tile by tile and continue with the current tile when more data arrives
+	while( m_hextileY < ry+rh && rw > 0 )
 	{
-		for( uint x = rx; x < rx+rw; x += 16 )
+		const qint64 w = qMin<uint>( 16, rx+rw - m_hextileX );
+		const qint64 h = qMin<uint>( 16, ry+rh - m_hextileY );
+
+		if( receiveUpdateData( 1 ) == false )
 		{
-			uint w = 16;
-			uint h = 16;
-			if( rx+rw - x < 16 )
-			{
-				w = rx+rw - x;
-			}
-			if( ry+rh - y < 16 )
-			{
-				h = ry+rh - y;
-			}
+			return ParseResult::Incomplete;
+		}
 
-			uint8_t subEncoding = 0;
-			if( buffer.read( reinterpret_cast<char *>( &subEncoding ), 1 ) != 1 )
-			{
-				return false;
-			}
+		const auto subEncoding = uint8_t( updateData()[0] );
 
-			if( subEncoding & rfbHextileRaw )
-			{
-				const auto dataSize = static_cast<int>( w * h * bytesPerPixel );
-				if( buffer.read( dataSize ).size() != dataSize )
-				{
-					return false;
-				}
-				continue;
-			}
+		qint64 tileSize = 1;
 
+		if( subEncoding & rfbHextileRaw )
+		{
+			tileSize += w * h * bytesPerPixel;
+		}
+		else
+		{
 			if( subEncoding & rfbHextileBackgroundSpecified )
 			{
-				if( buffer.read( bytesPerPixel ).size() != static_cast<int>( bytesPerPixel ) )
-				{
-					return false;
-				}
+				tileSize += bytesPerPixel;
 			}
 
 			if( subEncoding & rfbHextileForegroundSpecified )
 			{
-				if( buffer.read( bytesPerPixel ).size() != static_cast<int>( bytesPerPixel ) )
-				{
-					return false;
-				}
+				tileSize += bytesPerPixel;
 			}
 
-			if( !( subEncoding & rfbHextileAnySubrects ) )
+			if( subEncoding & rfbHextileAnySubrects )
 			{
-				continue;
-			}
+				// number of subrects
+				tileSize += 1;
 
-			uint8_t nSubrects = 0;
-			if( buffer.read( reinterpret_cast<char *>( &nSubrects ), 1 ) != 1 )
-			{
-				return false;
-			}
+				if( receiveUpdateData( tileSize ) == false )
+				{
+					return ParseResult::Incomplete;
+				}
 
-			int subRectDataSize = 0;
+				const qint64 nSubrects = uint8_t( updateData()[tileSize-1] );
 
-			if( subEncoding & rfbHextileSubrectsColoured )
-			{
-				subRectDataSize = static_cast<int>( nSubrects * ( 2 + bytesPerPixel ) );
-			}
-			else
-			{
-				subRectDataSize = nSubrects * 2;
-			}
-
-			if( buffer.read( subRectDataSize ).size() != subRectDataSize )
-			{
-				return false;
+				if( subEncoding & rfbHextileSubrectsColoured )
+				{
+					tileSize += nSubrects * ( 2 + bytesPerPixel );
+				}
+				else
+				{
+					tileSize += nSubrects * 2;
+				}
 			}
 		}
-	}
-
-	return true;
-}
-
 
+		if( const auto result = receiveRectData( tileSize ); result != ParseResult::Complete )
+		{
+			return result;
+		}
 
-bool VncClientProtocol::handleRectEncodingZlib( QBuffer& buffer )
-{
-	rfbZlibHeader hdr;
-
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbZlibHeader ) != sz_rfbZlibHeader )
-	{
-		return false;
+		m_hextileX += 16;
+		if( m_hextileX >= rx+rw )
+		{
+			m_hextileX = rx;
+			m_hextileY += 16;
+		}
 	}
 
-	const auto n = qFromBigEndian( hdr.nBytes );
-
-	return n < MaxMessageSize && uint32_t(buffer.read(n).size()) == n;
+	return ParseResult::Complete;
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingZRLE(QBuffer &buffer)
+VncClientProtocol::ParseResult VncClientProtocol::handleRectEncodingZlib()
 {
-	rfbZRLEHeader hdr;
-
-	if( buffer.read( reinterpret_cast<char *>( &hdr ), sz_rfbZRLEHeader ) != sz_rfbZRLEHeader )
+	if( receiveUpdateData( sz_rfbZlibHeader ) == false )
 	{
-		return false;
+		return ParseResult::Incomplete;
 	}
 
-	const auto n = qFromBigEndian( hdr.length );
+	rfbZlibHeader hdr;
+	memcpy( &hdr, updateData(), sz_rfbZlibHeader ); // Flawfinder: ignore
 
-	return n < MaxMessageSize && uint32_t(buffer.read(n).size()) == n;
+	return receiveRectData( sz_rfbZlibHeader + qint64( qFromBigEndian( hdr.nBytes ) ) );
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
-												const rfbFramebufferUpdateRectHeader rectHeader)
+VncClientProtocol::ParseResult VncClientProtocol::handleRectEncodingTight( const rfbFramebufferUpdateRectHeader& rectHeader )
 {
-	static const auto readCompactLength = [](QBuffer& buffer) -> int64_t
-	{
-		int64_t len;
-		uint8_t b;
+	// all fields preceding the (compressed) pixel data are small, so they are simply parsed
+	// again from the beginning of the rect whenever more data has arrived
+	qint64 offset = 0;
+
+	const auto readByte = [this, &offset]( uint8_t& value ) {
+		if( receiveUpdateData( offset+1 ) == false )
+		{
+			return false;
+		}
+		value = uint8_t( updateData()[offset] );
+		++offset;
+		return true;
+	};
 
-		if (buffer.read(reinterpret_cast<char *>(&b), 1 ) != 1)
+	const auto readCompactLength = [&readByte]( qint64& length ) {
+		uint8_t b = 0;
+		if( readByte( b ) == false )
 		{
-			return -1;
+			return false;
 		}
 
-		len = int(b) & 0x7f;
+		length = b & 0x7f;
 
-		if (b & 0x80)
+		if( b & 0x80 )
 		{
-			if (buffer.read(reinterpret_cast<char *>(&b), 1) != 1)
+			if( readByte( b ) == false )
 			{
-				return -1;
+				return false;
 			}
 
-			len |= (int(b) & 0x7f) << 7;
+			length |= ( b & 0x7f ) << 7;
 
-			if (b & 0x80)
+			if( b & 0x80 )
 			{
-				if (buffer.read(reinterpret_cast<char *>(&b), 1) != 1)
+				if( readByte( b ) == false )
 				{
-					return -1;
+					return false;
 				}
 
-				len |= (int(b) & 0xff) << 14;
+				length |= ( b & 0xff ) << 14;
 			}
 		}
 
-		return len;
+		return true;
 	};
 
 	auto bitsPerPixel = m_pixelFormat.bitsPerPixel;
@@ -833,12 +939,12 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 		bitsPerPixel = 24;
 	}
 
-	const auto bytesPerPixel = bitsPerPixel / 8;
+	const qint64 bytesPerPixel = bitsPerPixel / 8;
 
 	uint8_t compCtl = 255;
-	if (buffer.read(reinterpret_cast<char *>(&compCtl), 1) != 1)
+	if (readByte(compCtl) == false)
 	{
-		return false;
+		return ParseResult::Incomplete;
 	}
 
 	compCtl >>= 4; // ignore compression stream reset bits
@@ -850,27 +956,31 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 
 	if (compCtl == rfbTightFill)
 	{
-		return buffer.read(bytesPerPixel).size() == bytesPerPixel;
+		return receiveRectData(offset + bytesPerPixel);
 	}
 
 	if (compCtl == rfbTightJpeg)
 	{
-		const auto dataLength = readCompactLength(buffer);
-		return buffer.read(dataLength).size() == dataLength;
+		qint64 dataLength = 0;
+		if (readCompactLength(dataLength) == false)
+		{
+			return ParseResult::Incomplete;
+		}
+		return receiveRectData(offset + dataLength);
 	}
 
 	if (compCtl > rfbTightMaxSubencoding)
 	{
 		vWarning() << "bad subencoding value received";
-		return false;
+		return ParseResult::Invalid;
 	}
 
 	if (compCtl & rfbTightExplicitFilter)
 	{
 		uint8_t filterId = 0;
-		if (buffer.read(reinterpret_cast<char *>(&filterId), 1) != 1)
+		if (readByte(filterId) == false)
 		{
-			return false;
+			return ParseResult::Incomplete;
 		}
 
 		switch (filterId)
@@ -879,21 +989,17 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 			break;
 		case rfbTightFilterPalette:
 		{
-			uint8_t numColors;
-			if (buffer.read(reinterpret_cast<char *>(&numColors), 1) != 1)
+			uint8_t numColors = 0;
+			if (readByte(numColors) == false)
 			{
-				return false;
+				return ParseResult::Incomplete;
 			}
 			const auto tightRectColors = numColors + 1;
 			if (tightRectColors < 2)
 			{
-				return false;
-			}
-			const auto rectBytes = tightRectColors * bytesPerPixel;
-			if (buffer.read(rectBytes).size() != rectBytes)
-			{
-				return false;
+				return ParseResult::Invalid;
 			}
+			offset += tightRectColors * bytesPerPixel;
 			bitsPerPixel = tightRectColors == 2 ? 1 : 8;
 			break;
 		}
@@ -901,46 +1007,47 @@ bool VncClientProtocol::handleRectEncodingTight(QBuffer& buffer,
 			break;
 		default:
 			vWarning() << "invalid filter ID";
-			return false;
+			return ParseResult::Invalid;
 		}
 	}
 
 	const int MaximumUncompressedSize = 12;
 
-	const int rowSize = (rectHeader.r.w * bitsPerPixel + 7) / 8;
-	const int uncompressedRectSize = rectHeader.r.h * rowSize;
+	const qint64 rowSize = (rectHeader.r.w * bitsPerPixel + 7) / 8;
+	const qint64 uncompressedRectSize = rectHeader.r.h * rowSize;
 	if (uncompressedRectSize < MaximumUncompressedSize)
 	{
-		return buffer.read(uncompressedRectSize).size() == uncompressedRectSize;
+		return receiveRectData(offset + uncompressedRectSize);
+	}
+
+	qint64 compressedLength = 0;
+	if (readCompactLength(compressedLength) == false)
+	{
+		return ParseResult::Incomplete;
 	}
 
-	const auto compressedLength = readCompactLength(buffer);
 	if (compressedLength <= 0)
 	{
 		vWarning() << "bad compressed length received";
-		return false;
+		return ParseResult::Invalid;
 	}
 
-	return buffer.read(compressedLength).size() == compressedLength;
+	return receiveRectData(offset + compressedLength);
 }
 
 
 
-bool VncClientProtocol::handleRectEncodingExtDesktopSize(QBuffer& buffer)
+VncClientProtocol::ParseResult VncClientProtocol::handleRectEncodingExtDesktopSize()
 {
-	rfbExtDesktopSizeMsg extDesktopSizeMsg;
-	if (buffer.peek(reinterpret_cast<char *>(&extDesktopSizeMsg), sz_rfbExtDesktopSizeMsg) != sz_rfbExtDesktopSizeMsg)
+	if (receiveUpdateData(sz_rfbExtDesktopSizeMsg) == false)
 	{
-		return false;
+		return ParseResult::Incomplete;
 	}
 
-	const auto totalMessageSize = sz_rfbExtDesktopSizeMsg + extDesktopSizeMsg.numberOfScreens * sz_rfbExtDesktopScreen;
-	if (buffer.bytesAvailable() >= totalMessageSize)
-	{
-		return buffer.read(totalMessageSize).size() == totalMessageSize;
-	}
+	rfbExtDesktopSizeMsg extDesktopSizeMsg;
+	memcpy(&extDesktopSizeMsg, updateData(), sz_rfbExtDesktopSizeMsg); // Flawfinder: ignore
 
-	return false;
+	return receiveRectData(sz_rfbExtDesktopSizeMsg + extDesktopSizeMsg.numberOfScreens * sz_rfbExtDesktopScreen);
 }
 
 
@@ -27,10 +27,11 @@
 #include "rfb/rfbproto.h"
 
 #include <QRect>
+#include <QRegion>
+#include <QVector>
 
 #include "CryptoCore.h"
 
-class QBuffer;
 class QIODevice;
 
 class VEYON_CORE_EXPORT VncClientProtocol
@@ -38,6 +39,14 @@ class VEYON_CORE_EXPORT VncClientProtocol
 public:
 	using Password = CryptoCore::PlaintextPassword;
 
+	// rectangle of the last framebuffer update message with its data located in lastMessage()
+	struct Rect
+	{
+		rfbFramebufferUpdateRectHeader header;
+		int dataOffset;
+		int dataSize;
+	};
+
 	enum class State
 	{
 		Disconnected,
@@ -75,6 +84,11 @@ public:
 		return m_framebufferHeight;
 	}
 
+	const rfbPixelFormat& pixelFormat() const
+	{
+		return m_pixelFormat;
+	}
+
 	bool setPixelFormat( rfbPixelFormat pixelFormat );
 	bool setEncodings( const QVector<uint32_t>& encodings );
 
@@ -97,15 +111,24 @@ public:
 		return m_lastUpdatedRect;
 	}
 
+	const QVector<Rect>& lastRects() const
+	{
+		return m_lastRects;
+	}
+
 protected:
 	void setState(State state)
 	{
 		m_state = state;
 	}
 
-private:
-	static constexpr auto MaxMessageSize = 64*1024*1024;
+	// changes the pixel format framebuffer updates are parsed with without sending it to the server
+	void updatePixelFormat( const rfbPixelFormat& pixelFormat )
+	{
+		m_pixelFormat = pixelFormat;
+	}
 
+private:
 	bool readProtocol();
 	bool receiveSecurityTypes();
 	bool receiveSecurityChallenge();
@@ -121,17 +144,37 @@ private:
 
 	bool readMessage( int size );
 
-	bool handleRect( QBuffer& buffer, rfbFramebufferUpdateRectHeader rectHeader );
-	bool handleRectEncodingRRE( QBuffer& buffer, uint bytesPerPixel );
-	bool handleRectEncodingCoRRE( QBuffer& buffer, uint bytesPerPixel );
-	bool handleRectEncodingHextile( QBuffer& buffer,
-									const rfbFramebufferUpdateRectHeader rectHeader,
-									uint bytesPerPixel );
-	bool handleRectEncodingZlib( QBuffer& buffer );
-	bool handleRectEncodingZRLE( QBuffer& buffer );
-	bool handleRectEncodingTight(QBuffer& buffer,
-								 const rfbFramebufferUpdateRectHeader rectHeader);
-	bool handleRectEncodingExtDesktopSize(QBuffer& buffer);
+	enum class UpdateParserStage
+	{
+		Header,
+		RectHeader,
+		RectData
+	} ;
+
+	enum class ParseResult
+	{
+		Incomplete,
+		Complete,
+		Invalid
+	} ;
+
+	bool receiveUpdateData( qint64 size );
+	const char* updateData() const
+	{
+		return m_updateMessage.constData() + m_updateParserPosition;
+	}
+
+	void finishRect( const rfbFramebufferUpdateRectHeader& rectHeader );
+	bool finishFramebufferUpdate();
+	void resetFramebufferUpdateParser();
+
+	ParseResult receiveRectData( qint64 size );
+	ParseResult handleRect( const rfbFramebufferUpdateRectHeader& rectHeader );
+	ParseResult handleRectEncodingRRE( qint64 bytesPerPixel, qint64 subrectSize );
+	ParseResult handleRectEncodingHextile( const rfbFramebufferUpdateRectHeader& rectHeader, qint64 bytesPerPixel );
+	ParseResult handleRectEncodingZlib();
+	ParseResult handleRectEncodingTight( const rfbFramebufferUpdateRectHeader& rectHeader );
+	ParseResult handleRectEncodingExtDesktopSize();
 
 	static bool isPseudoEncoding( rfbFramebufferUpdateRectHeader header );
 
@@ -151,5 +194,19 @@ private:
 
 	QByteArray m_lastMessage;
 	QRect m_lastUpdatedRect;
+	QVector<Rect> m_lastRects;
+
+	// state of the framebuffer update currently being received
+	UpdateParserStage m_updateParserStage{UpdateParserStage::Header};
+	QByteArray m_updateMessage;
+	int m_updateParserPosition{0};
+	int m_updateRectCount{0};
+	int m_updateRectIndex{0};
+	int m_updateRectDataOffset{0};
+	rfbFramebufferUpdateRectHeader m_updateRectHeader{};
+	uint m_hextileX{0};
+	uint m_hextileY{0};
+	QVector<Rect> m_updateRects;
+	QRegion m_updatedRegion;
 
 } ;
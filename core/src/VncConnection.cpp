@@ -27,17 +27,23 @@
 
 #include <rfb/rfbclient.h>
 
-#include <QBitmap>
 #include <QHostAddress>
 #include <QMutexLocker>
 #include <QPixmap>
 #include <QRegularExpression>
 #include <QSslSocket>
+#include <QThreadPool>
 #include <QTime>
+#include <QtConcurrent>
+#include <QtMath>
 
+#include "FramebufferScaler.h"
 #include "PlatformNetworkFunctions.h"
 #include "VeyonConfiguration.h"
 #include "VncConnection.h"
+#include "VncConnectionReactor.h"
+#include "VncConnectionScheduler.h"
+#include "VncCursorShapeCache.h"
 #include "RfbClientCallback.h"
 #include "SocketDevice.h"
 #include "VncEvents.h"
@@ -45,6 +51,15 @@
 
 VncConnection::RfbLogMessageReader VncConnection::s_rfbLogMessageReader = [](const QByteArray&) { };
 
+
+static QThreadPool* scaledFramebufferThreadPool()
+{
+	// separate pool so that rescaling does not compete with other QtConcurrent jobs
+	static QThreadPool threadPool;
+	return &threadPool;
+}
+
+
 VncConnection::VncConnection( QObject* parent ) :
 	QThread( parent ),
 	m_verifyServerCertificate( VeyonCore::config().tlsUseCertificateAuthority() ),
@@ -62,13 +77,19 @@ VncConnection::VncConnection( QObject* parent ) :
 		m_socketKeepaliveIdleTime = VeyonCore::config().vncConnectionSocketKeepaliveIdleTime();
 		m_socketKeepaliveInterval = VeyonCore::config().vncConnectionSocketKeepaliveInterval();
 		m_socketKeepaliveCount = VeyonCore::config().vncConnectionSocketKeepaliveCount();
+		m_framebufferUpdatesInFlight = VeyonCore::config().vncConnectionFramebufferUpdatesInFlight();
 	}
+
+	m_reactor = VncConnectionReactor::instance();
+	m_scheduler = VncConnectionScheduler::instance();
 }
 
 
 
 VncConnection::~VncConnection()
 {
+	m_scaledFramebufferUpdate.waitForFinished();
+
 	if( isRunning() )
 	{
 		vWarning() << "Waiting for VNC connection thread to finish.";
@@ -128,18 +149,20 @@ void VncConnection::stop()
 {
 	setClientData( VncConnectionTag, nullptr );
 
+	m_scaledFramebufferMutex.lock();
 	m_scaledFramebuffer = {};
+	m_scaledFramebufferMutex.unlock();
 
 	setControlFlag( ControlFlag::TerminateThread, true );
 
-	m_updateIntervalSleeper.wakeAll();
+	wakeUp();
 }
 
 
 
 void VncConnection::stopAndDeleteLater()
 {
-	if( isRunning() )
+	if( isRunning() || m_reactorThread.load() )
 	{
 		setControlFlag( ControlFlag::DeleteAfterFinished, true );
 		stop();
@@ -205,15 +228,26 @@ void VncConnection::setPort( int port )
 
 
 
-void VncConnection::setQuality(VncConnectionConfiguration::Quality quality)
+void VncConnection::setQuality(VncConnectionConfiguration::Quality quality,
+							   VncConnectionConfiguration::Quality minimumQuality)
 {
 	m_quality = quality;
+	m_minimumQuality = minimumQuality;
 
-	if (m_client)
-	{
-		updateEncodingSettingsFromQuality();
-		enqueueEvent(new VncUpdateFormatAndEncodingsEvent);
-	}
+	// encoding settings are owned by the thread serving the connection
+	setControlFlag(ControlFlag::QualityChanged, true);
+	wakeUp();
+}
+
+
+
+void VncConnection::setReducedColorDepth( bool enabled )
+{
+	m_reducedColorDepth = enabled;
+
+	// pixel format is changed by the thread serving the connection after the next update
+	setControlFlag(ControlFlag::QualityChanged, true);
+	wakeUp();
 }
 
 
@@ -243,34 +277,60 @@ void VncConnection::enqueueEvent(VncEvent* event)
 {
 	if( state() != State::Connected )
 	{
+		delete event;
 		return;
 	}
 
-	m_eventQueueMutex.lock();
-	m_eventQueue.enqueue( event );
-	m_eventQueueMutex.unlock();
-
-	m_updateIntervalSleeper.wakeAll();
+	m_eventQueue.enqueueEvent( event );
+	wakeUp();
 }
 
 
 
-bool VncConnection::isEventQueueEmpty()
+bool VncConnection::isEventQueueEmpty() const
 {
-	QMutexLocker lock( &m_eventQueueMutex );
 	return m_eventQueue.isEmpty();
 }
 
 
 
-void VncConnection::setScaledSize( QSize s )
+VncConnection::Statistics VncConnection::statistics() const
 {
-	QMutexLocker globalLock( &m_globalMutex );
+	QMutexLocker locker( &m_statisticsMutex );
 
-	if( m_scaledSize != s )
+	auto statistics = m_statistics;
+	statistics.bytesReceived = m_bytesReceived;
+	statistics.bytesSent = m_bytesSent;
+	statistics.socketWrites = m_socketWrites;
+	statistics.socketFlushes = m_socketFlushes;
+	statistics.eventQueue = m_eventQueue.statistics();
+
+	// rates are only refreshed with framebuffer updates so don't report stale values for idle connections
+	if( m_statisticsTimer.isValid() == false || m_statisticsTimer.elapsed() > 2 * StatisticsInterval )
+	{
+		statistics.framebufferUpdateRate = 0;
+		statistics.receiveRate = 0;
+	}
+
+	return statistics;
+}
+
+
+
+void VncConnection::setScaledSize( QSize s )
+{
+	m_scaledFramebufferMutex.lock();
+	const auto changed = m_scaledSize != s;
+	if( changed )
 	{
 		m_scaledSize = s;
-		setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, true );
+		m_fullRescaleRequired = true;
+	}
+	m_scaledFramebufferMutex.unlock();
+
+	if( changed )
+	{
+		rescaleFramebuffer();
 	}
 }
 
@@ -278,7 +338,17 @@ void VncConnection::setScaledSize( QSize s )
 
 QImage VncConnection::scaledFramebuffer()
 {
-	rescaleFramebuffer();
+	if( hasValidFramebuffer() == false )
+	{
+		return {};
+	}
+
+	QMutexLocker locker( &m_scaledFramebufferMutex );
+	if( m_scaledSize.isNull() )
+	{
+		return {};
+	}
+
 	return m_scaledFramebuffer;
 }
 
@@ -293,34 +363,28 @@ void VncConnection::setFramebufferUpdateInterval( int interval )
 		setControlFlag(ControlFlag::TriggerFramebufferUpdate, true);
 	}
 
-	m_updateIntervalSleeper.wakeAll();
+	wakeUp();
 }
 
 
 
 void VncConnection::rescaleFramebuffer()
 {
-	if( hasValidFramebuffer() == false || m_scaledSize.isNull() )
-	{
-		m_scaledFramebuffer = {};
-		return;
-	}
-
-	if( isControlFlagSet( ControlFlag::ScaledFramebufferNeedsUpdate ) == false )
+	if( hasValidFramebuffer() == false )
 	{
 		return;
 	}
 
-	QReadLocker locker( &m_imgLock );
+	QMutexLocker locker( &m_scaledFramebufferMutex );
 
-	if( m_image.size().isValid() == false )
+	if( m_scaledSize.isNull() || m_scaledFramebufferUpdateRunning )
 	{
+		// a running update picks up all pending damage before finishing
 		return;
 	}
 
-	m_scaledFramebuffer = m_image.scaled( m_scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
-
-	setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, false );
+	m_scaledFramebufferUpdateRunning = true;
+	m_scaledFramebufferUpdate = QtConcurrent::run( scaledFramebufferThreadPool(), [this]() { updateScaledFramebuffer(); } );
 }
 
 
@@ -369,14 +433,22 @@ qint64 VncConnection::libvncClientDispatcher( char* buffer, const qint64 bytes,
 
 void VncConnection::mouseEvent( int x, int y, uint buttonMask )
 {
-	enqueueEvent(new VncPointerEvent(x, y, buttonMask));
+	if( state() == State::Connected )
+	{
+		m_eventQueue.enqueuePointerEvent( x, y, buttonMask );
+		wakeUp();
+	}
 }
 
 
 
 void VncConnection::keyEvent( unsigned int key, bool pressed )
 {
-	enqueueEvent(new VncKeyEvent(key, pressed));
+	if( state() == State::Connected )
+	{
+		m_eventQueue.enqueueKeyEvent( key, pressed );
+		wakeUp();
+	}
 }
 
 
@@ -392,7 +464,18 @@ void VncConnection::run()
 {
 	while( isControlFlagSet( ControlFlag::TerminateThread ) == false )
 	{
-		establishConnection();
+		// connection may have been handed back from a shared I/O thread
+		if( state() != State::Connected )
+		{
+			establishConnection();
+		}
+
+		if( attachToReactor() )
+		{
+			// connection is served by a shared I/O thread from now on so let this thread finish
+			return;
+		}
+
 		handleConnection();
 		closeConnection();
 	}
@@ -413,6 +496,16 @@ void VncConnection::establishConnection()
 	setControlFlag( ControlFlag::RestartConnection, false );
 
 	m_framebufferState = FramebufferState::Invalid;
+	m_pipelinedFramebufferUpdateRequests = 0;
+	setControlFlag( ControlFlag::ContinuousFramebufferUpdates, false );
+	setControlFlag( ControlFlag::RequiresDedicatedThread, false );
+
+	m_serverMessageFramer.reset();
+	m_serverMessageTimer.invalidate();
+
+	m_statisticsMutex.lock();
+	m_statisticsTimer.invalidate();
+	m_statisticsMutex.unlock();
 
 	while( isControlFlagSet( ControlFlag::TerminateThread ) == false &&
 		   state() != State::Connected ) // try to connect as long as the server allows
@@ -421,7 +514,7 @@ void VncConnection::establishConnection()
 		m_client = rfbGetClient( RfbBitsPerSample, RfbSamplesPerPixel, RfbBytesPerPixel );
 		m_client->canHandleNewFBSize = true;
 		m_client->MallocFrameBuffer = RfbClientCallback::wrap<&VncConnection::initFrameBuffer>;
-		m_client->GotFrameBufferUpdate = RfbClientCallback::wrap<&VncConnection::imageUpdated>;
+		m_client->GotFrameBufferUpdate = RfbClientCallback::wrap<&VncConnection::markImageUpdated>;
 		m_client->FinishedFrameBufferUpdate = RfbClientCallback::wrap<&VncConnection::finishFrameBufferUpdate>;
 		m_client->HandleCursorPos = RfbClientCallback::wrap<&VncConnection::updateCursorPosition>;
 		m_client->GotCursorShape = RfbClientCallback::wrap<&VncConnection::updateCursorShape>;
@@ -458,6 +551,10 @@ void VncConnection::establishConnection()
 
 		setControlFlag( ControlFlag::ServerReachable, false );
 
+		QElapsedTimer connectTimer;
+		connectTimer.start();
+
+		// a handshake slot is acquired in openTlsSocket() once the TCP connection has been established
 		const auto clientInitialized = rfbInitClient( m_client, nullptr, nullptr );
 		if( clientInitialized == FALSE )
 		{
@@ -465,20 +562,28 @@ void VncConnection::establishConnection()
 			m_client = nullptr;
 		}
 
+		releaseHandshakeSlot();
+
 		// do not continue/sleep when already requested to stop
 		if( isControlFlagSet( ControlFlag::TerminateThread ) )
 		{
+			m_scheduler->finishConnectionAttempt( m_host, clientInitialized, connectTimer.elapsed() );
 			return;
 		}
 
 		if( clientInitialized )
 		{
+			// send initial pixel format, encodings and framebuffer update request
+			flushTlsSocket();
+
 			m_framebufferUpdateWatchdog.restart();
 
 			VeyonCore::platform().networkFunctions().
 					configureSocketKeepalive( static_cast<PlatformNetworkFunctions::Socket>( m_client->sock ), true,
 											  m_socketKeepaliveIdleTime, m_socketKeepaliveInterval, m_socketKeepaliveCount );
 
+			m_scheduler->finishConnectionAttempt( m_host, true, connectTimer.elapsed() );
+
 			setState( State::Connected );
 		}
 		else
@@ -517,17 +622,14 @@ void VncConnection::establishConnection()
 				setState( State::ConnectionFailed );
 			}
 
-			// wait a bit until next connect
+			m_scheduler->finishConnectionAttempt( m_host, false, connectTimer.elapsed() );
+
+			// wait a bit until next connect, longer if the host failed repeatedly
+			const auto retryInterval = m_scheduler->retryInterval( m_host, m_framebufferUpdateInterval > 0 ?
+																	   m_framebufferUpdateInterval : m_connectionRetryInterval );
+
 			sleeperMutex.lock();
-			if( m_framebufferUpdateInterval > 0 )
-			{
-				m_updateIntervalSleeper.wait( &sleeperMutex, m_framebufferUpdateInterval );
-			}
-			else
-			{
-				// default: retry every second
-				m_updateIntervalSleeper.wait( &sleeperMutex, m_connectionRetryInterval );
-			}
+			m_updateIntervalSleeper.wait( &sleeperMutex, retryInterval );
 			sleeperMutex.unlock();
 		}
 	}
@@ -551,7 +653,10 @@ void VncConnection::handleConnection()
 								   :
 									 (m_framebufferUpdateInterval > 0 ? m_messageWaitTimeout * 100 : m_messageWaitTimeout);
 
-		const int i = WaitForMessage(m_client, waitTimeout);
+		// data already decrypted and buffered by the TLS socket or received by a shared I/O thread
+		// does not make the socket readable again
+		const int i = ( m_serverMessageFramer.framedBytes() > 0 || ( m_sslSocket && m_sslSocket->bytesAvailable() > 0 ) ) ?
+						  1 : WaitForMessage(m_client, waitTimeout);
 
 		if( isControlFlagSet( ControlFlag::TerminateThread ) || i < 0 )
 		{
@@ -560,32 +665,14 @@ void VncConnection::handleConnection()
 
 		if( i )
 		{
-			// handle all available messages
-			bool handledOkay = true;
-			do {
-				handledOkay &= HandleRFBServerMessage( m_client );
-			} while( handledOkay && WaitForMessage( m_client, 0 ) );
-
-			if( handledOkay == false )
+			if( handleServerMessages() == false )
 			{
 				break;
 			}
 		}
-		else if (m_framebufferUpdateWatchdog.elapsed() >=
-				 qMax<qint64>(2*m_framebufferUpdateInterval, m_framebufferUpdateWatchdogTimeout))
-		{
-			requestFrameufferUpdate(FramebufferUpdateType::Full);
-			m_framebufferUpdateWatchdog.restart();
-		}
-		else if (m_framebufferUpdateInterval > 0 && m_framebufferUpdateWatchdog.elapsed() > m_framebufferUpdateInterval)
-		{
-			requestFrameufferUpdate(FramebufferUpdateType::Incremental);
-			m_framebufferUpdateWatchdog.restart();
-		}
-		else if (isControlFlagSet(ControlFlag::TriggerFramebufferUpdate))
+		else
 		{
-			setControlFlag(ControlFlag::TriggerFramebufferUpdate, false);
-			requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+			handleFramebufferUpdateTimers();
 		}
 
 		const auto remainingUpdateInterval = m_framebufferUpdateInterval - loopTimer.elapsed();
@@ -601,6 +688,7 @@ void VncConnection::handleConnection()
 		}
 
 		sendEvents();
+		flushTlsSocket();
 	}
 }
 
@@ -619,6 +707,284 @@ void VncConnection::closeConnection()
 
 
 
+bool VncConnection::handleServerMessages()
+{
+	// handle all available messages including data already buffered by the TLS socket
+	bool handledOkay = true;
+	do {
+		m_encodingController.beginMessage();
+		handledOkay &= HandleRFBServerMessage( m_client );
+
+		if( handledOkay && m_encodingController.endMessage() )
+		{
+			updateEncodingSettingsFromQuality();
+			SetFormatAndEncodings( m_client );
+		}
+	} while( handledOkay && ( m_serverMessageFramer.framedBytes() > 0 ||
+							  ( m_sslSocket && m_sslSocket->bytesAvailable() > 0 ) || WaitForMessage( m_client, 0 ) ) );
+
+	return handledOkay;
+}
+
+
+
+void VncConnection::handleFramebufferUpdateTimers()
+{
+	if (m_framebufferUpdateWatchdog.elapsed() >=
+		qMax<qint64>(2*m_framebufferUpdateInterval, m_framebufferUpdateWatchdogTimeout))
+	{
+		requestFrameufferUpdate(FramebufferUpdateType::Full);
+		m_framebufferUpdateWatchdog.restart();
+	}
+	else if (m_framebufferUpdateInterval > 0 && m_framebufferUpdateWatchdog.elapsed() > m_framebufferUpdateInterval)
+	{
+		requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+		m_framebufferUpdateWatchdog.restart();
+	}
+	else if (isControlFlagSet(ControlFlag::TriggerFramebufferUpdate))
+	{
+		setControlFlag(ControlFlag::TriggerFramebufferUpdate, false);
+		requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+	}
+}
+
+
+
+bool VncConnection::isSessionActive()
+{
+	return state() == State::Connected &&
+		   isControlFlagSet( ControlFlag::TerminateThread ) == false &&
+		   isControlFlagSet( ControlFlag::RestartConnection ) == false;
+}
+
+
+
+bool VncConnection::attachToReactor()
+{
+	// connections to Veyon Server < 4.7 require sleeping between updates and thus keep their own thread
+	// as well as connections whose server messages can't be framed by a shared I/O thread
+	if( m_reactor == nullptr ||
+		m_sslSocket == nullptr ||
+		isSessionActive() == false ||
+		isControlFlagSet( ControlFlag::RequiresManualUpdateRateControl ) ||
+		isControlFlagSet( ControlFlag::RequiresDedicatedThread ) )
+	{
+		return false;
+	}
+
+	// shared I/O threads frame messages starting at the current position of the stream so
+	// messages read ahead by libvncclient during the handshake have to be handled here
+	while( m_client->buffered > 0 )
+	{
+		m_encodingController.beginMessage();
+		if( HandleRFBServerMessage( m_client ) == false )
+		{
+			setControlFlag( ControlFlag::RestartConnection, true );
+			return false;
+		}
+
+		if( m_encodingController.endMessage() )
+		{
+			updateEncodingSettingsFromQuality();
+			SetFormatAndEncodings( m_client );
+		}
+	}
+
+	auto reactorThread = m_reactor->assignThread();
+	if( reactorThread == nullptr )
+	{
+		return false;
+	}
+
+	m_sslSocket->moveToThread( reactorThread );
+
+	m_reactorThread = reactorThread;
+	reactorThread->attach( this );
+
+	return true;
+}
+
+
+
+int VncConnection::reactorSocket() const
+{
+	return m_client ? int(m_client->sock) : -1;
+}
+
+
+
+int VncConnection::reactorSessionTimeout()
+{
+	if( isControlFlagSet( ControlFlag::TriggerFramebufferUpdate ) ||
+		( m_sslSocket && m_sslSocket->bytesAvailable() > 0 ) )
+	{
+		return 0;
+	}
+
+	if( m_sslSocket && m_sslSocket->bytesToWrite() > 0 )
+	{
+		return ReactorWriteRetryInterval;
+	}
+
+	const auto elapsed = m_framebufferUpdateWatchdog.elapsed();
+	auto timeout = qMax<qint64>(2*m_framebufferUpdateInterval, m_framebufferUpdateWatchdogTimeout) - elapsed;
+
+	if( m_framebufferUpdateInterval > 0 )
+	{
+		timeout = qMin<qint64>( timeout, m_framebufferUpdateInterval - elapsed + 1 );
+	}
+
+	return int( qBound<qint64>( 0, timeout, m_framebufferUpdateWatchdogTimeout ) );
+}
+
+
+
+bool VncConnection::isReactorServiceDue()
+{
+	return m_reactorServiceRequested.exchange( false ) || reactorSessionTimeout() == 0;
+}
+
+
+
+bool VncConnection::serviceReactorSession( bool readable )
+{
+	if( isSessionActive() == false )
+	{
+		return false;
+	}
+
+	if( ( readable || m_sslSocket->bytesAvailable() > 0 ) &&
+		handleFramedServerMessages() == false )
+	{
+		return false;
+	}
+
+	handleFramebufferUpdateTimers();
+
+	sendEvents();
+	flushTlsSocket();
+
+	return isSessionActive() && isControlFlagSet( ControlFlag::RequiresManualUpdateRateControl ) == false;
+}
+
+
+
+bool VncConnection::handleFramedServerMessages()
+{
+	// only take what has been received already - waiting for the remainder of a message
+	// would block all other connections served by the same thread
+	if( m_sslSocket->bytesAvailable() <= 0 )
+	{
+		m_sslSocket->waitForReadyRead( 0 );
+	}
+
+	const auto data = m_sslSocket->read( ReactorReceiveChunkSize );
+	m_bytesReceived += quint64(data.size());
+	m_serverMessageFramer.addData( data );
+
+	// let libvncclient handle complete messages only so that it never has to wait for data
+	while( m_serverMessageFramer.hasUnframedData() )
+	{
+		if( m_serverMessageTimer.isValid() == false )
+		{
+			m_encodingController.beginMessage();
+			m_serverMessageTimer.start();
+		}
+
+		const auto result = m_serverMessageFramer.frameMessage( m_client->format );
+		if( result == VncServerMessageFramer::Result::Incomplete )
+		{
+			break;
+		}
+
+		if( result == VncServerMessageFramer::Result::Unsupported )
+		{
+			vDebug() << "handing connection to" << m_host << "back to its own thread as messages can't be framed";
+			m_serverMessageFramer.releaseData();
+			m_serverMessageTimer.invalidate();
+			setControlFlag( ControlFlag::RequiresDedicatedThread, true );
+			return false;
+		}
+
+		m_encodingController.addReceivedData( m_serverMessageFramer.framedBytes(), m_serverMessageTimer.nsecsElapsed() );
+		m_serverMessageTimer.invalidate();
+
+		if( HandleRFBServerMessage( m_client ) == false ||
+			m_serverMessageFramer.framedBytes() > 0 || m_client->buffered > 0 )
+		{
+			vWarning() << "failed to handle message from" << m_host;
+			setControlFlag( ControlFlag::RestartConnection, true );
+			return false;
+		}
+
+		if( m_encodingController.endMessage() )
+		{
+			updateEncodingSettingsFromQuality();
+			SetFormatAndEncodings( m_client );
+		}
+	}
+
+	if( m_sslSocket->state() != QAbstractSocket::ConnectedState && m_sslSocket->bytesAvailable() <= 0 )
+	{
+		setControlFlag( ControlFlag::RestartConnection, true );
+		return false;
+	}
+
+	return true;
+}
+
+
+
+void VncConnection::finishReactorSession()
+{
+	// make sure the previous run of the connection thread has finished before restarting it
+	wait();
+
+	const auto reactorThread = m_reactorThread.load();
+
+	if( isSessionActive() )
+	{
+		// hand the established connection back to the connection thread
+		m_sslSocket->moveToThread( this );
+	}
+	else
+	{
+		closeConnection();
+
+		if( isControlFlagSet( ControlFlag::TerminateThread ) )
+		{
+			m_reactorThread = nullptr;
+
+			if( isControlFlagSet( ControlFlag::DeleteAfterFinished ) )
+			{
+				deleteLaterInMainThread();
+			}
+			return;
+		}
+	}
+
+	// restart the connection thread before detaching so that stopAndDeleteLater() never sees an idle connection
+	start();
+
+	auto expectedReactorThread = reactorThread;
+	m_reactorThread.compare_exchange_strong( expectedReactorThread, nullptr );
+}
+
+
+
+void VncConnection::wakeUp()
+{
+	m_updateIntervalSleeper.wakeAll();
+
+	if( const auto reactorThread = m_reactorThread.load(); reactorThread )
+	{
+		m_reactorServiceRequested = true;
+		reactorThread->wakeUp();
+	}
+}
+
+
+
 void VncConnection::setState( State state )
 {
 	if( m_state.exchange( state ) != state )
@@ -653,37 +1019,35 @@ bool VncConnection::isControlFlagSet( VncConnection::ControlFlag flag )
 
 rfbBool VncConnection::initFrameBuffer( rfbClient* client )
 {
-	if( client->format.bitsPerPixel != RfbBitsPerSample * RfbBytesPerPixel )
-	{
-		vCritical() << "Bits per pixel does not match" << client->format.bitsPerPixel;
-		return false;
-	}
-
 	const auto pixelCount = uint32_t(client->width) * uint32_t(client->height);
 
-	client->frameBuffer = reinterpret_cast<uint8_t *>( new RfbPixel[pixelCount] );
+	m_imageData = new RfbPixel[pixelCount];
 
-	memset( client->frameBuffer, '\0', pixelCount*RfbBytesPerPixel );
+	memset( m_imageData, '\0', pixelCount*RfbBytesPerPixel );
 
 	// initialize framebuffer image which just wraps the allocated memory and ensures cleanup after last
 	// image copy using the framebuffer gets destroyed
 	m_imgLock.lockForWrite();
-	m_image = QImage( client->frameBuffer, client->width, client->height, QImage::Format_RGB32, framebufferCleanup, client->frameBuffer );
+	m_image = QImage( reinterpret_cast<uchar *>( m_imageData ), client->width, client->height,
+					  QImage::Format_RGB32, framebufferCleanup, m_imageData );
 	m_imgLock.unlock();
 
-	// set up pixel format according to QImage
-	client->format.redShift = 16;
-	client->format.greenShift = 8;
-	client->format.blueShift = 0;
-	client->format.redMax = 0xff;
-	client->format.greenMax = 0xff;
-	client->format.blueMax = 0xff;
+	m_scaledFramebufferMutex.lock();
+	m_damagedRegion = {};
+	m_fullRescaleRequired = true;
+	m_scaledFramebufferMutex.unlock();
 
 	client->appData.useRemoteCursor = m_useRemoteCursor ? TRUE : FALSE;
 	client->appData.useBGR233 = false;
 
+	setControlFlag( ControlFlag::QualityChanged, false );
+	m_encodingController.setQualityRange( m_quality, m_minimumQuality );
 	updateEncodingSettingsFromQuality();
 
+	// the pixel format can only be chosen freely before it is sent to the server for the first time,
+	// afterwards it's just kept when the framebuffer gets resized
+	setPixelFormat( m_framebufferState == FramebufferState::Invalid ? pixelFormatForQuality() : m_pixelFormat );
+
 	m_framebufferState = FramebufferState::Initialized;
 
 	Q_EMIT framebufferSizeChanged( client->width, client->height );
@@ -706,6 +1070,8 @@ void VncConnection::requestFrameufferUpdate(FramebufferUpdateType updateType)
 			SendFramebufferUpdateRequest(m_client, 0, 0, m_client->width, m_client->height, false);
 			break;
 		}
+
+		m_encodingController.updateRequested( updateType == FramebufferUpdateType::Incremental );
 	}
 }
 
@@ -716,23 +1082,213 @@ void VncConnection::finishFrameBufferUpdate()
 	m_framebufferUpdateWatchdog.restart();
 
 	m_framebufferState = FramebufferState::Valid;
-	setControlFlag( ControlFlag::ScaledFramebufferNeedsUpdate, true );
+
+	m_encodingController.finishUpdate();
+
+	// the server may already send the next update in the previous pixel format if it was
+	// changed at any other time
+	if( pixelFormatForQuality() != m_pixelFormat )
+	{
+		setPixelFormat( pixelFormatForQuality() );
+		SetFormatAndEncodings( m_client );
+	}
+
+	pipelineFramebufferUpdateRequests();
+
+	updateStatistics();
+
+	rescaleFramebuffer();
 
 	Q_EMIT framebufferUpdateComplete();
 }
 
 
 
+void VncConnection::pipelineFramebufferUpdateRequests()
+{
+	// libvncclient requests the next incremental update right after finishing the current one, so each frame
+	// costs a full round trip - in live mode (where there's no update interval) additional requests are kept
+	// in flight unless the server sends updates on its own anyway
+	if (m_pipelinedFramebufferUpdateRequests > 0)
+	{
+		// the update which just has been received answered one of the outstanding requests
+		--m_pipelinedFramebufferUpdateRequests;
+	}
+
+	const auto additionalRequests = m_framebufferUpdateInterval <= 0 &&
+									isControlFlagSet(ControlFlag::SkipFramebufferUpdates) == false &&
+									isControlFlagSet(ControlFlag::RequiresManualUpdateRateControl) == false &&
+									isControlFlagSet(ControlFlag::ContinuousFramebufferUpdates) == false ?
+										qMax(0, m_framebufferUpdatesInFlight - 1) : 0;
+
+	if (additionalRequests == 0)
+	{
+		// previously pipelined requests simply expire with the next updates
+		m_pipelinedFramebufferUpdateRequests = 0;
+		return;
+	}
+
+	while (m_pipelinedFramebufferUpdateRequests < additionalRequests)
+	{
+		requestFrameufferUpdate(FramebufferUpdateType::Incremental);
+		++m_pipelinedFramebufferUpdateRequests;
+	}
+}
+
+
+
+void VncConnection::updateStatistics()
+{
+	const quint64 bytesReceived = m_bytesReceived;
+
+	// libvncclient does not tell which encoding each rectangle has been sent with,
+	// so account all data of an update to the currently preferred encoding
+	const auto encoding = QString::fromLatin1( m_client->appData.encodingsString ).section( QLatin1Char(' '), 0, 0 );
+
+	QMutexLocker locker( &m_statisticsMutex );
+
+	m_statistics.encodingBytes[encoding] += bytesReceived - m_statisticsUpdateBytesReceived;
+	m_statisticsUpdateBytesReceived = bytesReceived;
+
+	++m_statistics.framebufferUpdates;
+	++m_statisticsIntervalUpdates;
+
+	m_statistics.throughput = m_encodingController.throughput();
+	m_statistics.roundTripTime = m_encodingController.roundTripTime();
+	m_statistics.decodeTime = m_encodingController.decodeTime();
+	m_statistics.quality = m_encodingController.quality();
+	m_statistics.compressLevel = m_encodingController.compressLevel();
+
+	if( m_statisticsTimer.isValid() == false )
+	{
+		m_statisticsTimer.start();
+		m_statisticsIntervalUpdates = 0;
+		m_statisticsIntervalBytesReceived = bytesReceived;
+	}
+	else if( m_statisticsTimer.elapsed() >= StatisticsInterval )
+	{
+		const auto elapsed = m_statisticsTimer.restart();
+
+		m_statistics.framebufferUpdateRate = qreal( m_statisticsIntervalUpdates ) * 1000 / elapsed;
+		m_statistics.receiveRate = qint64( bytesReceived - m_statisticsIntervalBytesReceived ) * 1000 / elapsed;
+
+		m_statisticsIntervalUpdates = 0;
+		m_statisticsIntervalBytesReceived = bytesReceived;
+	}
+}
+
+
+
+void VncConnection::markImageUpdated( int x, int y, int w, int h )
+{
+	if( m_pixelFormat != VncConnectionConfiguration::PixelFormat::RGB888 )
+	{
+		expandFramebufferRect( QRect( x, y, w, h ) );
+	}
+
+	m_scaledFramebufferMutex.lock();
+	m_damagedRegion += QRect( x, y, w, h );
+	m_scaledFramebufferMutex.unlock();
+
+	Q_EMIT imageUpdated( x, y, w, h );
+}
+
+
+
+void VncConnection::updateScaledFramebuffer()
+{
+	forever
+	{
+		m_scaledFramebufferMutex.lock();
+
+		const auto scaledSize = m_scaledSize;
+		const auto damagedRegion = m_damagedRegion;
+		const auto fullRescaleRequired = m_fullRescaleRequired;
+
+		if( scaledSize.isEmpty() || ( fullRescaleRequired == false && damagedRegion.isEmpty() ) )
+		{
+			m_scaledFramebufferUpdateRunning = false;
+			m_scaledFramebufferMutex.unlock();
+			return;
+		}
+
+		m_damagedRegion = {};
+		m_fullRescaleRequired = false;
+
+		m_scaledFramebufferMutex.unlock();
+
+		const auto source = image();
+		if( source.isNull() )
+		{
+			continue;
+		}
+
+		qint64 damagedArea = 0;
+		for( const auto& rect : damagedRegion )
+		{
+			damagedArea += qint64(rect.width()) * rect.height();
+		}
+
+		// rescaling the whole framebuffer is cheaper than processing lots of (large) rectangles
+		if( fullRescaleRequired ||
+			m_scaledFramebufferBuffer.size() != scaledSize ||
+			FramebufferScaler::canScale( source, scaledSize ) == false ||
+			damagedRegion.rectCount() > MaximumIncrementalRescaleRectCount ||
+			damagedArea * 2 > qint64(source.width()) * source.height() )
+		{
+			m_scaledFramebufferBuffer = FramebufferScaler::scaled( source, scaledSize );
+		}
+		else
+		{
+			for( const auto& rect : damagedRegion )
+			{
+				rescaleFramebufferRect( source, m_scaledFramebufferBuffer, rect & source.rect() );
+			}
+		}
+
+		m_scaledFramebufferMutex.lock();
+		m_scaledFramebuffer = m_scaledFramebufferBuffer;
+		m_scaledFramebufferMutex.unlock();
+
+		Q_EMIT scaledFramebufferUpdated();
+	}
+}
+
+
+
+void VncConnection::rescaleFramebufferRect( const QImage& source, QImage& target, const QRect& rect )
+{
+	if( rect.isEmpty() )
+	{
+		return;
+	}
+
+	const auto scaleX = qreal(target.width()) / source.width();
+	const auto scaleY = qreal(target.height()) / source.height();
+
+	// map damaged rect to target coordinates and grow it by one pixel to catch rounding at box boundaries
+	const auto targetRect = QRect( QPoint( qFloor( rect.x() * scaleX ), qFloor( rect.y() * scaleY ) ),
+								   QPoint( qCeil( ( rect.x() + rect.width() ) * scaleX ),
+										   qCeil( ( rect.y() + rect.height() ) * scaleY ) ) )
+								.adjusted( -1, -1, 0, 0 );
+
+	FramebufferScaler::scaleRect( source, target, targetRect );
+}
+
+
+
 void VncConnection::updateEncodingSettingsFromQuality()
 {
-	m_client->appData.encodingsString = m_quality == VncConnectionConfiguration::Quality::Highest ?
-											"zrle ultra copyrect hextile zlib corre rre raw" :
+	const auto quality = m_encodingController.quality();
+
+	m_client->appData.encodingsString = quality == VncConnectionConfiguration::Quality::Highest ?
+											"zrle ultra copyrect hextile zlib corre rre tight raw" :
 											"tight zywrle zrle ultra";
 
-	m_client->appData.compressLevel = 9;
+	m_client->appData.compressLevel = m_encodingController.compressLevel();
 
-	m_client->appData.qualityLevel = [this] {
-		switch(m_quality)
+	m_client->appData.qualityLevel = [quality] {
+		switch(quality)
 		{
 		case VncConnectionConfiguration::Quality::Highest: return 9;
 		case VncConnectionConfiguration::Quality::High: return 7;
@@ -743,7 +1299,190 @@ void VncConnection::updateEncodingSettingsFromQuality()
 		return 5;
 	}();
 
-	m_client->appData.enableJPEG = m_quality != VncConnectionConfiguration::Quality::Highest;
+	m_client->appData.enableJPEG = quality != VncConnectionConfiguration::Quality::Highest;
+}
+
+
+
+void VncConnection::applyQualityChange()
+{
+	if( m_client && isControlFlagSet( ControlFlag::QualityChanged ) )
+	{
+		setControlFlag( ControlFlag::QualityChanged, false );
+
+		m_encodingController.setQualityRange( m_quality, m_minimumQuality );
+		updateEncodingSettingsFromQuality();
+		SetFormatAndEncodings( m_client );
+	}
+}
+
+
+
+VncConnectionConfiguration::PixelFormat VncConnection::pixelFormatForQuality() const
+{
+	if( m_reducedColorDepth )
+	{
+		switch( m_encodingController.quality() )
+		{
+		case VncConnectionConfiguration::Quality::Low: return VncConnectionConfiguration::PixelFormat::RGB565;
+		case VncConnectionConfiguration::Quality::Lowest: return VncConnectionConfiguration::PixelFormat::BGR233;
+		default: break;
+		}
+	}
+
+	return VncConnectionConfiguration::PixelFormat::RGB888;
+}
+
+
+
+void VncConnection::setPixelFormat( VncConnectionConfiguration::PixelFormat pixelFormat )
+{
+	m_pixelFormat = pixelFormat;
+
+	auto& format = m_client->format;
+	format.trueColour = TRUE;
+	format.bitsPerPixel = uint8_t( bitsPerPixel( pixelFormat ) );
+
+	switch( pixelFormat )
+	{
+	case VncConnectionConfiguration::PixelFormat::RGB888:
+		// set up pixel format according to QImage
+		format.depth = 24;
+		format.redShift = 16;
+		format.greenShift = 8;
+		format.blueShift = 0;
+		format.redMax = 0xff;
+		format.greenMax = 0xff;
+		format.blueMax = 0xff;
+		break;
+	case VncConnectionConfiguration::PixelFormat::RGB565:
+		format.depth = 16;
+		format.redShift = 11;
+		format.greenShift = 5;
+		format.blueShift = 0;
+		format.redMax = 0x1f;
+		format.greenMax = 0x3f;
+		format.blueMax = 0x1f;
+		break;
+	case VncConnectionConfiguration::PixelFormat::BGR233:
+		format.depth = 8;
+		format.redShift = 0;
+		format.greenShift = 3;
+		format.blueShift = 6;
+		format.redMax = 0x07;
+		format.greenMax = 0x07;
+		format.blueMax = 0x03;
+		break;
+	}
+
+	const auto pixelCount = int(m_client->width) * int(m_client->height);
+
+	if( pixelFormat == VncConnectionConfiguration::PixelFormat::RGB888 )
+	{
+		// decode directly into the image
+		m_reducedFramebuffer = {};
+		m_client->frameBuffer = reinterpret_cast<uint8_t *>( m_imageData );
+	}
+	else
+	{
+		// decode into a separate buffer which has to reflect the current image for CopyRect to work
+		m_reducedFramebuffer.resize( size_t(pixelCount) * size_t(format.bitsPerPixel / 8) );
+		reducePixels( m_imageData, m_reducedFramebuffer.data(), pixelCount, pixelFormat );
+		m_client->frameBuffer = m_reducedFramebuffer.data();
+	}
+}
+
+
+
+void VncConnection::expandFramebufferRect( const QRect& rect )
+{
+	const auto width = m_client->width;
+	const auto updatedRect = rect & QRect( 0, 0, width, m_client->height );
+	const auto bytesPerPixel = bitsPerPixel( m_pixelFormat ) / 8;
+
+	for( int y = updatedRect.top(); y <= updatedRect.bottom(); ++y )
+	{
+		const auto offset = y * width + updatedRect.left();
+		expandPixels( m_reducedFramebuffer.data() + offset * bytesPerPixel, m_imageData + offset,
+					  updatedRect.width(), m_pixelFormat );
+	}
+}
+
+
+
+int VncConnection::bitsPerPixel( VncConnectionConfiguration::PixelFormat pixelFormat )
+{
+	switch( pixelFormat )
+	{
+	case VncConnectionConfiguration::PixelFormat::RGB888: return RfbBytesPerPixel * 8;
+	case VncConnectionConfiguration::PixelFormat::RGB565: return 16;
+	case VncConnectionConfiguration::PixelFormat::BGR233: return 8;
+	}
+
+	return RfbBytesPerPixel * 8;
+}
+
+
+
+void VncConnection::expandPixels( const uint8_t* source, RfbPixel* target, int count,
+								  VncConnectionConfiguration::PixelFormat pixelFormat )
+{
+	switch( pixelFormat )
+	{
+	case VncConnectionConfiguration::PixelFormat::RGB888:
+		memcpy( target, source, size_t(count) * RfbBytesPerPixel ); // Flawfinder: ignore
+		break;
+	case VncConnectionConfiguration::PixelFormat::RGB565:
+		for( int i = 0; i < count; ++i )
+		{
+			uint16_t pixel;
+			memcpy( &pixel, source + i * 2, sizeof(pixel) ); // Flawfinder: ignore
+			const uint r = ( pixel >> 11 ) & 0x1f;
+			const uint g = ( pixel >> 5 ) & 0x3f;
+			const uint b = pixel & 0x1f;
+			target[i] = qRgb( int( ( r << 3 ) | ( r >> 2 ) ), int( ( g << 2 ) | ( g >> 4 ) ), int( ( b << 3 ) | ( b >> 2 ) ) );
+		}
+		break;
+	case VncConnectionConfiguration::PixelFormat::BGR233:
+		for( int i = 0; i < count; ++i )
+		{
+			const uint r = source[i] & 0x07;
+			const uint g = ( source[i] >> 3 ) & 0x07;
+			const uint b = ( source[i] >> 6 ) & 0x03;
+			target[i] = qRgb( int( ( r << 5 ) | ( r << 2 ) | ( r >> 1 ) ), int( ( g << 5 ) | ( g << 2 ) | ( g >> 1 ) ), int( b * 0x55 ) );
+		}
+		break;
+	}
+}
+
+
+
+void VncConnection::reducePixels( const RfbPixel* source, uint8_t* target, int count,
+								  VncConnectionConfiguration::PixelFormat pixelFormat )
+{
+	switch( pixelFormat )
+	{
+	case VncConnectionConfiguration::PixelFormat::RGB888:
+		memcpy( target, source, size_t(count) * RfbBytesPerPixel ); // Flawfinder: ignore
+		break;
+	case VncConnectionConfiguration::PixelFormat::RGB565:
+		for( int i = 0; i < count; ++i )
+		{
+			const auto pixel = uint16_t( ( uint( qRed( source[i] ) >> 3 ) << 11 ) |
+										 ( uint( qGreen( source[i] ) >> 2 ) << 5 ) |
+										 uint( qBlue( source[i] ) >> 3 ) );
+			memcpy( target + i * 2, &pixel, sizeof(pixel) ); // Flawfinder: ignore
+		}
+		break;
+	case VncConnectionConfiguration::PixelFormat::BGR233:
+		for( int i = 0; i < count; ++i )
+		{
+			target[i] = uint8_t( uint( qRed( source[i] ) >> 5 ) |
+								 ( uint( qGreen( source[i] ) >> 5 ) << 3 ) |
+								 ( uint( qBlue( source[i] ) >> 6 ) << 6 ) );
+		}
+		break;
+	}
 }
 
 
@@ -758,19 +1497,67 @@ rfbBool VncConnection::updateCursorPosition( int x, int y )
 
 void VncConnection::updateCursorShape( rfbClient* client, int xh, int yh, int w, int h, int bpp )
 {
-	if( bpp != 4 )
+	auto cursorShapeCache = VncCursorShapeCache::instance();
+
+	const auto key = VncCursorShapeCache::key( QByteArray::fromRawData( reinterpret_cast<const char *>( client->rcSource ), w * h * bpp ),
+											   QByteArray::fromRawData( reinterpret_cast<const char *>( client->rcMask ), w * h ),
+											   { w, h }, { xh, yh }, ( bpp << 8 ) | int(m_pixelFormat) );
+
+	auto cursorShape = cursorShapeCache->find( key );
+	if( cursorShape.isNull() )
 	{
-		vWarning() << QThread::currentThreadId() << "bytes per pixel != 4";
-		return;
+		cursorShape = convertCursorShape( client, w, h, bpp );
+		if( cursorShape.isNull() )
+		{
+			return;
+		}
+
+		cursorShapeCache->insert( key, cursorShape );
 	}
 
-	QImage alpha( client->rcMask, w, h, QImage::Format_Indexed8 );
-	alpha.setColorTable( { qRgb(255,255,255), qRgb(0,0,0) } );
+	Q_EMIT cursorShapeUpdated( QPixmap::fromImage( cursorShape ), xh, yh );
+}
+
+
+
+QImage VncConnection::convertCursorShape( rfbClient* client, int w, int h, int bpp ) const
+{
+	QImage source;
+
+	if( bpp == RfbBytesPerPixel )
+	{
+		source = QImage( client->rcSource, w, h, QImage::Format_RGB32 );
+	}
+	else if( bpp * 8 == bitsPerPixel( m_pixelFormat ) )
+	{
+		source = QImage( w, h, QImage::Format_RGB32 );
+		for( int y = 0; y < h; ++y )
+		{
+			expandPixels( client->rcSource + y * w * bpp, reinterpret_cast<RfbPixel *>( source.scanLine( y ) ), w, m_pixelFormat );
+		}
+	}
+	else
+	{
+		vWarning() << QThread::currentThreadId() << "unsupported bytes per pixel" << bpp;
+		return {};
+	}
 
-	QPixmap cursorShape( QPixmap::fromImage( QImage( client->rcSource, w, h, QImage::Format_RGB32 ) ) );
-	cursorShape.setMask( QBitmap::fromImage( alpha ) );
+	// apply the cursor mask as alpha channel
+	auto cursorShape = source.convertToFormat( QImage::Format_ARGB32 );
+	for( int y = 0; y < h; ++y )
+	{
+		const auto mask = client->rcMask + y * w;
+		auto pixels = reinterpret_cast<QRgb *>( cursorShape.scanLine( y ) );
+		for( int x = 0; x < w; ++x )
+		{
+			if( mask[x] == 0 )
+			{
+				pixels[x] = qRgba( 0, 0, 0, 0 );
+			}
+		}
+	}
 
-	Q_EMIT cursorShapeUpdated( cursorShape, xh, yh );
+	return cursorShape;
 }
 
 
@@ -789,27 +1576,12 @@ void VncConnection::updateClipboard( const char* text, int textlen )
 
 void VncConnection::sendEvents()
 {
-	m_eventQueueMutex.lock();
-
-	while( m_eventQueue.isEmpty() == false )
+	if( isControlFlagSet( ControlFlag::TerminateThread ) == false )
 	{
-		auto event = m_eventQueue.dequeue();
-
-		// unlock the queue mutex during the runtime of ClientEvent::fire()
-		m_eventQueueMutex.unlock();
-
-		if( isControlFlagSet( ControlFlag::TerminateThread ) == false )
-		{
-			event->fire( m_client );
-		}
-
-		delete event;
-
-		// and lock it again
-		m_eventQueueMutex.lock();
+		applyQualityChange();
 	}
 
-	m_eventQueueMutex.unlock();
+	m_eventQueue.sendEvents( isControlFlagSet( ControlFlag::TerminateThread ) ? nullptr : m_client );
 }
 
 
@@ -856,7 +1628,7 @@ void VncConnection::framebufferCleanup( void* framebuffer )
 
 rfbSocket VncConnection::openTlsSocket( const char* hostname, int port )
 {
-	delete m_sslSocket;
+	closeTlsSocket();
 
 	m_sslSocket = new QSslSocket;
 	connect(m_sslSocket, QOverload<const QList<QSslError>&>::of(&QSslSocket::sslErrors),
@@ -869,11 +1641,28 @@ rfbSocket VncConnection::openTlsSocket( const char* hostname, int port )
 
 	m_sslSocket->setPeerVerifyMode( m_verifyServerCertificate ? QSslSocket::VerifyPeer : QSslSocket::QueryPeer );
 
-	m_sslSocket->connectToHostEncrypted( QString::fromUtf8(hostname), port );
+	// only hold a handshake slot for the TLS and authentication handshakes so that connects to
+	// unreachable hosts do not block connections to reachable ones, e.g. when opening a large location
+	m_sslSocket->connectToHost( QString::fromUtf8(hostname), quint16(port) );
+	if( m_sslSocket->waitForConnected( m_connectTimeout ) )
+	{
+		m_handshakeSlotAcquired = m_scheduler->beginHandshake( this );
+	}
+
+	if( m_handshakeSlotAcquired == false )
+	{
+		delete m_sslSocket;
+		m_sslSocket = nullptr;
+
+		return RFB_INVALID_SOCKET;
+	}
+
+	m_sslSocket->startClientEncryption();
 	if( m_sslSocket->waitForEncrypted() == false || m_sslSocket->socketDescriptor() < 0 )
 	{
 		delete m_sslSocket;
 		m_sslSocket = nullptr;
+
 		return RFB_INVALID_SOCKET;
 	}
 
@@ -882,23 +1671,60 @@ rfbSocket VncConnection::openTlsSocket( const char* hostname, int port )
 
 
 
+void VncConnection::releaseHandshakeSlot()
+{
+	if( m_handshakeSlotAcquired )
+	{
+		m_scheduler->endHandshake();
+		m_handshakeSlotAcquired = false;
+	}
+}
+
+
+
 int VncConnection::readFromTlsSocket( char* buffer, unsigned int len )
 {
-	if( m_sslSocket == nullptr )
+	// data received by a shared I/O thread
+	if( const auto framedBytes = m_serverMessageFramer.readFramedData( buffer, len ); framedBytes > 0 )
 	{
+		return int( framedBytes );
+	}
+
+	// shared I/O threads only let libvncclient handle messages which have been received completely
+	if( m_sslSocket == nullptr || QThread::currentThread() != this )
+	{
+		errno = ECONNRESET;
 		return -1;
 	}
 
+	qint64 waitTime = 0;
+
 	if( m_sslSocket->bytesAvailable() <= 0 )
 	{
-		if( m_sslSocket->waitForReadyRead(10) == false )
+		// the server may be waiting for data we have not sent yet
+		flushTlsSocket();
+
+		QElapsedTimer waitTimer;
+		waitTimer.start();
+
+		// block until the socket actually signals new data instead of polling it at fixed intervals
+		if( m_sslSocket->waitForReadyRead( m_readTimeout ) == false )
 		{
-			errno = EAGAIN;
+			errno = m_sslSocket->error() == QAbstractSocket::SocketTimeoutError ? EAGAIN : ECONNRESET;
 			return -1;
 		}
+
+		waitTime = waitTimer.nsecsElapsed();
+	}
+
+	const auto ret = m_sslSocket->read( buffer, len );
+	if( ret > 0 )
+	{
+		m_encodingController.addReceivedData( ret, waitTime );
+		m_bytesReceived += quint64(ret);
 	}
 
-	return m_sslSocket->read( buffer, len );
+	return int( ret );
 }
 
 
@@ -910,9 +1736,31 @@ int VncConnection::writeToTlsSocket( const char* buffer, unsigned int len )
 		return -1;
 	}
 
+	// only queue data so that consecutive writes of a message end up in one TLS record
 	const auto ret = m_sslSocket->write( buffer, len );
-	m_sslSocket->flush();
-	return ret;
+	if( ret > 0 )
+	{
+		m_bytesSent += quint64(ret);
+		++m_socketWrites;
+	}
+
+	if( m_sslSocket->bytesToWrite() >= MaximumTlsWriteBufferSize )
+	{
+		flushTlsSocket();
+	}
+
+	return int( ret );
+}
+
+
+
+void VncConnection::flushTlsSocket()
+{
+	if( m_sslSocket && m_sslSocket->bytesToWrite() > 0 )
+	{
+		m_sslSocket->flush();
+		++m_socketFlushes;
+	}
 }
 
 
@@ -29,11 +29,16 @@
 
 #include <rfb/rfbproto.h>
 
+#include <array>
+#include <vector>
+
 #include <QElapsedTimer>
+#include <QFuture>
 #include <QImage>
+#include <QMap>
 #include <QMutex>
-#include <QQueue>
 #include <QReadWriteLock>
+#include <QRegion>
 #include <QThread>
 #include <QTimer>
 #include <QWaitCondition>
@@ -41,10 +46,16 @@
 #include "SocketDevice.h"
 #include "VeyonCore.h"
 #include "VncConnectionConfiguration.h"
+#include "VncEncodingController.h"
+#include "VncEventQueue.h"
+#include "VncServerMessageFramer.h"
 
 using rfbClient = struct _rfbClient;
 
 class QSslSocket;
+class VncConnectionReactor;
+class VncConnectionReactorThread;
+class VncConnectionScheduler;
 class VncEvent;
 
 class VEYON_CORE_EXPORT VncConnection : public QThread
@@ -78,6 +89,33 @@ public:
 	} ;
 	Q_ENUM(State)
 
+	// order in which connection attempts are scheduled when many connections are started at once
+	enum class Priority
+	{
+		Background,
+		Visible,
+		Interactive
+	};
+	Q_ENUM(Priority)
+
+	struct Statistics
+	{
+		quint64 bytesReceived{0};
+		quint64 bytesSent{0};
+		quint64 socketWrites{0};		// writes of libvncclient to the TLS socket
+		quint64 socketFlushes{0};		// flushes of the TLS socket, i.e. writes of (batched) TLS records
+		quint64 framebufferUpdates{0};
+		qreal framebufferUpdateRate{0};	// updates per second
+		qint64 receiveRate{0};			// bytes per second
+		qint64 throughput{0};			// bytes per second while actually receiving data
+		qint64 roundTripTime{0};		// nanoseconds between requesting and receiving a full update
+		qint64 decodeTime{0};			// nanoseconds spent decoding an update
+		VncConnectionConfiguration::Quality quality{VncConnectionConfiguration::Quality::Highest};	// current encoding settings
+		int compressLevel{0};
+		QMap<QString, quint64> encodingBytes{};	// received bytes per preferred encoding
+		VncEventQueue::Statistics eventQueue{};	// input and custom events sent to the server
+	};
+
 	explicit VncConnection( QObject *parent = nullptr );
 
 	using RfbLogMessageReader = std::function<void(const QByteArray& message)>;
@@ -101,7 +139,7 @@ public:
 
 	bool isConnected() const
 	{
-		return state() == State::Connected && isRunning();
+		return state() == State::Connected && ( isRunning() || m_reactorThread.load() != nullptr );
 	}
 
 	const QString& host() const
@@ -109,14 +147,36 @@ public:
 		return m_host;
 	}
 
-	void setQuality(VncConnectionConfiguration::Quality quality);
+	// host and effective port, e.g. for identifying data cached across connections to the same server
+	QString serverAddress() const
+	{
+		return QStringLiteral("%1:%2").arg( m_host ).arg( m_port < 0 ? m_defaultPort : m_port );
+	}
+
+	void setQuality(VncConnectionConfiguration::Quality quality,
+					VncConnectionConfiguration::Quality minimumQuality);
+
+	// use reduced pixel formats for the lower quality levels
+	void setReducedColorDepth( bool enabled );
 
 	void setUseRemoteCursor( bool enabled );
 
+	void setPriority( Priority priority )
+	{
+		m_priority = priority;
+	}
+
+	Priority priority() const
+	{
+		return m_priority;
+	}
+
 	void setServerReachable();
 
 	void enqueueEvent(VncEvent* event);
-	bool isEventQueueEmpty();
+	bool isEventQueueEmpty() const;
+
+	Statistics statistics() const;
 
 	/** \brief Returns whether framebuffer data is valid, i.e. at least one full FB update received */
 	bool hasValidFramebuffer() const
@@ -145,6 +205,16 @@ public:
 		setControlFlag(ControlFlag::RequiresManualUpdateRateControl, on);
 	}
 
+	void setContinuousFramebufferUpdates(bool on)
+	{
+		setControlFlag(ControlFlag::ContinuousFramebufferUpdates, on);
+	}
+
+	bool hasContinuousFramebufferUpdates()
+	{
+		return isControlFlagSet(ControlFlag::ContinuousFramebufferUpdates);
+	}
+
 	void rescaleFramebuffer();
 
 	static constexpr int VncConnectionTag = 0x590123;
@@ -164,6 +234,7 @@ Q_SIGNALS:
 	void imageUpdated( int x, int y, int w, int h );
 	void framebufferUpdateComplete();
 	void framebufferSizeChanged( int w, int h );
+	void scaledFramebufferUpdated();
 	void cursorPosChanged( int x, int y );
 	void cursorShapeUpdated( const QPixmap& cursorShape, int xh, int yh );
 	void gotCut( const QString& text );
@@ -173,17 +244,26 @@ protected:
 	void run() override;
 
 private:
+	friend class VncConnectionReactorThread;
+	friend class VncConnectionScheduler;
+
 	// RFB parameters
 	using RfbPixel = uint32_t;
 	static constexpr int RfbBitsPerSample = 8;
 	static constexpr int RfbSamplesPerPixel = 3;
 	static constexpr int RfbBytesPerPixel = sizeof(RfbPixel);
 	static constexpr int RfbLogMessageMaxLength = 256;
+	static constexpr qint64 MaximumTlsWriteBufferSize = 16384;
+	static constexpr int StatisticsInterval = 1000;
+
+	// maximum amount of data received per connection and iteration of a shared I/O thread
+	static constexpr qint64 ReactorReceiveChunkSize = 256*1024;
+	// shared I/O threads have no event loop so pending writes have to be retried
+	static constexpr int ReactorWriteRetryInterval = 10;
 
 	static RfbLogMessageReader s_rfbLogMessageReader;
 
 	enum class ControlFlag {
-		ScaledFramebufferNeedsUpdate = 0x01,
 		ServerReachable = 0x02,
 		TerminateThread = 0x04,
 		RestartConnection = 0x08,
@@ -191,7 +271,10 @@ private:
 		SkipHostPing = 0x20,
 		RequiresManualUpdateRateControl = 0x40,
 		TriggerFramebufferUpdate = 0x80,
-		SkipFramebufferUpdates = 0x100
+		SkipFramebufferUpdates = 0x100,
+		QualityChanged = 0x200,
+		ContinuousFramebufferUpdates = 0x400,
+		RequiresDedicatedThread = 0x800
 	};
 
 	using RfbLogMessage = std::array<char, RfbLogMessageMaxLength>;
@@ -202,6 +285,21 @@ private:
 	void handleConnection();
 	void closeConnection();
 
+	bool handleServerMessages();
+	void handleFramebufferUpdateTimers();
+	bool isSessionActive();
+
+	// shared I/O thread support
+	bool attachToReactor();
+	int reactorSocket() const;
+	int reactorSessionTimeout();
+	bool isReactorServiceDue();
+	bool serviceReactorSession( bool readable );
+	bool handleFramedServerMessages();
+	void finishReactorSession();
+
+	void wakeUp();
+
 	void setState( State state );
 
 	void setControlFlag( ControlFlag flag, bool on );
@@ -210,11 +308,28 @@ private:
 	rfbBool initFrameBuffer( rfbClient* client );
 	void requestFrameufferUpdate(FramebufferUpdateType updateType);
 	void finishFrameBufferUpdate();
+	void pipelineFramebufferUpdateRequests();
+	void updateStatistics();
+	void markImageUpdated( int x, int y, int w, int h );
+
+	void updateScaledFramebuffer();
+	static void rescaleFramebufferRect( const QImage& source, QImage& target, const QRect& rect );
 
 	void updateEncodingSettingsFromQuality();
+	void applyQualityChange();
+
+	VncConnectionConfiguration::PixelFormat pixelFormatForQuality() const;
+	void setPixelFormat( VncConnectionConfiguration::PixelFormat pixelFormat );
+	void expandFramebufferRect( const QRect& rect );
+	static int bitsPerPixel( VncConnectionConfiguration::PixelFormat pixelFormat );
+	static void expandPixels( const uint8_t* source, RfbPixel* target, int count,
+							  VncConnectionConfiguration::PixelFormat pixelFormat );
+	static void reducePixels( const RfbPixel* source, uint8_t* target, int count,
+							  VncConnectionConfiguration::PixelFormat pixelFormat );
 
 	rfbBool updateCursorPosition( int x, int y );
 	void updateCursorShape( rfbClient* client, int xh, int yh, int w, int h, int bpp );
+	QImage convertCursorShape( rfbClient* client, int w, int h, int bpp ) const;
 	void updateClipboard( const char *text, int textlen );
 
 	void sendEvents();
@@ -230,7 +345,9 @@ private:
 	rfbSocket openTlsSocket( const char* hostname, int port );
 	int readFromTlsSocket( char* buffer, unsigned int len );
 	int writeToTlsSocket( const char* buffer, unsigned int len );
+	void flushTlsSocket();
 	void closeTlsSocket();
+	void releaseHandshakeSlot();
 
 	// intervals and timeouts
 	int m_threadTerminationTimeout{VncConnectionConfiguration::DefaultThreadTerminationTimeout};
@@ -243,6 +360,7 @@ private:
 	int m_socketKeepaliveIdleTime{VncConnectionConfiguration::DefaultSocketKeepaliveIdleTime};
 	int m_socketKeepaliveInterval{VncConnectionConfiguration::DefaultSocketKeepaliveInterval};
 	int m_socketKeepaliveCount{VncConnectionConfiguration::DefaultSocketKeepaliveCount};
+	int m_framebufferUpdatesInFlight{VncConnectionConfiguration::DefaultFramebufferUpdatesInFlight};
 
 	// states and flags
 	std::atomic<State> m_state{State::Disconnected};
@@ -250,30 +368,65 @@ private:
 	QAtomicInteger<uint> m_controlFlags{};
 
 	QSslSocket* m_sslSocket{nullptr};
+	VncConnectionReactor* m_reactor{nullptr};
+	std::atomic<VncConnectionReactorThread *> m_reactorThread{nullptr};
+	std::atomic<bool> m_reactorServiceRequested{false};
+	VncServerMessageFramer m_serverMessageFramer{};
+	QElapsedTimer m_serverMessageTimer{};
+	VncConnectionScheduler* m_scheduler{nullptr};
+	bool m_handshakeSlotAcquired{false};
 	const bool m_verifyServerCertificate{true};
 
 	// connection parameters and data
 	rfbClient* m_client{nullptr};
-	VncConnectionConfiguration::Quality m_quality = VncConnectionConfiguration::Quality::Highest;
+	std::atomic<VncConnectionConfiguration::Quality> m_quality{VncConnectionConfiguration::Quality::Highest};
+	std::atomic<VncConnectionConfiguration::Quality> m_minimumQuality{VncConnectionConfiguration::Quality::Highest};
+	std::atomic<bool> m_reducedColorDepth{false};
+	VncConnectionConfiguration::PixelFormat m_pixelFormat{VncConnectionConfiguration::PixelFormat::RGB888};
+	VncEncodingController m_encodingController{};
 	QString m_host{};
 	int m_port{-1};
 	int m_defaultPort{-1};
 	bool m_useRemoteCursor{false};
+	std::atomic<Priority> m_priority{Priority::Visible};
 
 	// thread and timing control
 	QMutex m_globalMutex{};
-	QMutex m_eventQueueMutex{};
 	QWaitCondition m_updateIntervalSleeper{};
 	QAtomicInt m_framebufferUpdateInterval{0};
 	QElapsedTimer m_framebufferUpdateWatchdog{};
+	int m_pipelinedFramebufferUpdateRequests{0};
+
+	// transport statistics, counters are updated per read/write, everything else once per framebuffer update
+	std::atomic<quint64> m_bytesReceived{0};
+	std::atomic<quint64> m_bytesSent{0};
+	std::atomic<quint64> m_socketWrites{0};
+	std::atomic<quint64> m_socketFlushes{0};
+	mutable QMutex m_statisticsMutex{};
+	Statistics m_statistics{};
+	QElapsedTimer m_statisticsTimer{};
+	quint64 m_statisticsIntervalUpdates{0};
+	quint64 m_statisticsIntervalBytesReceived{0};
+	quint64 m_statisticsUpdateBytesReceived{0};
 
 	// queue for RFB and custom events
-	QQueue<VncEvent *> m_eventQueue{};
+	VncEventQueue m_eventQueue{};
 
 	// framebuffer data and thread synchronization objects
 	QImage m_image{};
+	RfbPixel* m_imageData{nullptr};
+	std::vector<uint8_t> m_reducedFramebuffer{};
+	QReadWriteLock m_imgLock{};
+
+	// scaled framebuffer data, updated incrementally by a worker thread
+	static constexpr int MaximumIncrementalRescaleRectCount = 64;
+	QMutex m_scaledFramebufferMutex{};
 	QImage m_scaledFramebuffer{};
+	QImage m_scaledFramebufferBuffer{};
 	QSize m_scaledSize{};
-	QReadWriteLock m_imgLock{};
+	QRegion m_damagedRegion{};
+	bool m_fullRescaleRequired{true};
+	bool m_scaledFramebufferUpdateRunning{false};
+	QFuture<void> m_scaledFramebufferUpdate{};
 
 } ;
@@ -40,6 +40,15 @@ public:
 	};
 	Q_ENUM(Quality)
 
+	// pixel formats requested from the server, decoded framebuffers are always expanded to 32 bit
+	enum class PixelFormat
+	{
+		RGB888,
+		RGB565,
+		BGR233
+	};
+	Q_ENUM(PixelFormat)
+
 	// intervals and timeouts
 	static constexpr int DefaultThreadTerminationTimeout = 30000;
 	static constexpr int DefaultConnectTimeout = 10000;
@@ -52,4 +61,14 @@ public:
 	static constexpr int DefaultSocketKeepaliveInterval = 500;
 	static constexpr int DefaultSocketKeepaliveCount = 5;
 
+	// number of update requests kept pending in live mode if the server does not send updates continuously
+	static constexpr int DefaultFramebufferUpdatesInFlight = 2;
+
+	// number of shared I/O threads serving all connections (0 = one thread per connection)
+	static constexpr int DefaultIoThreadCount = 0;
+
+	// connection storm control (0 = unlimited concurrent connection attempts)
+	static constexpr int DefaultMaximumConcurrentHandshakes = 16;
+	static constexpr int DefaultMaximumConnectionRetryInterval = 30000;
+
 } ;
@@ -0,0 +1,314 @@
+/*
+ * VncConnectionReactor.cpp - implementation of VncConnectionReactor class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <array>
+
+#include <QMutexLocker>
+#include <QSet>
+
+#ifdef Q_OS_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "VeyonConfiguration.h"
+#include "VncConnection.h"
+#include "VncConnectionReactor.h"
+
+
+VncConnectionReactor* VncConnectionReactor::s_instance = nullptr;
+
+
+VncConnectionReactorThread::VncConnectionReactorThread()
+{
+#ifdef Q_OS_LINUX
+	m_epollFd = epoll_create1( EPOLL_CLOEXEC );
+	m_wakeUpFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+
+	if( m_epollFd < 0 || m_wakeUpFd < 0 )
+	{
+		vCritical() << "failed to set up epoll instance" << errno;
+		return;
+	}
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.ptr = nullptr;
+	epoll_ctl( m_epollFd, EPOLL_CTL_ADD, m_wakeUpFd, &event );
+#endif
+}
+
+
+
+VncConnectionReactorThread::~VncConnectionReactorThread()
+{
+	stop();
+
+#ifdef Q_OS_LINUX
+	if( m_wakeUpFd >= 0 )
+	{
+		::close( m_wakeUpFd );
+	}
+
+	if( m_epollFd >= 0 )
+	{
+		::close( m_epollFd );
+	}
+#endif
+}
+
+
+
+void VncConnectionReactorThread::attach( VncConnection* connection )
+{
+	m_pendingConnectionsMutex.lock();
+	m_pendingConnections.append( connection );
+	m_pendingConnectionsMutex.unlock();
+
+	++m_connectionCount;
+
+	wakeUp();
+}
+
+
+
+void VncConnectionReactorThread::wakeUp()
+{
+#ifdef Q_OS_LINUX
+	if( m_wakeUpFd >= 0 )
+	{
+		const uint64_t value = 1;
+		if( ::write( m_wakeUpFd, &value, sizeof(value) ) < 0 && errno != EAGAIN )
+		{
+			vWarning() << "failed to wake up I/O thread" << errno;
+		}
+	}
+#endif
+}
+
+
+
+void VncConnectionReactorThread::stop()
+{
+	if( isRunning() )
+	{
+		m_stopRequested = 1;
+		wakeUp();
+		wait();
+	}
+}
+
+
+
+void VncConnectionReactorThread::run()
+{
+#ifdef Q_OS_LINUX
+	std::array<epoll_event, MaximumEventCount> events{};
+	QSet<VncConnection *> readableConnections;
+
+	while( m_stopRequested == 0 )
+	{
+		addPendingConnections();
+
+		int waitTimeout = MaximumWaitTimeout;
+		for( auto connection : std::as_const(m_connections) )
+		{
+			waitTimeout = qMin( waitTimeout, connection->reactorSessionTimeout() );
+		}
+
+		const auto eventCount = epoll_wait( m_epollFd, events.data(), MaximumEventCount, waitTimeout );
+		if( eventCount < 0 && errno != EINTR )
+		{
+			vCritical() << "epoll_wait() failed" << errno;
+			break;
+		}
+
+		readableConnections.clear();
+
+		for( int i = 0; i < eventCount; ++i )
+		{
+			if( events[i].data.ptr )
+			{
+				readableConnections.insert( static_cast<VncConnection *>( events[i].data.ptr ) );
+			}
+			else
+			{
+				drainWakeUpEvents();
+			}
+		}
+
+		// only service connections with received data or pending work
+		for( auto it = m_connections.begin(); it != m_connections.end(); )
+		{
+			auto connection = *it;
+			const auto readable = readableConnections.contains( connection );
+
+			if( ( readable == false && connection->isReactorServiceDue() == false ) ||
+				connection->serviceReactorSession( readable ) )
+			{
+				++it;
+			}
+			else
+			{
+				it = m_connections.erase( it );
+				detach( connection );
+			}
+		}
+	}
+
+	addPendingConnections();
+
+	for( auto connection : std::as_const(m_connections) )
+	{
+		detach( connection );
+	}
+
+	m_connections.clear();
+#endif
+}
+
+
+
+void VncConnectionReactorThread::addPendingConnections()
+{
+	QMutexLocker locker( &m_pendingConnectionsMutex );
+
+#ifdef Q_OS_LINUX
+	for( auto connection : std::as_const(m_pendingConnections) )
+	{
+		epoll_event event{};
+		event.events = EPOLLIN | EPOLLRDHUP;
+		event.data.ptr = connection;
+
+		if( epoll_ctl( m_epollFd, EPOLL_CTL_ADD, connection->reactorSocket(), &event ) < 0 )
+		{
+			vWarning() << "failed to add socket of connection to" << connection->host() << "to epoll instance" << errno;
+		}
+
+		m_connections.append( connection );
+	}
+#endif
+
+	m_pendingConnections.clear();
+}
+
+
+
+void VncConnectionReactorThread::detach( VncConnection* connection )
+{
+#ifdef Q_OS_LINUX
+	epoll_ctl( m_epollFd, EPOLL_CTL_DEL, connection->reactorSocket(), nullptr );
+#endif
+
+	--m_connectionCount;
+
+	connection->finishReactorSession();
+}
+
+
+
+void VncConnectionReactorThread::drainWakeUpEvents()
+{
+#ifdef Q_OS_LINUX
+	uint64_t value = 0;
+	while( ::read( m_wakeUpFd, &value, sizeof(value) ) > 0 )
+	{
+	}
+#endif
+}
+
+
+
+VncConnectionReactor::VncConnectionReactor( int threadCount, QObject* parent ) :
+	QObject( parent )
+{
+	m_threads.reserve( threadCount );
+
+	for( int i = 0; i < threadCount; ++i )
+	{
+		auto thread = new VncConnectionReactorThread;
+		thread->setObjectName( QStringLiteral("VncConnectionReactorThread-%1").arg(i) );
+		thread->start();
+		m_threads.append( thread );
+	}
+}
+
+
+
+VncConnectionReactor::~VncConnectionReactor()
+{
+	if( s_instance == this )
+	{
+		s_instance = nullptr;
+	}
+
+	qDeleteAll( m_threads );
+}
+
+
+
+bool VncConnectionReactor::isSupported()
+{
+#ifdef Q_OS_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+VncConnectionReactor* VncConnectionReactor::instance()
+{
+	static QMutex instanceMutex;
+	QMutexLocker locker( &instanceMutex );
+
+	if( s_instance == nullptr && isSupported() &&
+		VeyonCore::config().useCustomVncConnectionSettings() &&
+		VeyonCore::config().vncConnectionIoThreadCount() > 0 )
+	{
+		s_instance = new VncConnectionReactor( VeyonCore::config().vncConnectionIoThreadCount(), VeyonCore::instance() );
+	}
+
+	return s_instance;
+}
+
+
+
+VncConnectionReactorThread* VncConnectionReactor::assignThread()
+{
+	// pick the thread currently serving the fewest connections
+	VncConnectionReactorThread* leastBusyThread = nullptr;
+
+	for( auto thread : std::as_const(m_threads) )
+	{
+		if( leastBusyThread == nullptr || thread->connectionCount() < leastBusyThread->connectionCount() )
+		{
+			leastBusyThread = thread;
+		}
+	}
+
+	return leastBusyThread;
+}
@@ -0,0 +1,98 @@
+/*
+ * VncConnectionReactor.h - declaration of VncConnectionReactor class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+#include "VeyonCore.h"
+
+class VncConnection;
+
+// I/O thread multiplexing the sockets of all attached VncConnection instances
+class VncConnectionReactorThread : public QThread
+{
+public:
+	VncConnectionReactorThread();
+	~VncConnectionReactorThread() override;
+
+	void attach( VncConnection* connection );
+	void wakeUp();
+	void stop();
+
+	int connectionCount() const
+	{
+		return m_connectionCount;
+	}
+
+protected:
+	void run() override;
+
+private:
+	static constexpr int MaximumEventCount = 64;
+	static constexpr int MaximumWaitTimeout = 1000;
+
+	void addPendingConnections();
+	void detach( VncConnection* connection );
+	void drainWakeUpEvents();
+
+	int m_epollFd{-1};
+	int m_wakeUpFd{-1};
+
+	QMutex m_pendingConnectionsMutex{};
+	QVector<VncConnection *> m_pendingConnections{};
+	QVector<VncConnection *> m_connections{};
+	QAtomicInt m_connectionCount{0};
+	QAtomicInt m_stopRequested{0};
+
+};
+
+
+class VEYON_CORE_EXPORT VncConnectionReactor : public QObject
+{
+	Q_OBJECT
+public:
+	explicit VncConnectionReactor( int threadCount, QObject* parent = nullptr );
+	~VncConnectionReactor() override;
+
+	static bool isSupported();
+
+	// returns nullptr if shared I/O threads are disabled or not supported on this platform
+	static VncConnectionReactor* instance();
+
+	int threadCount() const
+	{
+		return m_threads.size();
+	}
+
+	VncConnectionReactorThread* assignThread();
+
+private:
+	static VncConnectionReactor* s_instance;
+
+	QVector<VncConnectionReactorThread *> m_threads;
+
+};
@@ -0,0 +1,216 @@
+/*
+ * VncConnectionScheduler.cpp - implementation of VncConnectionScheduler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <algorithm>
+
+#include <QRandomGenerator>
+
+#include "VeyonConfiguration.h"
+#include "VncConnection.h"
+#include "VncConnectionScheduler.h"
+
+
+VncConnectionScheduler::VncConnectionScheduler() :
+	m_maximumConcurrentHandshakes( VncConnectionConfiguration::DefaultMaximumConcurrentHandshakes ),
+	m_maximumRetryInterval( VncConnectionConfiguration::DefaultMaximumConnectionRetryInterval )
+{
+	if( VeyonCore::config().useCustomVncConnectionSettings() )
+	{
+		m_maximumConcurrentHandshakes = VeyonCore::config().vncConnectionMaximumConcurrentHandshakes();
+		m_maximumRetryInterval = VeyonCore::config().vncConnectionMaximumRetryInterval();
+	}
+
+	m_clock.start();
+}
+
+
+
+VncConnectionScheduler* VncConnectionScheduler::instance()
+{
+	static VncConnectionScheduler scheduler;
+	return &scheduler;
+}
+
+
+
+bool VncConnectionScheduler::beginHandshake( VncConnection* connection )
+{
+	QElapsedTimer queueTimer;
+	queueTimer.start();
+
+	QMutexLocker locker( &m_mutex );
+
+	m_waiters.append( { connection, m_nextSequence++ } );
+
+	while( m_maximumConcurrentHandshakes > 0 &&
+		   ( m_activeHandshakes >= m_maximumConcurrentHandshakes || isNextWaiter( connection ) == false ) )
+	{
+		if( connection->isControlFlagSet( VncConnection::ControlFlag::TerminateThread ) )
+		{
+			removeWaiter( connection );
+			// another waiter may be next now
+			m_slotReleased.wakeAll();
+			return false;
+		}
+
+		m_slotReleased.wait( &m_mutex, CancelCheckInterval );
+	}
+
+	removeWaiter( connection );
+
+	++m_activeHandshakes;
+	++m_statistics.handshakes;
+
+	const auto queueTime = queueTimer.elapsed();
+	m_totalQueueTime += queueTime;
+	m_statistics.maximumQueueTime = qMax( m_statistics.maximumQueueTime, queueTime );
+
+	// let the next waiter check whether there's another free slot
+	m_slotReleased.wakeAll();
+
+	return true;
+}
+
+
+
+void VncConnectionScheduler::endHandshake()
+{
+	QMutexLocker locker( &m_mutex );
+
+	--m_activeHandshakes;
+
+	m_slotReleased.wakeAll();
+}
+
+
+
+void VncConnectionScheduler::finishConnectionAttempt( const QString& host, bool connected, qint64 connectTime )
+{
+	QMutexLocker locker( &m_mutex );
+
+	if( connected )
+	{
+		++m_statistics.successes;
+		m_totalConnectTime += connectTime;
+		m_statistics.maximumConnectTime = qMax( m_statistics.maximumConnectTime, connectTime );
+
+		m_hostFailures.remove( host );
+	}
+	else
+	{
+		++m_statistics.failures;
+
+		auto& failures = m_hostFailures[host];
+		if( failures.count++ > 0 )
+		{
+			++m_statistics.retries;
+		}
+		failures.lastFailure = m_clock.elapsed();
+	}
+
+	pruneHostFailures();
+}
+
+
+
+int VncConnectionScheduler::retryInterval( const QString& host, int baseInterval )
+{
+	QMutexLocker locker( &m_mutex );
+
+	const auto failureCount = m_hostFailures.value( host ).count;
+	if( failureCount <= 1 || baseInterval <= 0 )
+	{
+		return baseInterval;
+	}
+
+	const auto interval = qMin<qint64>( qint64(baseInterval) << qMin( failureCount - 1, MaximumBackoffExponent ),
+										qMax( baseInterval, m_maximumRetryInterval ) );
+
+	// spread reconnects of hosts which failed at the same time (e.g. a rebooting computer room)
+	return int( interval / 2 + QRandomGenerator::global()->bounded( interval / 2 + 1 ) );
+}
+
+
+
+VncConnectionScheduler::Statistics VncConnectionScheduler::statistics() const
+{
+	QMutexLocker locker( &m_mutex );
+
+	auto statistics = m_statistics;
+	statistics.activeHandshakes = m_activeHandshakes;
+	statistics.waitingConnections = m_waiters.size();
+	statistics.backedOffHosts = m_hostFailures.size();
+	statistics.averageConnectTime = statistics.successes > 0 ? m_totalConnectTime / qint64(statistics.successes) : 0;
+	statistics.averageQueueTime = statistics.handshakes > 0 ? m_totalQueueTime / qint64(statistics.handshakes) : 0;
+
+	return statistics;
+}
+
+
+
+bool VncConnectionScheduler::isNextWaiter( const VncConnection* connection ) const
+{
+	// connections with higher priority go first, otherwise first come first served
+	const Waiter* next = nullptr;
+	for( const auto& waiter : m_waiters )
+	{
+		if( next == nullptr ||
+			waiter.connection->priority() > next->connection->priority() ||
+			( waiter.connection->priority() == next->connection->priority() && waiter.sequence < next->sequence ) )
+		{
+			next = &waiter;
+		}
+	}
+
+	return next && next->connection == connection;
+}
+
+
+
+void VncConnectionScheduler::removeWaiter( const VncConnection* connection )
+{
+	m_waiters.erase( std::remove_if( m_waiters.begin(), m_waiters.end(), [connection]( const Waiter& waiter ) {
+		return waiter.connection == connection;
+	} ), m_waiters.end() );
+}
+
+
+
+void VncConnectionScheduler::pruneHostFailures()
+{
+	// failing hosts are retried within the maximum retry interval
+	const auto expiredFailure = m_clock.elapsed() - qMax( 4 * qint64(m_maximumRetryInterval), qint64(MinimumHostFailureExpiryTime) );
+
+	for( auto it = m_hostFailures.begin(); it != m_hostFailures.end(); )
+	{
+		if( it->lastFailure < expiredFailure )
+		{
+			it = m_hostFailures.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
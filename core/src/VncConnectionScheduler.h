@@ -0,0 +1,112 @@
+/*
+ * VncConnectionScheduler.h - declaration of VncConnectionScheduler class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "VeyonCore.h"
+
+class VncConnection;
+
+// limits the number of concurrent TLS/authentication handshakes of all VncConnection instances
+// and delays reconnects to unreachable hosts with exponential backoff
+class VEYON_CORE_EXPORT VncConnectionScheduler
+{
+public:
+	struct Statistics
+	{
+		int activeHandshakes{0};
+		int waitingConnections{0};
+		int backedOffHosts{0};
+		quint64 handshakes{0};
+		quint64 successes{0};
+		quint64 failures{0};
+		quint64 retries{0};
+		qint64 averageConnectTime{0};	// milliseconds from starting to connect to established connection
+		qint64 maximumConnectTime{0};
+		qint64 averageQueueTime{0};		// milliseconds waiting for a free handshake slot
+		qint64 maximumQueueTime{0};
+	};
+
+	static VncConnectionScheduler* instance();
+
+	/** \brief Blocks until the connection may start the handshakes with a server it is connected to already,
+	 * returns false if the connection is being stopped */
+	bool beginHandshake( VncConnection* connection );
+	void endHandshake();
+
+	/** \brief Records the result of a connection attempt including TCP connects which failed before beginHandshake() */
+	void finishConnectionAttempt( const QString& host, bool connected, qint64 connectTime );
+
+	/** \brief Returns the randomized interval to wait before reconnecting to the given host */
+	int retryInterval( const QString& host, int baseInterval );
+
+	Statistics statistics() const;
+
+private:
+	static constexpr int CancelCheckInterval = 100;
+	static constexpr int MaximumBackoffExponent = 16;
+	// forget failures of hosts which are not retried anymore, e.g. because they have been removed
+	static constexpr int MinimumHostFailureExpiryTime = 60000;
+
+	struct Waiter
+	{
+		VncConnection* connection;
+		quint64 sequence;
+	};
+
+	struct HostFailures
+	{
+		int count{0};
+		qint64 lastFailure{0};
+	};
+
+	VncConnectionScheduler();
+
+	bool isNextWaiter( const VncConnection* connection ) const;
+	void removeWaiter( const VncConnection* connection );
+	void pruneHostFailures();
+
+	int m_maximumConcurrentHandshakes;
+	int m_maximumRetryInterval;
+
+	mutable QMutex m_mutex{};
+	QWaitCondition m_slotReleased{};
+	int m_activeHandshakes{0};
+	QVector<Waiter> m_waiters{};
+	quint64 m_nextSequence{0};
+
+	QElapsedTimer m_clock{};
+	QHash<QString, HostFailures> m_hostFailures{};
+
+	Statistics m_statistics{};
+	qint64 m_totalConnectTime{0};
+	qint64 m_totalQueueTime{0};
+
+};
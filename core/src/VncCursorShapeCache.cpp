@@ -0,0 +1,106 @@
+/*
+ * VncCursorShapeCache.cpp - implementation of VncCursorShapeCache class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <array>
+
+#include <QCryptographicHash>
+
+#include "VncCursorShapeCache.h"
+
+
+VncCursorShapeCache::VncCursorShapeCache() :
+	m_cache( DefaultMaximumSize )
+{
+}
+
+
+
+VncCursorShapeCache* VncCursorShapeCache::instance()
+{
+	static VncCursorShapeCache cache;
+	return &cache;
+}
+
+
+
+QByteArray VncCursorShapeCache::key( const QByteArray& source, const QByteArray& mask, QSize size, QPoint hotSpot, int format )
+{
+	const std::array<qint32, 5> header{ { size.width(), size.height(), hotSpot.x(), hotSpot.y(), format } };
+
+	QCryptographicHash hash( QCryptographicHash::Sha1 );
+	hash.addData( reinterpret_cast<const char *>( header.data() ), int(sizeof(header)) );
+	hash.addData( source );
+	hash.addData( mask );
+
+	return hash.result();
+}
+
+
+
+QImage VncCursorShapeCache::find( const QByteArray& key )
+{
+	QMutexLocker locker( &m_mutex );
+
+	++m_statistics.lookups;
+
+	const auto cursorShape = m_cache.object( key );
+	if( cursorShape == nullptr )
+	{
+		return {};
+	}
+
+	++m_statistics.hits;
+	m_statistics.savedBytes += quint64( cost( *cursorShape ) );
+
+	return *cursorShape;
+}
+
+
+
+void VncCursorShapeCache::insert( const QByteArray& key, const QImage& cursorShape )
+{
+	QMutexLocker locker( &m_mutex );
+
+	m_cache.insert( key, new QImage( cursorShape ), cost( cursorShape ) );
+}
+
+
+
+VncCursorShapeCache::Statistics VncCursorShapeCache::statistics() const
+{
+	QMutexLocker locker( &m_mutex );
+
+	auto statistics = m_statistics;
+	statistics.entries = int(m_cache.count());
+	statistics.cachedBytes = qint64(m_cache.totalCost());
+
+	return statistics;
+}
+
+
+
+int VncCursorShapeCache::cost( const QImage& cursorShape )
+{
+	return qMax( 1, cursorShape.width() * cursorShape.height() * cursorShape.depth() / 8 );
+}
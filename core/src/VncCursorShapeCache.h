@@ -0,0 +1,70 @@
+/*
+ * VncCursorShapeCache.h - declaration of VncCursorShapeCache class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+
+#include "VeyonCore.h"
+
+// process-wide cache of cursor shapes received by all VncConnection instances - usually
+// all computers send the same few cursor shapes so they're converted and stored only once;
+// images are stored instead of pixmaps as the cache outlives the QGuiApplication instance
+class VEYON_CORE_EXPORT VncCursorShapeCache
+{
+public:
+	struct Statistics
+	{
+		quint64 lookups{0};
+		quint64 hits{0};
+		int entries{0};
+		qint64 cachedBytes{0};
+		quint64 savedBytes{0};	// image data which would have been allocated for cache hits otherwise
+	};
+
+	static constexpr int DefaultMaximumSize = 4*1024*1024;
+
+	static VncCursorShapeCache* instance();
+
+	static QByteArray key( const QByteArray& source, const QByteArray& mask, QSize size, QPoint hotSpot, int format );
+
+	/** \brief Returns the cached cursor shape for the given key or a null image */
+	QImage find( const QByteArray& key );
+	void insert( const QByteArray& key, const QImage& cursorShape );
+
+	Statistics statistics() const;
+
+private:
+	VncCursorShapeCache();
+
+	static int cost( const QImage& cursorShape );
+
+	mutable QMutex m_mutex{};
+	QCache<QByteArray, QImage> m_cache;
+
+	Statistics m_statistics{};
+
+};
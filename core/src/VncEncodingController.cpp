@@ -0,0 +1,183 @@
+/*
+ * VncEncodingController.cpp - implementation of VncEncodingController class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include "VncEncodingController.h"
+
+
+void VncEncodingController::setQualityRange( Quality bestQuality, Quality worstQuality )
+{
+	// quality values are ordered from highest to lowest
+	worstQuality = qMax( bestQuality, worstQuality );
+
+	if( bestQuality == m_bestQuality && worstQuality == m_worstQuality )
+	{
+		return;
+	}
+
+	m_bestQuality = bestQuality;
+	m_worstQuality = worstQuality;
+
+	m_quality = bestQuality;
+	m_compressLevel = isAdaptive() ? MediumCompressLevel : DefaultCompressLevel;
+
+	m_throughput = 0;
+	m_roundTripTime = 0;
+	m_minimumRoundTripTime = 0;
+	m_roundTripTimeSampled = false;
+	m_transferTime = 0;
+	m_decodeTime = 0;
+	m_fastLinkIntervalCount = 0;
+	m_requestTimer.invalidate();
+	m_adjustmentTimer.start();
+}
+
+
+
+void VncEncodingController::updateRequested( bool incremental )
+{
+	// the server defers replies to incremental requests until the screen changes, so
+	// only the replies to full requests tell the actual round trip time
+	if( incremental == false && m_requestTimer.isValid() == false )
+	{
+		m_requestTimer.start();
+	}
+}
+
+
+
+void VncEncodingController::beginMessage()
+{
+	m_messageTimer.start();
+	m_messageBytes = 0;
+	m_messageWaitTime = 0;
+	m_updateFinished = false;
+}
+
+
+
+void VncEncodingController::addReceivedData( qint64 bytes, qint64 waitTime )
+{
+	m_messageBytes += bytes;
+	m_messageWaitTime += waitTime;
+}
+
+
+
+void VncEncodingController::finishUpdate()
+{
+	m_updateFinished = true;
+
+	if( m_requestTimer.isValid() && m_messageTimer.isValid() )
+	{
+		// time between sending the request and starting to receive the update
+		const auto roundTripTime = qMax<qint64>( 0, m_requestTimer.nsecsElapsed() - m_messageTimer.nsecsElapsed() );
+
+		m_roundTripTime = smoothed( m_roundTripTime, roundTripTime );
+		m_minimumRoundTripTime = m_minimumRoundTripTime > 0 ? qMin( m_minimumRoundTripTime, roundTripTime ) : roundTripTime;
+		m_roundTripTimeSampled = true;
+
+		m_requestTimer.invalidate();
+	}
+}
+
+
+
+bool VncEncodingController::endMessage()
+{
+	if( m_updateFinished == false || m_messageTimer.isValid() == false )
+	{
+		return false;
+	}
+
+	m_updateFinished = false;
+
+	const auto transferTime = m_messageTimer.nsecsElapsed();
+
+	// everything not spent waiting for data is spent decoding it
+	m_transferTime = smoothed( m_transferTime, transferTime );
+	m_decodeTime = smoothed( m_decodeTime, qMax<qint64>( 0, transferTime - m_messageWaitTime ) );
+
+	// small updates are dominated by latency and do not tell anything about the link speed
+	if( m_messageBytes >= MinimumThroughputSampleSize )
+	{
+		const auto networkTime = qMax<qint64>( m_messageWaitTime, 1000 * 1000 );
+		m_throughput = smoothed( m_throughput, m_messageBytes * 1000 * 1000 * 1000 / networkTime );
+	}
+
+	// measurements are also used for connection statistics, so only skip adjusting the settings
+	if( isAdaptive() == false ||
+		( m_adjustmentTimer.isValid() && m_adjustmentTimer.elapsed() < AdjustmentInterval ) )
+	{
+		return false;
+	}
+
+	m_adjustmentTimer.start();
+
+	const auto previousQuality = m_quality;
+	const auto previousCompressLevel = m_compressLevel;
+
+	adjust();
+
+	return m_quality != previousQuality || m_compressLevel != previousCompressLevel;
+}
+
+
+
+void VncEncodingController::adjust()
+{
+	const auto decodeBound = m_decodeTime * 2 > m_transferTime;
+	// round trip times are sampled rarely, so only consider a sample taken since the last adjustment
+	const auto congested = ( m_throughput > 0 && m_throughput < SlowLinkThroughput ) ||
+						   ( m_roundTripTimeSampled && m_roundTripTime > 2 * m_minimumRoundTripTime + CongestionDelay );
+
+	m_roundTripTimeSampled = false;
+
+	if( congested )
+	{
+		m_fastLinkIntervalCount = 0;
+
+		// reducing the amount of data only helps if the connection is limited by the network
+		if( decodeBound == false )
+		{
+			m_compressLevel = HighCompressLevel;
+			m_quality = Quality( qMin( int(m_quality) + 1, int(m_worstQuality) ) );
+		}
+	}
+	else if( m_throughput >= FastLinkThroughput )
+	{
+		// bandwidth is plenty, so don't waste CPU time on compression and slowly return to best quality
+		m_compressLevel = LowCompressLevel;
+
+		if( ++m_fastLinkIntervalCount >= QualityIncreaseIntervalCount )
+		{
+			m_fastLinkIntervalCount = 0;
+			m_quality = Quality( qMax( int(m_quality) - 1, int(m_bestQuality) ) );
+		}
+	}
+	else
+	{
+		m_fastLinkIntervalCount = 0;
+		m_compressLevel = MediumCompressLevel;
+	}
+}
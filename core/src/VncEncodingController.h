@@ -0,0 +1,126 @@
+/*
+ * VncEncodingController.h - declaration of VncEncodingController class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+
+#include "VncConnectionConfiguration.h"
+
+// adjusts image quality and compression level of a VNC connection to the measured
+// network throughput, update round trip time and decoding time
+class VEYON_CORE_EXPORT VncEncodingController
+{
+public:
+	using Quality = VncConnectionConfiguration::Quality;
+
+	static constexpr int DefaultCompressLevel = 9;
+	static constexpr int LowCompressLevel = 1;
+	static constexpr int MediumCompressLevel = 6;
+	static constexpr int HighCompressLevel = 9;
+
+	static constexpr int AdjustmentInterval = 2000;
+	static constexpr int QualityIncreaseIntervalCount = 3;
+	static constexpr qint64 MinimumThroughputSampleSize = 16384;
+	static constexpr qint64 SlowLinkThroughput = 1024 * 1024;
+	static constexpr qint64 FastLinkThroughput = 10 * 1024 * 1024;
+	static constexpr qint64 CongestionDelay = 50 * 1000 * 1000;
+
+	VncEncodingController() = default;
+
+	/** \brief Sets the range the quality is adapted in, adaptive control is disabled if both are equal */
+	void setQualityRange( Quality bestQuality, Quality worstQuality );
+
+	bool isAdaptive() const
+	{
+		return m_bestQuality != m_worstQuality;
+	}
+
+	Quality quality() const
+	{
+		return m_quality;
+	}
+
+	int compressLevel() const
+	{
+		return m_compressLevel;
+	}
+
+	// smoothed measurements in bytes per second and nanoseconds
+	qint64 throughput() const
+	{
+		return m_throughput;
+	}
+
+	qint64 roundTripTime() const
+	{
+		return m_roundTripTime;
+	}
+
+	qint64 decodeTime() const
+	{
+		return m_decodeTime;
+	}
+
+	// measurement hooks, must only be called from the thread serving the connection
+	void updateRequested( bool incremental );
+	void beginMessage();
+	void addReceivedData( qint64 bytes, qint64 waitTime );
+	void finishUpdate();
+
+	/** \brief Returns true if quality or compression level have been changed after the current message */
+	bool endMessage();
+
+private:
+	static qint64 smoothed( qint64 average, qint64 sample )
+	{
+		return average > 0 ? ( 3 * average + sample ) / 4 : sample;
+	}
+
+	void adjust();
+
+	Quality m_bestQuality{Quality::Highest};
+	Quality m_worstQuality{Quality::Highest};
+	Quality m_quality{Quality::Highest};
+	int m_compressLevel{DefaultCompressLevel};
+
+	// current message
+	QElapsedTimer m_messageTimer{};
+	qint64 m_messageBytes{0};
+	qint64 m_messageWaitTime{0};
+	bool m_updateFinished{false};
+
+	// smoothed measurements (bytes per second and nanoseconds)
+	QElapsedTimer m_requestTimer{};
+	qint64 m_throughput{0};
+	qint64 m_roundTripTime{0};
+	qint64 m_minimumRoundTripTime{0};
+	bool m_roundTripTimeSampled{false};
+	qint64 m_transferTime{0};
+	qint64 m_decodeTime{0};
+
+	QElapsedTimer m_adjustmentTimer{};
+	int m_fastLinkIntervalCount{0};
+
+} ;
@@ -0,0 +1,315 @@
+/*
+ * VncEventQueue.cpp - implementation of VncEventQueue class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <rfb/rfbclient.h>
+
+#include <chrono>
+
+#include <QtMath>
+
+#include "VncEventQueue.h"
+#include "VncEvents.h"
+
+
+VncEventQueue::VncEventQueue( size_t capacity ) :
+	m_mask( size_t( qNextPowerOfTwo( quint64( qMax<size_t>( capacity, 2 ) - 1 ) ) ) - 1 ),
+	m_cells( new Cell[m_mask + 1] )
+{
+	for( size_t i = 0; i <= m_mask; ++i )
+	{
+		m_cells[i].sequence.store( i, std::memory_order_relaxed );
+	}
+}
+
+
+
+VncEventQueue::~VncEventQueue()
+{
+	sendEvents( nullptr );
+}
+
+
+
+void VncEventQueue::enqueuePointerEvent( int x, int y, uint buttonMask )
+{
+	Entry entry;
+	entry.type = EntryType::Pointer;
+	entry.x = x;
+	entry.y = y;
+	entry.buttonMask = buttonMask;
+
+	enqueue( entry );
+}
+
+
+
+void VncEventQueue::enqueueKeyEvent( uint key, bool pressed )
+{
+	Entry entry;
+	entry.type = EntryType::Key;
+	entry.key = key;
+	entry.pressed = pressed;
+
+	enqueue( entry );
+}
+
+
+
+void VncEventQueue::enqueueEvent( VncEvent* event )
+{
+	++m_allocatedEvents;
+
+	Entry entry;
+	entry.type = EntryType::Custom;
+	entry.event = event;
+
+	enqueue( entry );
+}
+
+
+
+void VncEventQueue::sendEvents( rfbClient* client )
+{
+	Entry entry;
+
+	forever
+	{
+		while( dequeue( entry ) )
+		{
+			sendEvent( client, entry );
+		}
+
+		if( m_overflowing.load( std::memory_order_acquire ) == false )
+		{
+			break;
+		}
+
+		// the ring buffer has been drained, so continue with the events which did not fit into
+		// it - producers use the ring buffer again afterwards as all older events are sent now
+		QVector<Entry> overflow;
+		m_overflowMutex.lock();
+		overflow.swap( m_overflow );
+		m_overflowing.store( false, std::memory_order_release );
+		m_overflowMutex.unlock();
+
+		for( const auto& overflowEntry : std::as_const(overflow) )
+		{
+			sendEvent( client, overflowEntry );
+		}
+	}
+}
+
+
+
+VncEventQueue::Statistics VncEventQueue::statistics() const
+{
+	Statistics statistics;
+	statistics.enqueuedEvents = m_enqueuedEvents;
+	statistics.coalescedEvents = m_coalescedEvents;
+	statistics.overflowedEvents = m_overflowedEvents;
+	statistics.sentEvents = m_sentEvents;
+	statistics.allocatedEvents = m_allocatedEvents;
+	statistics.averageLatency = statistics.sentEvents > 0 ? m_totalLatency / statistics.sentEvents : 0;
+	statistics.maximumLatency = m_maximumLatency;
+
+	return statistics;
+}
+
+
+
+qint64 VncEventQueue::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+
+void VncEventQueue::enqueue( Entry entry )
+{
+	entry.timestamp = now();
+
+	// keep the order of events by not using the ring buffer again before the overflow list has been drained
+	if( m_overflowing.load( std::memory_order_acquire ) == false && enqueueLockFree( entry ) )
+	{
+		++m_enqueuedEvents;
+		return;
+	}
+
+	enqueueOverflow( entry );
+	++m_enqueuedEvents;
+}
+
+
+
+bool VncEventQueue::enqueueLockFree( const Entry& entry )
+{
+	auto position = m_enqueuePosition.load( std::memory_order_relaxed );
+	Cell* cell = nullptr;
+
+	forever
+	{
+		cell = &m_cells[position & m_mask];
+		const auto sequence = cell->sequence.load( std::memory_order_acquire );
+		const auto difference = qint64(sequence) - qint64(position);
+
+		if( difference == 0 )
+		{
+			if( m_enqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+			{
+				break;
+			}
+		}
+		else if( difference < 0 )
+		{
+			// ring buffer is full
+			return false;
+		}
+		else
+		{
+			position = m_enqueuePosition.load( std::memory_order_relaxed );
+		}
+	}
+
+	cell->entry = entry;
+	cell->sequence.store( position + 1, std::memory_order_release );
+
+	return true;
+}
+
+
+
+void VncEventQueue::enqueueOverflow( const Entry& entry )
+{
+	QMutexLocker locker( &m_overflowMutex );
+
+	// the connection does not keep up, so only keep the latest of consecutive pointer
+	// motions with unchanged buttons - key events and custom events are always kept
+	if( entry.type == EntryType::Pointer && m_overflow.isEmpty() == false &&
+		m_overflow.last().type == EntryType::Pointer && m_overflow.last().buttonMask == entry.buttonMask )
+	{
+		m_overflow.last().x = entry.x;
+		m_overflow.last().y = entry.y;
+		++m_coalescedEvents;
+	}
+	else
+	{
+		m_overflow.append( entry );
+	}
+
+	m_overflowing.store( true, std::memory_order_release );
+	++m_overflowedEvents;
+	++m_overflowWarningEvents;
+
+	const auto timestamp = entry.timestamp;
+	if( timestamp - m_lastOverflowWarning > OverflowWarningInterval )
+	{
+		vWarning() << "event queue full - deferred" << m_overflowWarningEvents << "events";
+		m_lastOverflowWarning = timestamp;
+		m_overflowWarningEvents = 0;
+	}
+}
+
+
+
+bool VncEventQueue::dequeue( Entry& entry )
+{
+	auto position = m_dequeuePosition.load( std::memory_order_relaxed );
+	auto cell = &m_cells[position & m_mask];
+
+	if( cell->sequence.load( std::memory_order_acquire ) != position + 1 )
+	{
+		return false;
+	}
+
+	entry = cell->entry;
+	cell->sequence.store( position + m_mask + 1, std::memory_order_release );
+	m_dequeuePosition.store( position + 1, std::memory_order_release );
+
+	// only send the latest of consecutive pointer motions with unchanged buttons
+	while( isNextCoalescable( entry ) )
+	{
+		++position;
+		cell = &m_cells[position & m_mask];
+
+		const auto timestamp = entry.timestamp;
+		entry = cell->entry;
+		entry.timestamp = timestamp;
+
+		cell->sequence.store( position + m_mask + 1, std::memory_order_release );
+		m_dequeuePosition.store( position + 1, std::memory_order_release );
+
+		++m_coalescedEvents;
+	}
+
+	return true;
+}
+
+
+
+bool VncEventQueue::isNextCoalescable( const Entry& entry ) const
+{
+	if( entry.type != EntryType::Pointer )
+	{
+		return false;
+	}
+
+	const auto position = m_dequeuePosition.load( std::memory_order_relaxed );
+	const auto& cell = m_cells[position & m_mask];
+
+	return cell.sequence.load( std::memory_order_acquire ) == position + 1 &&
+		   cell.entry.type == EntryType::Pointer &&
+		   cell.entry.buttonMask == entry.buttonMask;
+}
+
+
+
+void VncEventQueue::sendEvent( rfbClient* client, const Entry& entry )
+{
+	if( client )
+	{
+		switch( entry.type )
+		{
+		case EntryType::Pointer:
+			SendPointerEvent( client, entry.x, entry.y, int(entry.buttonMask) );
+			break;
+		case EntryType::Key:
+			SendKeyEvent( client, entry.key, entry.pressed ? TRUE : FALSE );
+			break;
+		case EntryType::Custom:
+			entry.event->fire( client );
+			break;
+		}
+
+		const auto latency = quint64( qMax<qint64>( 0, now() - entry.timestamp ) );
+		m_totalLatency += latency;
+		if( latency > m_maximumLatency )
+		{
+			m_maximumLatency = latency;
+		}
+		++m_sentEvents;
+	}
+
+	delete entry.event;
+}
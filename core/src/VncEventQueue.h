@@ -0,0 +1,139 @@
+/*
+ * VncEventQueue.h - declaration of VncEventQueue class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QMutex>
+#include <QVector>
+
+#include "VeyonCore.h"
+
+using rfbClient = struct _rfbClient;
+
+class VncEvent;
+
+// lock-free multi-producer/single-consumer queue for input and custom VNC events - events never
+// get lost or reordered: if the ring buffer is full, e.g. because the connection stalls, further
+// events are appended to a locked overflow list until the consumer has caught up
+class VEYON_CORE_EXPORT VncEventQueue
+{
+public:
+	static constexpr size_t DefaultCapacity = 1024;
+
+	struct Statistics
+	{
+		quint64 enqueuedEvents{0};
+		quint64 coalescedEvents{0};
+		quint64 overflowedEvents{0};
+		quint64 sentEvents{0};
+		quint64 allocatedEvents{0};
+		quint64 averageLatency{0};	// nanoseconds between enqueueing and sending
+		quint64 maximumLatency{0};
+	};
+
+	explicit VncEventQueue( size_t capacity = DefaultCapacity );
+	~VncEventQueue();
+
+	Q_DISABLE_COPY(VncEventQueue)
+
+	// producer side, may be called from any thread
+	void enqueuePointerEvent( int x, int y, uint buttonMask );
+	void enqueueKeyEvent( uint key, bool pressed );
+	void enqueueEvent( VncEvent* event );
+
+	bool isEmpty() const
+	{
+		return m_dequeuePosition.load( std::memory_order_acquire ) ==
+			   m_enqueuePosition.load( std::memory_order_acquire ) &&
+			   m_overflowing.load( std::memory_order_acquire ) == false;
+	}
+
+	// consumer side, must only be called from the thread serving the connection;
+	// discards all pending events if client is nullptr
+	void sendEvents( rfbClient* client );
+
+	Statistics statistics() const;
+
+private:
+	enum class EntryType : uint8_t
+	{
+		Pointer,
+		Key,
+		Custom
+	};
+
+	struct Entry
+	{
+		EntryType type{EntryType::Custom};
+		bool pressed{false};
+		int x{0};
+		int y{0};
+		uint buttonMask{0};
+		uint key{0};
+		VncEvent* event{nullptr};
+		qint64 timestamp{0};
+	};
+
+	struct Cell
+	{
+		std::atomic<size_t> sequence{0};
+		Entry entry{};
+	};
+
+	static constexpr qint64 OverflowWarningInterval = 10000000000LL; // nanoseconds
+
+	static qint64 now();
+
+	void enqueue( Entry entry );
+	bool enqueueLockFree( const Entry& entry );
+	void enqueueOverflow( const Entry& entry );
+	bool dequeue( Entry& entry );
+	bool isNextCoalescable( const Entry& entry ) const;
+	void sendEvent( rfbClient* client, const Entry& entry );
+
+	const size_t m_mask;
+	std::unique_ptr<Cell[]> m_cells;
+
+	alignas(64) std::atomic<size_t> m_enqueuePosition{0};
+	alignas(64) std::atomic<size_t> m_dequeuePosition{0};
+
+	// once set, all events are appended to the overflow list until the consumer has drained it
+	std::atomic<bool> m_overflowing{false};
+	QMutex m_overflowMutex{};
+	QVector<Entry> m_overflow{};
+	qint64 m_lastOverflowWarning{0};
+	quint64 m_overflowWarningEvents{0};
+
+	std::atomic<quint64> m_enqueuedEvents{0};
+	std::atomic<quint64> m_coalescedEvents{0};
+	std::atomic<quint64> m_overflowedEvents{0};
+	std::atomic<quint64> m_sentEvents{0};
+	std::atomic<quint64> m_allocatedEvents{0};
+	std::atomic<quint64> m_totalLatency{0};
+	std::atomic<quint64> m_maximumLatency{0};
+
+};
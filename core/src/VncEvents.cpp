@@ -27,36 +27,6 @@
 #include "VncEvents.h"
 
 
-VncKeyEvent::VncKeyEvent( unsigned int key, bool pressed ) :
-	m_key( key ),
-	m_pressed( pressed )
-{
-}
-
-
-void VncKeyEvent::fire( rfbClient* client )
-{
-	SendKeyEvent( client, m_key, m_pressed ? TRUE : FALSE );
-}
-
-
-
-VncPointerEvent::VncPointerEvent(int x, int y, uint buttonMask) :
-	m_x( x ),
-	m_y( y ),
-	m_buttonMask( buttonMask )
-{
-}
-
-
-
-void VncPointerEvent::fire(rfbClient *client)
-{
-	SendPointerEvent( client, m_x, m_y, int(m_buttonMask) );
-}
-
-
-
 VncClientCutEvent::VncClientCutEvent( const QString& text ) :
 	m_text( text.toUtf8() )
 {
@@ -39,33 +39,6 @@ public:
 } ;
 
 
-class VncKeyEvent : public VncEvent
-{
-public:
-	VncKeyEvent( unsigned int key, bool pressed );
-
-	void fire( rfbClient* client ) override;
-
-private:
-	unsigned int m_key;
-	bool m_pressed;
-} ;
-
-
-class VncPointerEvent : public VncEvent
-{
-public:
-	VncPointerEvent( int x, int y, uint buttonMask );
-
-	void fire( rfbClient* client ) override;
-
-private:
-	int m_x;
-	int m_y;
-	uint m_buttonMask;
-} ;
-
-
 class VncClientCutEvent : public VncEvent
 {
 public:
@@ -38,6 +38,7 @@ public:
 		Stage1,
 		Successful,
 		Failed,
+		Pending,
 	} ;
 	Q_ENUM(AuthState)
 
@@ -92,6 +93,17 @@ public:
 		m_authMethodUid = pluginUid;
 	}
 
+	// whether the client skipped the full authentication by presenting an authentication ticket
+	bool isAuthenticatedByTicket() const
+	{
+		return m_authenticatedByTicket;
+	}
+
+	void setAuthenticatedByTicket( bool authenticatedByTicket )
+	{
+		m_authenticatedByTicket = authenticatedByTicket;
+	}
+
 	AccessControlState accessControlState() const
 	{
 		return m_accessControlState;
@@ -158,18 +170,25 @@ public:
 	}
 
 public Q_SLOTS:
+	void finishAuthentication()
+	{
+		Q_EMIT authenticationFinished( this );
+	}
+
 	void finishAccessControl()
 	{
 		Q_EMIT accessControlFinished( this );
 	}
 
 Q_SIGNALS:
+	void authenticationFinished( VncServerClient* );
 	void accessControlFinished( VncServerClient* );
 
 private:
 	VncServerProtocol::State m_protocolState;
 	AuthState m_authState;
 	Plugin::Uid m_authMethodUid;
+	bool m_authenticatedByTicket{false};
 	AccessControlState m_accessControlState;
 	QString m_accessControlDetails;
 	QElapsedTimer m_accessControlTimer;
@@ -0,0 +1,184 @@
+/*
+ * VncServerMessageFramer.cpp - implementation of VncServerMessageFramer class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <cstring>
+
+#include <QtEndian>
+
+#include "FeatureMessage.h"
+#include "VncServerMessageFramer.h"
+
+
+VncServerMessageFramer::VncServerMessageFramer() :
+	VncClientProtocol( &m_device, {} )
+{
+	reset();
+}
+
+
+
+void VncServerMessageFramer::reset()
+{
+	m_device.close();
+
+	m_buffer.clear();
+	m_framedOffset = 0;
+	m_readOffset = 0;
+
+	m_device.setBuffer( &m_buffer );
+	m_device.open( QBuffer::ReadOnly | QBuffer::Unbuffered );
+
+	// messages are received after the connection has been initialized by libvncclient
+	start();
+	setState( State::Running );
+}
+
+
+
+void VncServerMessageFramer::addData( const QByteArray& data )
+{
+	const auto position = m_device.pos();
+
+	m_buffer.append( data );
+
+	// QBuffer has to be notified about the changed size of the buffer
+	m_device.seek( position );
+}
+
+
+
+VncServerMessageFramer::Result VncServerMessageFramer::frameMessage( const rfbPixelFormat& pixelFormat )
+{
+	if( m_device.isOpen() == false )
+	{
+		return Result::Unsupported;
+	}
+
+	// a framebuffer update has been received partially so far
+	const auto updateInProgress = m_device.pos() > m_framedOffset;
+
+	if( updateInProgress == false )
+	{
+		uint8_t messageType = 0;
+		if( m_device.peek( reinterpret_cast<char *>( &messageType ), sizeof(messageType) ) != sizeof(messageType) )
+		{
+			return Result::Incomplete;
+		}
+
+		if( messageType == FeatureMessage::RfbMessageType )
+		{
+			return frameFeatureMessage();
+		}
+
+		if( messageType == rfbServerCutText )
+		{
+			rfbServerCutTextMsg message;
+			if( m_device.peek( reinterpret_cast<char *>( &message ), sz_rfbServerCutTextMsg ) != sz_rfbServerCutTextMsg )
+			{
+				return Result::Incomplete;
+			}
+
+			// negative lengths indicate extended clipboard messages which can't be framed
+			if( static_cast<int32_t>( qFromBigEndian( message.length ) ) < 0 )
+			{
+				return Result::Unsupported;
+			}
+		}
+
+		updatePixelFormat( pixelFormat );
+	}
+
+	if( receiveMessage() )
+	{
+		m_framedOffset = int(m_device.pos());
+		return Result::Complete;
+	}
+
+	return m_device.isOpen() ? Result::Incomplete : Result::Unsupported;
+}
+
+
+
+void VncServerMessageFramer::releaseData()
+{
+	m_framedOffset = int(m_buffer.size());
+	m_device.seek( m_framedOffset );
+}
+
+
+
+qint64 VncServerMessageFramer::readFramedData( char* data, qint64 size )
+{
+	const auto count = qMin( size, framedBytes() );
+	if( count <= 0 )
+	{
+		return 0;
+	}
+
+	memcpy( data, m_buffer.constData() + m_readOffset, size_t(count) );
+	m_readOffset += int(count);
+
+	// drop all data read so far once everything framed has been read
+	if( m_readOffset == m_framedOffset )
+	{
+		const auto position = m_device.pos() - m_readOffset;
+
+		m_buffer.remove( 0, m_readOffset );
+		m_framedOffset = 0;
+		m_readOffset = 0;
+
+		m_device.seek( position );
+	}
+
+	return count;
+}
+
+
+
+VncServerMessageFramer::Result VncServerMessageFramer::frameFeatureMessage()
+{
+	static constexpr auto HeaderSize = int(sizeof(uint8_t) + sizeof(quint32));
+
+	char header[HeaderSize];
+	if( m_device.peek( header, HeaderSize ) != HeaderSize )
+	{
+		return Result::Incomplete;
+	}
+
+	const auto messageSize = qFromBigEndian<quint32>( header + sizeof(uint8_t) );
+	if( messageSize > MaximumFeatureMessageSize )
+	{
+		return Result::Unsupported;
+	}
+
+	if( m_device.bytesAvailable() < HeaderSize + qint64(messageSize) )
+	{
+		return Result::Incomplete;
+	}
+
+	m_framedOffset = int(m_device.pos() + HeaderSize + messageSize);
+	m_device.seek( m_framedOffset );
+
+	return Result::Complete;
+}
@@ -0,0 +1,80 @@
+/*
+ * VncServerMessageFramer.h - declaration of VncServerMessageFramer class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QBuffer>
+
+#include "VncClientProtocol.h"
+
+// buffers data received from a VNC server and determines the boundaries of complete
+// server messages without decoding them so that they can be handed to libvncclient
+// without it ever having to wait for the remainder of a message
+class VncServerMessageFramer : protected VncClientProtocol
+{
+public:
+	enum class Result
+	{
+		Incomplete,
+		Complete,
+		Unsupported
+	};
+
+	VncServerMessageFramer();
+
+	void reset();
+
+	void addData( const QByteArray& data );
+
+	// frames the next message - framebuffer updates are parsed with the given pixel format
+	Result frameMessage( const rfbPixelFormat& pixelFormat );
+
+	// number of bytes of completely received messages which have not been read so far
+	qint64 framedBytes() const
+	{
+		return m_framedOffset - m_readOffset;
+	}
+
+	bool hasUnframedData() const
+	{
+		return m_buffer.size() > m_framedOffset;
+	}
+
+	// makes all received data readable regardless of message boundaries
+	void releaseData();
+
+	qint64 readFramedData( char* data, qint64 size );
+
+private:
+	// same limit as applied by VariantArrayMessage when receiving the message
+	static constexpr quint32 MaximumFeatureMessageSize = 1024*1024*32;
+
+	Result frameFeatureMessage();
+
+	QByteArray m_buffer{};
+	QBuffer m_device{};
+	int m_framedOffset{0};
+	int m_readOffset{0};
+
+} ;
@@ -240,6 +240,20 @@ bool VncServerProtocol::receiveAuthenticationMethodResponse()
 
 bool VncServerProtocol::receiveAuthenticationMessage()
 {
+	switch( m_client->authState() )
+	{
+	case VncServerClient::AuthState::Pending:
+		// wait for the asynchronous processing of the previous message to finish
+		return false;
+
+	case VncServerClient::AuthState::Successful:
+	case VncServerClient::AuthState::Failed:
+		return finishAuthentication();
+
+	default:
+		break;
+	}
+
 	VariantArrayMessage message( m_socket );
 
 	if( message.isReadyForReceive() && message.receive() )
@@ -256,6 +270,13 @@ bool VncServerProtocol::processAuthentication( VariantArrayMessage& message )
 {
 	processAuthenticationMessage( message );
 
+	return finishAuthentication();
+}
+
+
+
+bool VncServerProtocol::finishAuthentication()
+{
 	switch( m_client->authState() )
 	{
 	case VncServerClient::AuthState::Successful:
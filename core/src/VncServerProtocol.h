@@ -69,6 +69,8 @@ public:
 
 protected:
 	virtual AuthMethodUids supportedAuthMethodUids() const = 0;
+	// may set the client's auth state to Pending and finish asynchronously by updating the
+	// auth state and emitting VncServerClient::authenticationFinished() afterwards
 	virtual void processAuthenticationMessage( VariantArrayMessage& message ) = 0;
 	virtual void performAccessControl() = 0;
 
@@ -93,6 +95,7 @@ private:
 	bool receiveAuthenticationMessage();
 
 	bool processAuthentication( VariantArrayMessage& message );
+	bool finishAuthentication();
 	bool processAccessControl();
 
 	void sendFailedAccessControlMessage();
@@ -28,6 +28,7 @@
 #include "ComputerImageProvider.h"
 #include "ComputerManager.h"
 #include "FeatureManager.h"
+#include "FramebufferScaler.h"
 #include "PlatformSessionFunctions.h"
 #include "VeyonMaster.h"
 #include "UserConfig.h"
@@ -473,7 +474,7 @@ double ComputerControlListModel::averageAspectRatio() const
 
 QImage ComputerControlListModel::scaleAndAlignIcon( const QImage& icon, QSize size ) const
 {
-	const auto scaledIcon = icon.scaled( size.width(), size.height(), Qt::KeepAspectRatio );
+	const auto scaledIcon = FramebufferScaler::scaled( icon, size, Qt::KeepAspectRatio );
 
 	QImage scaledAndAlignedIcon( size, QImage::Format_ARGB32 );
 	scaledAndAlignedIcon.fill( Qt::transparent );
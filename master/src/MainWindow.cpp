@@ -46,6 +46,7 @@
 #include "NetworkObjectDirectoryManager.h"
 #include "SlideshowPanel.h"
 #include "SpotlightPanel.h"
+#include "TransportStatisticsPanel.h"
 #include "ToolButton.h"
 #include "VeyonConfiguration.h"
 #include "VeyonMaster.h"
@@ -99,6 +100,7 @@ MainWindow::MainWindow( VeyonMaster &masterCore, QWidget* parent ) :
 	auto screenshotManagementPanel = new ScreenshotManagementPanel();
 	auto slideshowPanel = new SlideshowPanel( m_master.userConfig(), ui->computerMonitoringWidget );
 	auto spotlightPanel = new SpotlightPanel( m_master.userConfig(), ui->computerMonitoringWidget );
+	auto transportStatisticsPanel = new TransportStatisticsPanel( m_master.computerControlListModel() );
 
 	slideshowSpotlightSplitter->addWidget( slideshowPanel );
 	slideshowSpotlightSplitter->addWidget( spotlightPanel );
@@ -113,6 +115,7 @@ MainWindow::MainWindow( VeyonMaster &masterCore, QWidget* parent ) :
 	mainSplitter->addWidget( computerSelectPanel );
 	mainSplitter->addWidget( screenshotManagementPanel );
 	mainSplitter->addWidget( monitoringSplitter );
+	mainSplitter->addWidget( transportStatisticsPanel );
 
 	mainSplitter->setStretchFactor( mainSplitter->indexOf(monitoringSplitter), 1 );
 
@@ -120,6 +123,7 @@ MainWindow::MainWindow( VeyonMaster &masterCore, QWidget* parent ) :
 	static const QHash<QWidget *, QAbstractButton *> panelButtons{
 		{ computerSelectPanel, ui->computerSelectPanelButton },
 		{ screenshotManagementPanel, ui->screenshotManagementPanelButton },
+		{ transportStatisticsPanel, ui->transportStatisticsPanelButton },
 		{ slideshowPanel, ui->slideshowPanelButton },
 		{ spotlightPanel, ui->spotlightPanelButton }
 	};
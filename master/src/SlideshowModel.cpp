@@ -23,6 +23,7 @@
  */
 
 #include "ComputerListModel.h"
+#include "FramebufferScaler.h"
 #include "SlideshowModel.h"
 
 
@@ -87,7 +88,7 @@ QVariant SlideshowModel::data( const QModelIndex& index, int role ) const
 			framebuffer = sourceModel()->data(sourceIndex, Qt::DecorationRole).value<QImage>();
 		}
 
-		return framebuffer.scaled(m_iconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		return FramebufferScaler::scaled(framebuffer, m_iconSize, Qt::KeepAspectRatio);
 	}
 
 	return QSortFilterProxyModel::data( index, role );
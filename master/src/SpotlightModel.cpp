@@ -22,6 +22,7 @@
  *
  */
 
+#include "FramebufferScaler.h"
 #include "SpotlightModel.h"
 
 
@@ -96,7 +97,7 @@ QVariant SpotlightModel::data( const QModelIndex& index, int role ) const
 			framebuffer = sourceModel()->data(sourceIndex, Qt::DecorationRole).value<QImage>();
 		}
 
-		return framebuffer.scaled(m_iconSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+		return FramebufferScaler::scaled(framebuffer, m_iconSize, Qt::KeepAspectRatio);
 	}
 
 	return QSortFilterProxyModel::data( index, role );
@@ -0,0 +1,216 @@
+/*
+ * TransportStatisticsModel.cpp - implementation of TransportStatisticsModel class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QLocale>
+
+#include "ComputerControlListModel.h"
+#include "TransportStatisticsModel.h"
+
+
+TransportStatisticsModel::TransportStatisticsModel( ComputerControlListModel& computerControlListModel, QObject* parent ) :
+	QAbstractTableModel( parent ),
+	m_computerControlListModel( computerControlListModel )
+{
+}
+
+
+
+void TransportStatisticsModel::update()
+{
+	const auto& computerControlInterfaces = m_computerControlListModel.computerControlInterfaces();
+
+	bool interfacesChanged = computerControlInterfaces.size() != m_entries.size();
+	for( int i = 0; interfacesChanged == false && i < m_entries.size(); ++i )
+	{
+		interfacesChanged = m_entries[i].computerControlInterface != computerControlInterfaces[i];
+	}
+
+	if( interfacesChanged )
+	{
+		beginResetModel();
+
+		m_entries.clear();
+		m_entries.reserve( computerControlInterfaces.size() );
+
+		for( const auto& computerControlInterface : computerControlInterfaces )
+		{
+			m_entries.append( { computerControlInterface, computerControlInterface->transportStatistics() } );
+		}
+
+		endResetModel();
+	}
+	else if( m_entries.isEmpty() == false )
+	{
+		// only refresh values so that selection and sort order are retained
+		for( auto& entry : m_entries )
+		{
+			entry.statistics = entry.computerControlInterface->transportStatistics();
+		}
+
+		Q_EMIT dataChanged( index( 0, ColumnReceiveRate ), index( m_entries.size() - 1, ColumnCount - 1 ) );
+	}
+}
+
+
+
+int TransportStatisticsModel::columnCount( const QModelIndex& parent ) const
+{
+	Q_UNUSED(parent)
+
+	return ColumnCount;
+}
+
+
+
+int TransportStatisticsModel::rowCount( const QModelIndex& parent ) const
+{
+	Q_UNUSED(parent)
+
+	return m_entries.size();
+}
+
+
+
+QVariant TransportStatisticsModel::data( const QModelIndex& index, int role ) const
+{
+	if( index.isValid() == false || index.row() >= m_entries.size() )
+	{
+		return {};
+	}
+
+	const auto& entry = m_entries[index.row()];
+
+	switch( role )
+	{
+	case Qt::DisplayRole: return displayData( entry, index.column() );
+	case SortRole: return sortData( entry, index.column() );
+	case Qt::TextAlignmentRole:
+		if( index.column() != ColumnComputer && index.column() != ColumnEncodings )
+		{
+			return int(Qt::AlignRight | Qt::AlignVCenter);
+		}
+		break;
+	default:
+		break;
+	}
+
+	return {};
+}
+
+
+
+QVariant TransportStatisticsModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+	if( orientation != Qt::Horizontal || role != Qt::DisplayRole )
+	{
+		return {};
+	}
+
+	switch( section )
+	{
+	case ColumnComputer: return tr( "Computer" );
+	case ColumnReceiveRate: return tr( "Receive rate" );
+	case ColumnFramebufferUpdateRate: return tr( "Updates/s" );
+	case ColumnThroughput: return tr( "Throughput" );
+	case ColumnRoundTripTime: return tr( "Round trip time" );
+	case ColumnDecodeTime: return tr( "Decode time" );
+	case ColumnInputLatency: return tr( "Input latency" );
+	case ColumnBytesReceived: return tr( "Received" );
+	case ColumnBytesSent: return tr( "Sent" );
+	case ColumnEncodings: return tr( "Encodings" );
+	default:
+		break;
+	}
+
+	return {};
+}
+
+
+
+QVariant TransportStatisticsModel::displayData( const Entry& entry, int column ) const
+{
+	const QLocale locale;
+	const auto& statistics = entry.statistics;
+
+	const auto formatTime = [&locale]( qint64 nanoseconds ) {
+		return tr( "%1 ms" ).arg( locale.toString( qreal( nanoseconds ) / ( 1000 * 1000 ), 'f', 1 ) );
+	};
+
+	switch( column )
+	{
+	case ColumnComputer: return entry.computerControlInterface->computer().name();
+	case ColumnReceiveRate: return tr( "%1/s" ).arg( locale.formattedDataSize( statistics.receiveRate ) );
+	case ColumnFramebufferUpdateRate: return locale.toString( statistics.framebufferUpdateRate, 'f', 1 );
+	case ColumnThroughput: return tr( "%1/s" ).arg( locale.formattedDataSize( statistics.throughput ) );
+	case ColumnRoundTripTime: return formatTime( statistics.roundTripTime );
+	case ColumnDecodeTime: return formatTime( statistics.decodeTime );
+	case ColumnInputLatency:
+		if( statistics.eventQueue.sentEvents > 0 )
+		{
+			return tr( "%1 (max. %2)" ).arg( formatTime( qint64(statistics.eventQueue.averageLatency) ),
+											formatTime( qint64(statistics.eventQueue.maximumLatency) ) );
+		}
+		return {};
+	case ColumnBytesReceived: return locale.formattedDataSize( qint64(statistics.bytesReceived) );
+	case ColumnBytesSent: return locale.formattedDataSize( qint64(statistics.bytesSent) );
+	case ColumnEncodings:
+	{
+		QStringList encodings;
+		for( auto it = statistics.encodingBytes.constBegin(), end = statistics.encodingBytes.constEnd(); it != end; ++it )
+		{
+			encodings.append( QStringLiteral("%1: %2").arg( it.key(), locale.formattedDataSize( qint64(it.value()) ) ) );
+		}
+		return encodings.join( QStringLiteral(", ") );
+	}
+	default:
+		break;
+	}
+
+	return {};
+}
+
+
+
+QVariant TransportStatisticsModel::sortData( const Entry& entry, int column )
+{
+	const auto& statistics = entry.statistics;
+
+	switch( column )
+	{
+	case ColumnComputer: return entry.computerControlInterface->computer().name();
+	case ColumnReceiveRate: return statistics.receiveRate;
+	case ColumnFramebufferUpdateRate: return statistics.framebufferUpdateRate;
+	case ColumnThroughput: return statistics.throughput;
+	case ColumnRoundTripTime: return statistics.roundTripTime;
+	case ColumnDecodeTime: return statistics.decodeTime;
+	case ColumnInputLatency: return statistics.eventQueue.averageLatency;
+	case ColumnBytesReceived: return statistics.bytesReceived;
+	case ColumnBytesSent: return statistics.bytesSent;
+	case ColumnEncodings: return QStringList( statistics.encodingBytes.keys() ).join( QLatin1Char(',') );
+	default:
+		break;
+	}
+
+	return {};
+}
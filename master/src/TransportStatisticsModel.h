@@ -0,0 +1,76 @@
+/*
+ * TransportStatisticsModel.h - declaration of TransportStatisticsModel class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include "ComputerControlInterface.h"
+
+class ComputerControlListModel;
+
+class TransportStatisticsModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Columns {
+		ColumnComputer,
+		ColumnReceiveRate,
+		ColumnFramebufferUpdateRate,
+		ColumnThroughput,
+		ColumnRoundTripTime,
+		ColumnDecodeTime,
+		ColumnInputLatency,
+		ColumnBytesReceived,
+		ColumnBytesSent,
+		ColumnEncodings,
+		ColumnCount
+	};
+
+	static constexpr int SortRole = Qt::UserRole;
+
+	explicit TransportStatisticsModel( ComputerControlListModel& computerControlListModel, QObject* parent = nullptr );
+	~TransportStatisticsModel() override = default;
+
+	void update();
+
+	int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+	int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+	QVariant data( const QModelIndex& index, int role ) const override;
+	QVariant headerData( int section, Qt::Orientation orientation, int role ) const override;
+
+private:
+	struct Entry
+	{
+		ComputerControlInterface::Pointer computerControlInterface;
+		VncConnection::Statistics statistics;
+	};
+
+	QVariant displayData( const Entry& entry, int column ) const;
+	static QVariant sortData( const Entry& entry, int column );
+
+	ComputerControlListModel& m_computerControlListModel;
+	QList<Entry> m_entries{};
+
+};
@@ -0,0 +1,103 @@
+/*
+ * TransportStatisticsPanel.cpp - implementation of transport statistics panel
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QLocale>
+
+#include "ComputerControlListModel.h"
+#include "TransportStatisticsPanel.h"
+#include "VncCursorShapeCache.h"
+
+#include "ui_TransportStatisticsPanel.h"
+
+
+TransportStatisticsPanel::TransportStatisticsPanel( ComputerControlListModel& computerControlListModel, QWidget *parent ) :
+	QWidget( parent ),
+	ui( new Ui::TransportStatisticsPanel ),
+	m_model( computerControlListModel, this )
+{
+	ui->setupUi( this );
+
+	m_sortModel.setSourceModel( &m_model );
+	m_sortModel.setSortRole( TransportStatisticsModel::SortRole );
+	m_sortModel.setDynamicSortFilter( true );
+
+	ui->tableView->setModel( &m_sortModel );
+	ui->tableView->sortByColumn( TransportStatisticsModel::ColumnReceiveRate, Qt::DescendingOrder );
+
+	m_updateTimer.setInterval( UpdateInterval );
+	connect( &m_updateTimer, &QTimer::timeout, this, &TransportStatisticsPanel::updateStatistics );
+}
+
+
+
+TransportStatisticsPanel::~TransportStatisticsPanel()
+{
+	delete ui;
+}
+
+
+
+void TransportStatisticsPanel::showEvent( QShowEvent* event )
+{
+	// only collect statistics while they're actually displayed
+	updateStatistics();
+	m_updateTimer.start();
+
+	QWidget::showEvent( event );
+}
+
+
+
+void TransportStatisticsPanel::hideEvent( QHideEvent* event )
+{
+	m_updateTimer.stop();
+
+	QWidget::hideEvent( event );
+}
+
+
+
+void TransportStatisticsPanel::updateStatistics()
+{
+	m_model.update();
+
+	qint64 totalReceiveRate = 0;
+	quint64 totalBytesReceived = 0;
+	for( int row = 0, count = m_model.rowCount(); row < count; ++row )
+	{
+		totalReceiveRate += m_model.index( row, TransportStatisticsModel::ColumnReceiveRate ).data( TransportStatisticsModel::SortRole ).toLongLong();
+		totalBytesReceived += m_model.index( row, TransportStatisticsModel::ColumnBytesReceived ).data( TransportStatisticsModel::SortRole ).toULongLong();
+	}
+
+	const auto cursorShapeCacheStatistics = VncCursorShapeCache::instance()->statistics();
+	const auto cursorShapeCacheHitRate = cursorShapeCacheStatistics.lookups > 0 ?
+											 cursorShapeCacheStatistics.hits * 100 / cursorShapeCacheStatistics.lookups : 0;
+
+	const QLocale locale;
+	ui->totalLabel->setText( tr( "Total: %1/s, %2 received - cursor shape cache: %3% hits, %4 saved" )
+								 .arg( locale.formattedDataSize( totalReceiveRate ),
+									   locale.formattedDataSize( qint64(totalBytesReceived) ) )
+								 .arg( cursorShapeCacheHitRate )
+								 .arg( locale.formattedDataSize( qint64(cursorShapeCacheStatistics.savedBytes) ) ) );
+}
@@ -0,0 +1,60 @@
+/*
+ * TransportStatisticsPanel.h - declaration of transport statistics panel
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QWidget>
+
+#include "TransportStatisticsModel.h"
+
+namespace Ui {
+class TransportStatisticsPanel;
+}
+
+class TransportStatisticsPanel : public QWidget
+{
+	Q_OBJECT
+public:
+	explicit TransportStatisticsPanel( ComputerControlListModel& computerControlListModel, QWidget *parent = nullptr );
+	~TransportStatisticsPanel() override;
+
+protected:
+	void showEvent( QShowEvent* event ) override;
+	void hideEvent( QHideEvent* event ) override;
+
+private:
+	void updateStatistics();
+
+	Ui::TransportStatisticsPanel* ui;
+
+	TransportStatisticsModel m_model;
+	QSortFilterProxyModel m_sortModel{this};
+
+	QTimer m_updateTimer{this};
+
+	static constexpr auto UpdateInterval = 1000;
+
+} ;
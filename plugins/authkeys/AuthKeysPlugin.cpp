@@ -40,6 +40,7 @@ AuthKeysPlugin::AuthKeysPlugin( QObject* parent ) :
 	QObject( parent ),
 	m_configuration( &VeyonCore::config() ),
 	m_manager( m_configuration ),
+	m_publicKeyStore( new AuthKeysPublicKeyStore( m_manager, this ) ),
 	m_commands( {
 { QStringLiteral("create"), tr( "Create new authentication key pair" ) },
 { QStringLiteral("delete"), tr( "Delete authentication key" ) },
@@ -163,16 +164,13 @@ VncServerClient::AuthState AuthKeysPlugin::performAuthentication( VncServerClien
 		// under which the client claims to run
 		const auto signature = message.read().toByteArray(); // Flawfinder: ignore
 
-		const auto publicKeyPath = m_manager.publicKeyPath( authKeyName );
-
-		CryptoCore::PublicKey publicKey( publicKeyPath );
-		if( publicKey.isNull() || publicKey.isPublic() == false )
+		auto publicKey = m_publicKeyStore->publicKey( authKeyName );
+		if( publicKey.isNull() )
 		{
-			vWarning() << "failed to load public key from" << publicKeyPath;
+			vWarning() << "failed to load public key from" << m_manager.publicKeyPath( authKeyName );
 			return VncServerClient::AuthState::Failed;
 		}
 
-		vDebug() << "loaded public key from" << publicKeyPath;
 		if( publicKey.verifyMessage( client->challenge(), signature, CryptoCore::DefaultSignatureAlgorithm ) == false )
 		{
 			vWarning() << "FAIL";
@@ -27,6 +27,7 @@
 #include "AuthenticationPluginInterface.h"
 #include "AuthKeysConfiguration.h"
 #include "AuthKeysManager.h"
+#include "AuthKeysPublicKeyStore.h"
 #include "CommandLineIO.h"
 #include "CommandLinePluginInterface.h"
 
@@ -128,6 +129,7 @@ private:
 
 	AuthKeysConfiguration m_configuration;
 	AuthKeysManager m_manager;
+	AuthKeysPublicKeyStore* m_publicKeyStore;
 
 	CryptoCore::PrivateKey m_privateKey{};
 	QString m_authKeyName;
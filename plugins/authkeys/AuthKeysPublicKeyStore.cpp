@@ -0,0 +1,169 @@
+/*
+ * AuthKeysPublicKeyStore.cpp - implementation of AuthKeysPublicKeyStore class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+#include "AuthKeysManager.h"
+#include "AuthKeysPublicKeyStore.h"
+
+
+AuthKeysPublicKeyStore::AuthKeysPublicKeyStore( const AuthKeysManager& manager, QObject* parent ) :
+	QObject( parent ),
+	m_manager( manager )
+{
+	// key files may be loaded in any thread while the file system watcher
+	// has to be accessed from the thread this object lives in
+	connect( this, &AuthKeysPublicKeyStore::keyFileLoaded, this, &AuthKeysPublicKeyStore::watchKeyFile );
+}
+
+
+
+CryptoCore::PublicKey AuthKeysPublicKeyStore::publicKey( const QString& name )
+{
+	const auto keyFileName = m_manager.publicKeyPath( name );
+
+	QMutexLocker locker( &m_mutex );
+
+	++m_statistics.lookups;
+
+	const auto it = m_entries.constFind( name );
+	// key file path changes with the configured public key base directory
+	if( it != m_entries.constEnd() && it->keyFileName == keyFileName )
+	{
+		return it->publicKey;
+	}
+
+	// determine the modification time before loading so that watchKeyFile() can detect
+	// changes which happened before the key file is being watched
+	const auto lastModified = QFileInfo( keyFileName ).lastModified();
+	const CryptoCore::PublicKey publicKey( keyFileName );
+	++m_statistics.loads;
+
+	if( publicKey.isNull() || publicKey.isPublic() == false )
+	{
+		m_entries.remove( name );
+		return {};
+	}
+
+	m_entries[name] = { keyFileName, lastModified, publicKey };
+
+	vDebug() << "loaded public key from" << keyFileName
+			 << "lookups:" << m_statistics.lookups << "loads:" << m_statistics.loads;
+
+	locker.unlock();
+
+	Q_EMIT keyFileLoaded( keyFileName );
+
+	return publicKey;
+}
+
+
+
+AuthKeysPublicKeyStore::Statistics AuthKeysPublicKeyStore::statistics() const
+{
+	QMutexLocker locker( &m_mutex );
+
+	auto statistics = m_statistics;
+	statistics.entries = int(m_entries.size());
+
+	return statistics;
+}
+
+
+
+void AuthKeysPublicKeyStore::watchKeyFile( const QString& keyFileName )
+{
+	if( m_watcher == nullptr )
+	{
+		m_watcher = new QFileSystemWatcher( this );
+		connect( m_watcher, &QFileSystemWatcher::fileChanged, this, &AuthKeysPublicKeyStore::invalidate );
+		connect( m_watcher, &QFileSystemWatcher::directoryChanged, this, &AuthKeysPublicKeyStore::invalidate );
+	}
+
+	// watch the key file itself for in-place modifications and its directory
+	// for the key file being replaced or removed - QFileSystemWatcher
+	// stops watching files once they have been removed
+	const auto keyDirectory = QFileInfo( keyFileName ).path();
+
+	QStringList paths;
+	if( m_watcher->files().contains( keyFileName ) == false )
+	{
+		paths.append( keyFileName );
+	}
+	if( m_watcher->directories().contains( keyDirectory ) == false )
+	{
+		paths.append( keyDirectory );
+	}
+
+	const auto unwatchedPaths = paths.isEmpty() ? QStringList{} : m_watcher->addPaths( paths );
+
+	// the key file may have been changed after it has been loaded but before it has been watched
+	const auto lastModified = QFileInfo( keyFileName ).lastModified();
+
+	QMutexLocker locker( &m_mutex );
+
+	// changes can't be detected if the key file or its directory could not be watched
+	// (e.g. due to the inotify watch limit) so the key must be loaded again on every lookup
+	if( unwatchedPaths.isEmpty() == false )
+	{
+		vDebug() << "not caching public key from" << keyFileName << "as" << unwatchedPaths << "can't be watched";
+
+		for( auto it = m_entries.begin(); it != m_entries.end(); )
+		{
+			if( it->keyFileName == keyFileName )
+			{
+				it = m_entries.erase( it );
+			}
+			else
+			{
+				++it;
+			}
+		}
+		return;
+	}
+
+	for( const auto& entry : std::as_const(m_entries) )
+	{
+		if( entry.keyFileName == keyFileName && entry.lastModified != lastModified )
+		{
+			locker.unlock();
+			invalidate( keyFileName );
+			return;
+		}
+	}
+}
+
+
+
+void AuthKeysPublicKeyStore::invalidate( const QString& path )
+{
+	QMutexLocker locker( &m_mutex );
+
+	vDebug() << path << "changed, dropping" << m_entries.size() << "cached public keys";
+
+	++m_statistics.invalidations;
+	m_entries.clear();
+}
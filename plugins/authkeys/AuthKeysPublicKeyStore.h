@@ -0,0 +1,81 @@
+/*
+ * AuthKeysPublicKeyStore.h - declaration of AuthKeysPublicKeyStore class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+
+#include "CryptoCore.h"
+
+class QFileSystemWatcher;
+class AuthKeysManager;
+
+// in-memory store of public keys used for verifying signatures on server side - each key
+// is loaded and parsed once and dropped again as soon as the key directories change
+class AuthKeysPublicKeyStore : public QObject
+{
+	Q_OBJECT
+public:
+	struct Statistics
+	{
+		quint64 lookups{0};
+		quint64 loads{0};
+		quint64 invalidations{0};
+		int entries{0};
+	};
+
+	explicit AuthKeysPublicKeyStore( const AuthKeysManager& manager, QObject* parent = nullptr );
+	~AuthKeysPublicKeyStore() override = default;
+
+	/** \brief Returns the public key with the given name or a null key if it can't be loaded, can be called from any thread */
+	CryptoCore::PublicKey publicKey( const QString& name );
+
+	Statistics statistics() const;
+
+Q_SIGNALS:
+	void keyFileLoaded( const QString& keyFileName );
+
+private:
+	struct Entry
+	{
+		QString keyFileName;
+		QDateTime lastModified;
+		CryptoCore::PublicKey publicKey;
+	};
+
+	void watchKeyFile( const QString& keyFileName );
+	void invalidate( const QString& path );
+
+	const AuthKeysManager& m_manager;
+
+	QFileSystemWatcher* m_watcher{nullptr};
+
+	mutable QMutex m_mutex{};
+	QHash<QString, Entry> m_entries;
+
+	Statistics m_statistics{};
+
+};
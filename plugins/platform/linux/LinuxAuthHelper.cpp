@@ -0,0 +1,286 @@
+/*
+ * LinuxAuthHelper.cpp - implementation of LinuxAuthHelper class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <array>
+#include <limits>
+
+#include "LinuxAuthHelper.h"
+
+
+LinuxAuthHelper::~LinuxAuthHelper()
+{
+	QMutexLocker locker( &m_mutex );
+
+	stopHelper();
+
+	if( m_statistics.requests > 0 )
+	{
+		vDebug() << "requests:" << m_statistics.requests << "failures:" << m_statistics.failures
+				 << "helper starts:" << m_statistics.helperStarts;
+	}
+}
+
+
+
+bool LinuxAuthHelper::authenticate( const QString& username, const Password& password, const QString& pamService, int timeout )
+{
+	const QDeadlineTimer deadline( timeout );
+
+	QMutexLocker locker( &m_mutex );
+
+	++m_statistics.requests;
+
+	if( m_socket < 0 && startHelper() == false )
+	{
+		++m_statistics.failures;
+		return false;
+	}
+
+	const auto requestId = ++m_nextRequestId;
+	const auto generation = m_generation;
+
+	QByteArray request;
+	QDataStream requestStream( &request, QIODevice::WriteOnly );
+	requestStream << requestId << username.toUtf8() << password.toByteArray() << pamService.toUtf8();
+
+	const auto sent = request.size() <= MaximumPacketSize &&
+					  send( m_socket, request.constData(), size_t(request.size()), MSG_NOSIGNAL ) == request.size();
+
+	// do not keep a copy of the plaintext password in memory
+	request.fill( 0 );
+
+	if( sent == false )
+	{
+		vCritical() << "failed to send request to VeyonAuthHelper";
+		stopHelper();
+		++m_statistics.failures;
+		return false;
+	}
+
+	Q_FOREVER
+	{
+		// fail closed if the helper died or has been restarted in the meantime
+		if( generation != m_generation )
+		{
+			vCritical() << "VeyonAuthHelper terminated unexpectedly";
+			++m_statistics.failures;
+			return false;
+		}
+
+		if( m_responses.contains( requestId ) )
+		{
+			const auto response = m_responses.take( requestId );
+			if( response.result != 0 )
+			{
+				vCritical() << "VeyonAuthHelper failed:" << response.result << response.message.trimmed();
+				++m_statistics.failures;
+				return false;
+			}
+
+			vDebug() << "User authenticated successfully";
+			return true;
+		}
+
+		if( deadline.hasExpired() )
+		{
+			// the helper itself is still working (e.g. a slow PAM module), so only this request fails
+			vCritical() << "VeyonAuthHelper did not respond in time";
+			m_abandonedRequests.insert( requestId );
+			++m_statistics.failures;
+			return false;
+		}
+
+		if( m_receiving )
+		{
+			// another thread is receiving responses already
+			m_responseReceived.wait( &m_mutex, ulong( qMax<qint64>( 1, deadline.remainingTime() ) ) );
+			continue;
+		}
+
+		m_receiving = true;
+		const auto socket = m_socket;
+
+		locker.unlock();
+		Response response;
+		const auto receiveResult = receiveResponse( socket, deadline, &response );
+		locker.relock();
+
+		m_receiving = false;
+
+		if( generation != m_generation )
+		{
+			// helper has been stopped by a different thread while we were receiving
+			close( socket );
+		}
+		else if( receiveResult == ReceiveResult::Received )
+		{
+			if( m_abandonedRequests.remove( response.requestId ) == false )
+			{
+				m_responses[response.requestId] = response;
+			}
+		}
+		else if( receiveResult == ReceiveResult::Failed )
+		{
+			stopHelper();
+		}
+
+		m_responseReceived.wakeAll();
+	}
+}
+
+
+
+bool LinuxAuthHelper::startHelper()
+{
+	auto helperPath = QStandardPaths::findExecutable( QStringLiteral("veyon-auth-helper") );
+	if( helperPath.isEmpty() )
+	{
+		helperPath = QStandardPaths::findExecutable( QStringLiteral("veyon-auth-helper"),
+													 { QCoreApplication::applicationDirPath() } );
+	}
+
+	if( helperPath.isEmpty() )
+	{
+		vCritical() << "could not find VeyonAuthHelper";
+		return false;
+	}
+
+	// message boundaries are preserved with sequenced packets so that responses written
+	// concurrently by the helper's conversation processes never get interleaved
+	std::array<int, 2> sockets{ { -1, -1 } };
+	if( socketpair( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets.data() ) != 0 )
+	{
+		vCritical() << "failed to create socket pair for VeyonAuthHelper";
+		return false;
+	}
+
+	// prepare all arguments before forking as only async-signal-safe functions may be called afterwards
+	const auto helperFileName = QFile::encodeName( helperPath );
+	QByteArray persistentArgument = QByteArrayLiteral("--persistent");
+	std::array<char *, 3> arguments{ { const_cast<char *>( helperFileName.constData() ), persistentArgument.data(), nullptr } };
+
+	// fork twice so that the helper gets adopted and reaped by init - it terminates
+	// on its own as soon as our end of the socket pair gets closed
+	const auto pid = fork();
+	if( pid < 0 )
+	{
+		vCritical() << "failed to fork VeyonAuthHelper";
+		close( sockets[0] );
+		close( sockets[1] );
+		return false;
+	}
+
+	if( pid == 0 )
+	{
+		if( fork() == 0 )
+		{
+			dup2( sockets[1], STDIN_FILENO );
+			dup2( sockets[1], STDOUT_FILENO );
+			execv( arguments[0], arguments.data() );
+		}
+		_exit( 0 );
+	}
+
+	close( sockets[1] );
+
+	while( waitpid( pid, nullptr, 0 ) < 0 && errno == EINTR )
+	{
+	}
+
+	m_socket = sockets[0];
+	++m_statistics.helperStarts;
+
+	vDebug() << "started" << helperPath << "- helper starts:" << m_statistics.helperStarts;
+
+	return true;
+}
+
+
+
+void LinuxAuthHelper::stopHelper()
+{
+	if( m_socket < 0 )
+	{
+		return;
+	}
+
+	shutdown( m_socket, SHUT_RDWR );
+
+	// a thread currently receiving from the socket closes it on its own
+	if( m_receiving == false )
+	{
+		close( m_socket );
+	}
+
+	m_socket = -1;
+	++m_generation;
+	m_responses.clear();
+	m_abandonedRequests.clear();
+
+	m_responseReceived.wakeAll();
+}
+
+
+
+LinuxAuthHelper::ReceiveResult LinuxAuthHelper::receiveResponse( int socket, const QDeadlineTimer& deadline, Response* response )
+{
+	pollfd pollFd{ socket, POLLIN, 0 };
+
+	const auto pollResult = poll( &pollFd, 1, int( qBound<qint64>( 0, deadline.remainingTime(), std::numeric_limits<int>::max() ) ) );
+	if( pollResult == 0 || ( pollResult < 0 && errno == EINTR ) )
+	{
+		return ReceiveResult::Timeout;
+	}
+
+	if( pollResult < 0 )
+	{
+		return ReceiveResult::Failed;
+	}
+
+	QByteArray packet( MaximumPacketSize, Qt::Uninitialized );
+	const auto size = recv( socket, packet.data(), size_t(packet.size()), 0 );
+	if( size <= 0 )
+	{
+		return ReceiveResult::Failed;
+	}
+
+	packet.truncate( int(size) );
+
+	QDataStream stream( packet );
+	stream >> response->requestId >> response->result >> response->message;
+
+	return stream.status() == QDataStream::Ok ? ReceiveResult::Received : ReceiveResult::Failed;
+}
@@ -0,0 +1,94 @@
+/*
+ * LinuxAuthHelper.h - declaration of LinuxAuthHelper class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+
+#include "PlatformUserFunctions.h"
+
+// client for a persistent veyon-auth-helper process which performs PAM authentications
+// on behalf of this process - requests are sent over a private socket pair and can be
+// issued from multiple threads concurrently, all of them fail if the helper dies - a request
+// timing out only fails on its own as the helper may just be waiting for a slow PAM module
+class LinuxAuthHelper
+{
+public:
+	using Password = PlatformUserFunctions::Password;
+
+	LinuxAuthHelper() = default;
+	~LinuxAuthHelper();
+
+	Q_DISABLE_COPY(LinuxAuthHelper)
+
+	bool authenticate( const QString& username, const Password& password, const QString& pamService, int timeout );
+
+private:
+	static constexpr int MaximumPacketSize = 64*1024;
+
+	struct Statistics
+	{
+		quint64 requests{0};
+		quint64 failures{0};
+		quint64 helperStarts{0};
+	};
+
+	struct Response
+	{
+		quint32 requestId{0};
+		qint32 result{-1};
+		QByteArray message;
+	};
+
+	enum class ReceiveResult
+	{
+		Received,
+		Timeout,
+		Failed
+	};
+
+	bool startHelper();
+	void stopHelper();
+
+	static ReceiveResult receiveResponse( int socket, const QDeadlineTimer& deadline, Response* response );
+
+	QMutex m_mutex{};
+	QWaitCondition m_responseReceived{};
+
+	int m_socket{-1};
+	// incremented whenever the helper is stopped so that requests sent to it can be failed
+	quint64 m_generation{0};
+	quint32 m_nextRequestId{0};
+	bool m_receiving{false};
+	QHash<quint32, Response> m_responses{};
+	// requests which timed out and whose responses are discarded when arriving late
+	QSet<quint32> m_abandonedRequests{};
+
+	Statistics m_statistics{};
+
+};
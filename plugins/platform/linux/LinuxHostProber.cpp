@@ -0,0 +1,382 @@
+/*
+ * LinuxHostProber.cpp - implementation of LinuxHostProber class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "HostAddress.h"
+#include "LinuxHostProber.h"
+
+
+static socklen_t toSocketAddress( const QHostAddress& address, quint16 port, sockaddr_storage* socketAddress )
+{
+	memset( socketAddress, 0, sizeof(*socketAddress) );
+
+	if( address.protocol() == QAbstractSocket::IPv4Protocol )
+	{
+		auto in4 = reinterpret_cast<sockaddr_in *>( socketAddress );
+		in4->sin_family = AF_INET;
+		in4->sin_port = htons( port );
+		in4->sin_addr.s_addr = htonl( address.toIPv4Address() );
+		return sizeof(sockaddr_in);
+	}
+
+	auto in6 = reinterpret_cast<sockaddr_in6 *>( socketAddress );
+	in6->sin6_family = AF_INET6;
+	in6->sin6_port = htons( port );
+	const auto ipv6Address = address.toIPv6Address();
+	memcpy( &in6->sin6_addr, &ipv6Address, sizeof(in6->sin6_addr) );
+	return sizeof(sockaddr_in6);
+}
+
+
+
+LinuxHostProber::~LinuxHostProber()
+{
+	m_mutex.lock();
+	m_stopRequested = true;
+	m_probesRequested.wakeAll();
+	m_mutex.unlock();
+
+	wait();
+}
+
+
+
+bool LinuxHostProber::isSupported()
+{
+	static const bool supported = []() {
+		const auto icmpSocket = socket( AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_ICMP );
+		if( icmpSocket < 0 )
+		{
+			return false;
+		}
+		close( icmpSocket );
+		return true;
+	}();
+
+	return supported;
+}
+
+
+
+LinuxHostProber::PingResult LinuxHostProber::ping( const QString& host )
+{
+	QMutexLocker locker( &m_mutex );
+
+	if( const auto it = m_hostStates.constFind( host ); it != m_hostStates.constEnd() && isValid( *it ) )
+	{
+		return it->result;
+	}
+
+	locker.unlock();
+
+	// resolve names in the calling thread so that slow DNS responses do not delay other probes
+	const QHostAddress address( HostAddress( host ).convert( HostAddress::Type::IpAddress ) );
+
+	locker.relock();
+
+	if( address.isNull() )
+	{
+		auto& state = m_hostStates[host];
+		state.result = PingResult::NameResolutionFailed;
+		state.roundTripTime = -1;
+		state.timestamp.start();
+		return state.result;
+	}
+
+	m_pendingHosts[host] = address;
+
+	if( isRunning() == false )
+	{
+		start();
+	}
+
+	m_probesRequested.wakeAll();
+
+	QElapsedTimer timer;
+	timer.start();
+
+	while( timer.elapsed() < PlatformNetworkFunctions::PingProcessTimeout )
+	{
+		// only accept results of probes started after this request
+		if( const auto it = m_hostStates.constFind( host );
+			it != m_hostStates.constEnd() && isValid( *it ) && it->timestamp.elapsed() <= timer.elapsed() )
+		{
+			return it->result;
+		}
+
+		m_probesFinished.wait( &m_mutex, qMax<qint64>( 1, PlatformNetworkFunctions::PingProcessTimeout - timer.elapsed() ) );
+	}
+
+	return PingResult::Unknown;
+}
+
+
+
+LinuxHostProber::HostState LinuxHostProber::hostState( const QString& host ) const
+{
+	QMutexLocker locker( &m_mutex );
+
+	return m_hostStates.value( host );
+}
+
+
+
+void LinuxHostProber::run()
+{
+	QMutexLocker locker( &m_mutex );
+
+	while( m_stopRequested == false )
+	{
+		if( m_pendingHosts.isEmpty() )
+		{
+			m_probesRequested.wait( &m_mutex );
+			continue;
+		}
+
+		// let other connections which failed at the same time join the batch
+		locker.unlock();
+		msleep( BatchCollectInterval );
+		locker.relock();
+
+		QVector<Probe> probes;
+		probes.reserve( m_pendingHosts.size() );
+		for( auto it = m_pendingHosts.constBegin(), end = m_pendingHosts.constEnd(); it != end; ++it )
+		{
+			Probe probe;
+			probe.host = it.key();
+			probe.address = it.value();
+			probe.sequence = m_nextSequence++;
+			probes.append( probe );
+		}
+		m_pendingHosts.clear();
+
+		locker.unlock();
+		runProbes( probes );
+		locker.relock();
+
+		// drop outdated states of hosts which are not probed anymore
+		for( auto it = m_hostStates.begin(); it != m_hostStates.end(); )
+		{
+			if( isValid( *it ) )
+			{
+				++it;
+			}
+			else
+			{
+				it = m_hostStates.erase( it );
+			}
+		}
+
+		for( const auto& probe : std::as_const(probes) )
+		{
+			m_hostStates[probe.host] = probe.state;
+		}
+
+		m_probesFinished.wakeAll();
+	}
+}
+
+
+
+void LinuxHostProber::runProbes( QVector<Probe>& probes )
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	// unprivileged ICMP sockets require the group of the process to be in net.ipv4.ping_group_range
+	const auto icmp4Socket = socket( AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP );
+	const auto icmp6Socket = socket( AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMPV6 );
+
+	for( auto& probe : probes )
+	{
+		if( sendEchoRequest( probe, icmp4Socket, icmp6Socket, timer ) == false )
+		{
+			finishProbe( probe, PingResult::Unknown, timer );
+		}
+	}
+
+	std::vector<pollfd> pollFds;
+	pollFds.reserve( 2 );
+
+	while( timer.elapsed() < PlatformNetworkFunctions::PingTimeout )
+	{
+		pollFds.clear();
+
+		for( auto icmpSocket : { icmp4Socket, icmp6Socket } )
+		{
+			if( icmpSocket >= 0 )
+			{
+				pollFds.push_back( { icmpSocket, POLLIN, 0 } );
+			}
+		}
+
+		const auto probesPending = std::any_of( probes.cbegin(), probes.cend(), []( const Probe& probe ) {
+			return probe.finished == false;
+		} );
+
+		if( probesPending == false || pollFds.empty() )
+		{
+			break;
+		}
+
+		if( poll( pollFds.data(), nfds_t(pollFds.size()),
+				  int( PlatformNetworkFunctions::PingTimeout - timer.elapsed() ) ) <= 0 )
+		{
+			continue;
+		}
+
+		for( const auto& pollFd : pollFds )
+		{
+			if( pollFd.revents != 0 )
+			{
+				receiveEchoReplies( pollFd.fd, probes, timer );
+			}
+		}
+	}
+
+	for( auto& probe : probes )
+	{
+		if( probe.finished == false )
+		{
+			finishProbe( probe, PingResult::TimedOut, timer );
+		}
+	}
+
+	for( auto icmpSocket : { icmp4Socket, icmp6Socket } )
+	{
+		if( icmpSocket >= 0 )
+		{
+			close( icmpSocket );
+		}
+	}
+}
+
+
+
+bool LinuxHostProber::sendEchoRequest( Probe& probe, int icmp4Socket, int icmp6Socket, const QElapsedTimer& timer )
+{
+	const auto isIPv4 = probe.address.protocol() == QAbstractSocket::IPv4Protocol;
+	const auto icmpSocket = isIPv4 ? icmp4Socket : icmp6Socket;
+	if( icmpSocket < 0 )
+	{
+		return false;
+	}
+
+	// identifier and checksum are filled in by the kernel for ICMP datagram sockets
+	std::array<uint8_t, 8> request{};
+	if( isIPv4 )
+	{
+		auto header = reinterpret_cast<icmphdr *>( request.data() );
+		header->type = ICMP_ECHO;
+		header->un.echo.sequence = htons( probe.sequence );
+	}
+	else
+	{
+		auto header = reinterpret_cast<icmp6_hdr *>( request.data() );
+		header->icmp6_type = ICMP6_ECHO_REQUEST;
+		header->icmp6_seq = htons( probe.sequence );
+	}
+
+	sockaddr_storage address{};
+	const auto addressLength = toSocketAddress( probe.address, 0, &address );
+
+	probe.sendTime = timer.nsecsElapsed();
+
+	if( sendto( icmpSocket, request.data(), request.size(), 0,
+				reinterpret_cast<const sockaddr *>( &address ), addressLength ) < 0 )
+	{
+		return false;
+	}
+
+	probe.icmpSocket = icmpSocket;
+
+	return true;
+}
+
+
+
+void LinuxHostProber::receiveEchoReplies( int socket, QVector<Probe>& probes, const QElapsedTimer& timer )
+{
+	std::array<uint8_t, 1024> reply{};
+	sockaddr_storage address{};
+
+	forever
+	{
+		socklen_t addressLength = sizeof(address);
+		const auto size = recvfrom( socket, reply.data(), reply.size(), 0,
+									reinterpret_cast<sockaddr *>( &address ), &addressLength );
+		if( size < 0 )
+		{
+			break;
+		}
+
+		quint16 sequence = 0;
+		if( address.ss_family == AF_INET && size_t(size) >= sizeof(icmphdr) &&
+			reinterpret_cast<const icmphdr *>( reply.data() )->type == ICMP_ECHOREPLY )
+		{
+			sequence = ntohs( reinterpret_cast<const icmphdr *>( reply.data() )->un.echo.sequence );
+		}
+		else if( address.ss_family == AF_INET6 && size_t(size) >= sizeof(icmp6_hdr) &&
+				 reinterpret_cast<const icmp6_hdr *>( reply.data() )->icmp6_type == ICMP6_ECHO_REPLY )
+		{
+			sequence = ntohs( reinterpret_cast<const icmp6_hdr *>( reply.data() )->icmp6_seq );
+		}
+		else
+		{
+			continue;
+		}
+
+		const QHostAddress sender( reinterpret_cast<const sockaddr *>( &address ) );
+
+		for( auto& probe : probes )
+		{
+			if( probe.finished == false && probe.icmpSocket == socket &&
+				probe.sequence == sequence && probe.address.isEqual( sender, QHostAddress::ConvertV4MappedToIPv4 ) )
+			{
+				finishProbe( probe, PingResult::ReplyReceived, timer );
+			}
+		}
+	}
+}
+
+
+
+void LinuxHostProber::finishProbe( Probe& probe, PingResult result, const QElapsedTimer& timer )
+{
+	probe.finished = true;
+	probe.state.result = result;
+	probe.state.roundTripTime = result == PingResult::ReplyReceived ? ( timer.nsecsElapsed() - probe.sendTime ) / 1000 : -1;
+	probe.state.timestamp.start();
+}
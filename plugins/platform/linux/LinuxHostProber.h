@@ -0,0 +1,95 @@
+/*
+ * LinuxHostProber.h - declaration of LinuxHostProber class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "PlatformNetworkFunctions.h"
+
+// probes the reachability of all requested hosts in batches from a single thread using unprivileged ICMP sockets
+class LinuxHostProber : public QThread
+{
+public:
+	using PingResult = PlatformNetworkFunctions::PingResult;
+
+	static constexpr int CacheTimeout = 3000;
+	static constexpr int BatchCollectInterval = 20;
+
+	struct HostState
+	{
+		PingResult result{PingResult::Unknown};
+		qint64 roundTripTime{-1};	// microseconds
+		QElapsedTimer timestamp{};
+	};
+
+	LinuxHostProber() = default;
+	~LinuxHostProber() override;
+
+	/** \brief Returns whether unprivileged ICMP sockets are permitted (see net.ipv4.ping_group_range) */
+	static bool isSupported();
+
+	PingResult ping( const QString& host );
+
+	HostState hostState( const QString& host ) const;
+
+protected:
+	void run() override;
+
+private:
+	struct Probe
+	{
+		QString host;
+		QHostAddress address;
+		int icmpSocket{-1};
+		quint16 sequence{0};
+		qint64 sendTime{0};
+		bool finished{false};
+		HostState state{};
+	};
+
+	bool isValid( const HostState& state ) const
+	{
+		return state.timestamp.isValid() && state.timestamp.elapsed() < CacheTimeout;
+	}
+
+	void runProbes( QVector<Probe>& probes );
+	bool sendEchoRequest( Probe& probe, int icmp4Socket, int icmp6Socket, const QElapsedTimer& timer );
+	void receiveEchoReplies( int socket, QVector<Probe>& probes, const QElapsedTimer& timer );
+	static void finishProbe( Probe& probe, PingResult result, const QElapsedTimer& timer );
+
+	mutable QMutex m_mutex{};
+	QWaitCondition m_probesRequested{};
+	QWaitCondition m_probesFinished{};
+	QHash<QString, QHostAddress> m_pendingHosts{};
+	QHash<QString, HostState> m_hostStates{};
+	quint16 m_nextSequence{0};
+	bool m_stopRequested{false};
+
+};
@@ -31,6 +31,12 @@
 
 LinuxNetworkFunctions::PingResult LinuxNetworkFunctions::ping(const QString& hostAddress)
 {
+	if (LinuxHostProber::isSupported())
+	{
+		return m_hostProber.ping(hostAddress);
+	}
+
+	// the ping program is allowed to send ICMP requests via file capabilities or setuid
 	QProcess pingProcess;
 	pingProcess.start( QStringLiteral("ping"), { QStringLiteral("-c"), QStringLiteral("1"), QStringLiteral("-w"), QString::number( PingTimeout / 1000 ), hostAddress } );
 	if (pingProcess.waitForFinished(PingProcessTimeout))
@@ -24,7 +24,7 @@
 
 #pragma once
 
-#include "PlatformNetworkFunctions.h"
+#include "LinuxHostProber.h"
 
 // clazy:excludeall=copyable-polymorphic
 
@@ -36,4 +36,7 @@ public:
 
 	bool configureSocketKeepalive( Socket socket, bool enabled, int idleTime, int interval, int probes ) override;
 
+private:
+	LinuxHostProber m_hostProber{};
+
 };
@@ -22,7 +22,6 @@
  *
  */
 
-#include <QDataStream>
 #include <QDBusReply>
 #include <QProcess>
 #include <QRegularExpression>
@@ -419,32 +418,9 @@ void LinuxUserFunctions::logoff()
 
 bool LinuxUserFunctions::authenticate( const QString& username, const Password& password )
 {
-	QProcess p;
-	p.start( QStringLiteral( "veyon-auth-helper" ), QStringList{}, QProcess::ReadWrite | QProcess::Unbuffered );
-	if( p.waitForStarted() == false )
-	{
-		vCritical() << "failed to start VeyonAuthHelper";
-		return false;
-	}
-
 	const auto pamService = LinuxPlatformConfiguration( &VeyonCore::config() ).pamServiceName();
 
-	QDataStream ds( &p );
-	ds << username.toUtf8();
-	ds << password.toByteArray();
-	ds << pamService.toUtf8();
-
-	p.waitForFinished( AuthHelperTimeout );
-
-	if( p.state() != QProcess::NotRunning || p.exitCode() != 0 )
-	{
-		vCritical() << "VeyonAuthHelper failed:" << p.exitCode()
-					<< p.readAllStandardOutput().trimmed() << p.readAllStandardError().trimmed();
-		return false;
-	}
-
-	vDebug() << "User authenticated successfully";
-	return true;
+	return m_authHelper.authenticate( username, password, pamService, AuthHelperTimeout );
 }
 
 
@@ -26,6 +26,7 @@
 
 #include <QDBusConnection>
 
+#include "LinuxAuthHelper.h"
 #include "LogonHelper.h"
 #include "PlatformUserFunctions.h"
 
@@ -61,6 +62,7 @@ private:
 
 	static constexpr auto AuthHelperTimeout = 10000;
 
+	LinuxAuthHelper m_authHelper{};
 	LogonHelper m_logonHelper{};
 
 };
@@ -27,6 +27,14 @@
 
 #include <security/pam_appl.h>
 
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 static QByteArray pam_username; // clazy:exclude=non-pod-global-static
 static QByteArray pam_password; // clazy:exclude=non-pod-global-static
 static QByteArray pam_service; // clazy:exclude=non-pod-global-static
@@ -68,7 +76,57 @@ static int pam_conv( int num_msg, const struct pam_message** msg, struct pam_res
 }
 
 
-int main()
+// authenticates pam_username using a fresh handle for pam_service unless a prepared handle is passed
+static int authenticate( pam_handle_t* pamh, QByteArray* message )
+{
+	auto err = PAM_SUCCESS;
+
+	if( pamh == nullptr )
+	{
+		struct pam_conv pconv = { &pam_conv, nullptr };
+		err = pam_start( pam_service.constData(), nullptr, &pconv, &pamh );
+		if( err != PAM_SUCCESS )
+		{
+			*message = QByteArrayLiteral("pam_start: ") + pam_strerror( pamh, err );
+		}
+	}
+
+	if( err == PAM_SUCCESS )
+	{
+		err = pam_authenticate( pamh, PAM_SILENT );
+		if( err != PAM_SUCCESS )
+		{
+			*message = QByteArrayLiteral("pam_authenticate: ") + pam_strerror( pamh, err );
+		}
+		else
+		{
+			err = pam_acct_mgmt( pamh, PAM_SILENT );
+			if( err != PAM_SUCCESS )
+			{
+				*message = QByteArrayLiteral("pam_acct_mgmt: ") + pam_strerror( pamh, err );
+			}
+		}
+	}
+
+	pam_end( pamh, err );
+
+	return err;
+}
+
+
+
+static void sendResponse( quint32 requestId, int result, const QByteArray& message )
+{
+	QByteArray response;
+	QDataStream ds( &response, QIODevice::WriteOnly );
+	ds << requestId << qint32(result) << message;
+
+	send( STDOUT_FILENO, response.constData(), size_t(response.size()), MSG_NOSIGNAL );
+}
+
+
+
+static int runOnce()
 {
 	QFile stdIn;
 	stdIn.open( 0, QFile::ReadOnly | QFile::Unbuffered );
@@ -82,31 +140,154 @@ int main()
 		pam_service = QByteArrayLiteral("login");
 	}
 
-	struct pam_conv pconv = { &pam_conv, nullptr };
-	pam_handle_t* pamh = nullptr;
-	auto err = pam_start( pam_service.constData(), nullptr, &pconv, &pamh );
-	if( err == PAM_SUCCESS )
+	QByteArray message;
+	const auto err = authenticate( nullptr, &message );
+	if( err != PAM_SUCCESS )
 	{
-		err = pam_authenticate( pamh, PAM_SILENT );
-		if( err != PAM_SUCCESS )
+		printf( "%s\n", message.constData() );
+	}
+
+	return err == PAM_SUCCESS ? 0 : -1;
+}
+
+
+
+// serves requests received as sequenced packets on a socket passed as stdin/stdout until it gets closed -
+// every request is processed in a forked conversation process so that slow PAM modules or delays after
+// failed authentications do not block further requests
+static int runPersistent()
+{
+	static constexpr int MaximumPacketSize = 64*1024;
+	static constexpr int MaximumConversations = 8;
+	static constexpr int ConversationReapInterval = 100;
+
+	signal( SIGPIPE, SIG_IGN );
+
+	// keep a handle for the most recently used service so that its configuration
+	// and modules are loaded once instead of for every single request
+	static struct pam_conv pconv = { &pam_conv, nullptr };
+	pam_handle_t* preparedHandle = nullptr;
+	QByteArray preparedService;
+
+	QByteArray packet( MaximumPacketSize, Qt::Uninitialized );
+	int conversations = 0;
+
+	Q_FOREVER
+	{
+		// reap finished conversation processes
+		while( conversations > 0 && waitpid( -1, nullptr, WNOHANG ) > 0 )
+		{
+			--conversations;
+		}
+
+		// while the limit is reached do not accept further requests but still notice
+		// the socket being closed so that we never outlive our client
+		const auto limitReached = conversations >= MaximumConversations;
+
+		pollfd pollFd{ STDIN_FILENO, short( limitReached ? 0 : POLLIN ), 0 };
+		const auto pollResult = poll( &pollFd, 1, limitReached ? ConversationReapInterval : -1 );
+		if( pollResult < 0 && errno == EINTR )
+		{
+			continue;
+		}
+
+		if( pollResult < 0 || ( pollFd.revents & ( POLLHUP | POLLERR | POLLNVAL ) ) )
+		{
+			break;
+		}
+
+		if( ( pollFd.revents & POLLIN ) == 0 )
+		{
+			continue;
+		}
+
+		const auto size = recv( STDIN_FILENO, packet.data(), size_t(packet.size()), 0 );
+		if( size < 0 && errno == EINTR )
+		{
+			continue;
+		}
+
+		if( size <= 0 )
+		{
+			break;
+		}
+
+		quint32 requestId = 0;
+		QByteArray username;
+		QByteArray password;
+		QByteArray service;
+
+		QDataStream ds( QByteArray::fromRawData( packet.constData(), int(size) ) );
+		ds >> requestId >> username >> password >> service;
+
+		if( ds.status() != QDataStream::Ok )
+		{
+			break;
+		}
+
+		if( service.isEmpty() )
+		{
+			service = QByteArrayLiteral("login");
+		}
+
+		if( preparedHandle == nullptr || service != preparedService )
+		{
+			if( preparedHandle )
+			{
+				pam_end( preparedHandle, PAM_SUCCESS );
+				preparedHandle = nullptr;
+			}
+
+			if( pam_start( service.constData(), nullptr, &pconv, &preparedHandle ) != PAM_SUCCESS )
+			{
+				preparedHandle = nullptr;
+			}
+			preparedService = service;
+		}
+
+		const auto pid = fork();
+		if( pid == 0 )
+		{
+			pam_username = username;
+			pam_password = password;
+			pam_service = service;
+
+			QByteArray message;
+			const auto err = authenticate( preparedHandle, &message );
+			sendResponse( requestId, err, message );
+
+			_exit( 0 );
+		}
+
+		if( pid < 0 )
+		{
+			sendResponse( requestId, PAM_SYSTEM_ERR, QByteArrayLiteral("fork() failed") );
+		}
+		else
 		{
-			printf( "pam_authenticate: %s\n", pam_strerror( pamh, err ) );
+			++conversations;
 		}
-        else
-        {
-            err = pam_acct_mgmt( pamh, PAM_SILENT );
-            if( err != PAM_SUCCESS )
-            {
-                printf( "pam_acct_mgmt: %s\n", pam_strerror( pamh, err ) );
-            }
-        }
+
+		password.fill( 0 );
+		memset( packet.data(), 0, size_t(size) );
 	}
-	else
+
+	if( preparedHandle )
 	{
-		printf( "pam_start: %s\n", pam_strerror( pamh, err ) );
+		pam_end( preparedHandle, PAM_SUCCESS );
 	}
 
-	pam_end( pamh, err );
+	return 0;
+}
 
-	return err == PAM_SUCCESS ? 0 : -1;
+
+
+int main( int argc, char** argv )
+{
+	if( argc > 1 && qstrcmp( argv[1], "--persistent" ) == 0 )
+	{
+		return runPersistent();
+	}
+
+	return runOnce();
 }
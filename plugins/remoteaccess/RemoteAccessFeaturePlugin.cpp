@@ -478,6 +478,7 @@ void RemoteAccessFeaturePlugin::updateClipboardData()
 	m_clipboardDataMutex.lock();
 
 	const auto clipboard = QGuiApplication::clipboard();
+	const auto previousClipboardDataVersion = m_clipboardDataVersion;
 
 	if (m_clipboardText != clipboard->text())
 	{
@@ -492,5 +493,16 @@ void RemoteAccessFeaturePlugin::updateClipboardData()
 		++m_clipboardDataVersion;
 	}
 
+	const auto clipboardDataChanged = m_clipboardDataVersion != previousClipboardDataVersion;
+
 	m_clipboardDataMutex.unlock();
+
+	if (clipboardDataChanged)
+	{
+		const auto server = VeyonCore::instance()->findChild<VeyonServerInterface *>();
+		if (server)
+		{
+			server->notifyAsyncFeatureStateChanged();
+		}
+	}
 }
@@ -22,10 +22,34 @@
  *
  */
 
+#include <functional>
+
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QtEndian>
+
 #include "CommandLineIO.h"
 #include "AccessControlProvider.h"
+#include "FramebufferScaler.h"
 #include "PlatformNetworkFunctions.h"
+#include "PlatformUserFunctions.h"
 #include "TestingCommandLinePlugin.h"
+#include "VncClientProtocol.h"
+
+
+// feeds framebuffer updates into the client protocol without a server
+class BenchmarkVncClientProtocol : public VncClientProtocol
+{
+public:
+	explicit BenchmarkVncClientProtocol( QIODevice* socket ) :
+		VncClientProtocol( socket, {} )
+	{
+		setState( State::Running );
+	}
+};
 
 
 TestingCommandLinePlugin::TestingCommandLinePlugin( QObject* parent ) :
@@ -35,6 +59,10 @@ TestingCommandLinePlugin::TestingCommandLinePlugin( QObject* parent ) :
 { QStringLiteral("authorizedgroups"), QStringLiteral( "check if specified user is in authorized groups [ACCESSING USER]" ) },
 { QStringLiteral("accesscontrolrules"), QStringLiteral( "process access control rules with arguments [ACCESSING USER] [ACCESSING COMPUTER] [LOCAL USER] [LOCAL COMPUTER] [CONNECTED USER] [AUTH METHOD UID]" ) },
 { QStringLiteral("isaccessdeniedbylocalstate"), QStringLiteral( "check if access would be denied by local state") },
+{ QStringLiteral("benchmarkaccesscontrolrules"), QStringLiteral( "evaluate synthetic user/computer tuples against a synthetic rule set with arguments [RULE COUNT] [DECISION COUNT]" ) },
+{ QStringLiteral("benchmarkauthentication"), QStringLiteral( "authenticate concurrently against the platform's user authentication with arguments [USER] [PASSWORD] [COUNT] [CONCURRENCY]" ) },
+{ QStringLiteral("benchmarkscaler"), QStringLiteral( "downscale a random framebuffer with all supported scaler implementations and compare the results with arguments [WIDTH] [HEIGHT] [ITERATIONS]" ) },
+{ QStringLiteral("benchmarkupdateparser"), QStringLiteral( "parse synthetic framebuffer updates arriving in segments of various sizes with arguments [UPDATE COUNT]" ) },
 				} )
 {
 }
@@ -126,6 +154,317 @@ CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_isaccessd
 
 
 
+CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_benchmarkaccesscontrolrules( const QStringList& arguments )
+{
+	bool ruleCountValid = true;
+	bool decisionCountValid = true;
+	const auto ruleCount = arguments.count() > 0 ? arguments[0].toInt( &ruleCountValid ) : DefaultBenchmarkRuleCount;
+	const auto decisionCount = arguments.count() > 1 ? arguments[1].toInt( &decisionCountValid ) : DefaultBenchmarkDecisionCount;
+
+	if( ruleCountValid == false || decisionCountValid == false || ruleCount <= 0 || decisionCount <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	AccessControlProvider provider( generateBenchmarkRules( ruleCount ) );
+
+	// fixed seed so that subsequent runs evaluate identical tuples
+	QRandomGenerator random( 1 );
+
+	const QList<Plugin::Uid> authMethodUids{ Plugin::Uid::createUuid(), Plugin::Uid::createUuid() };
+	const auto localUser = QStringLiteral("benchmark-user-0");
+	const auto localComputer = QStringLiteral("benchmark-computer-0.veyon.invalid");
+
+	QMap<AccessControlRule::Action, int> results;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for( int i = 0; i < decisionCount; ++i )
+	{
+		const auto accessingUser = QStringLiteral("benchmark-user-%1").arg( random.bounded( BenchmarkUserCount ) );
+		const auto accessingComputer = QStringLiteral("benchmark-computer-%1.veyon.invalid").arg( random.bounded( BenchmarkComputerCount ) );
+
+		QStringList connectedUsers;
+		for( int connectedUserCount = random.bounded( 3 ); connectedUserCount > 0; --connectedUserCount )
+		{
+			connectedUsers.append( QStringLiteral("benchmark-user-%1").arg( random.bounded( BenchmarkUserCount ) ) );
+		}
+
+		const auto rule = provider.processAccessControlRules( accessingUser, accessingComputer,
+															  localUser, localComputer, connectedUsers,
+															  authMethodUids.value( random.bounded( authMethodUids.count() ) ) );
+		++results[rule ? rule->action() : AccessControlRule::Action::None];
+	}
+
+	const auto elapsed = timer.nsecsElapsed();
+
+	CommandLineIO::print( QStringLiteral("Evaluated %1 decisions against %2 rules in %3 ms (%4 us per decision)")
+						  .arg( decisionCount ).arg( ruleCount )
+						  .arg( double( elapsed ) / 1000000, 0, 'f', 1 )
+						  .arg( double( elapsed ) / 1000 / decisionCount, 0, 'f', 1 ) );
+	CommandLineIO::print( QStringLiteral("Allow: %1, deny: %2, ask for permission: %3, no matching rule: %4")
+						  .arg( results.value( AccessControlRule::Action::Allow ) )
+						  .arg( results.value( AccessControlRule::Action::Deny ) )
+						  .arg( results.value( AccessControlRule::Action::AskForPermission ) )
+						  .arg( results.value( AccessControlRule::Action::None ) ) );
+
+	return Successful;
+}
+
+
+
+CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_benchmarkauthentication( const QStringList& arguments )
+{
+	if( arguments.count() < 2 )
+	{
+		return NotEnoughArguments;
+	}
+
+	bool countValid = true;
+	bool concurrencyValid = true;
+	const auto username = arguments[0];
+	const PlatformUserFunctions::Password password( arguments[1].toUtf8() );
+	const auto count = arguments.count() > 2 ? arguments[2].toInt( &countValid ) : DefaultBenchmarkAuthenticationCount;
+	const auto concurrency = arguments.count() > 3 ? arguments[3].toInt( &concurrencyValid ) : DefaultBenchmarkAuthenticationConcurrency;
+
+	if( countValid == false || concurrencyValid == false || count <= 0 || concurrency <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	QThreadPool threadPool;
+	threadPool.setMaxThreadCount( concurrency );
+
+	QVector<QFuture<qint64>> futures;
+	futures.reserve( count );
+
+	QAtomicInt failures{0};
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for( int i = 0; i < count; ++i )
+	{
+		futures.append( QtConcurrent::run( &threadPool, [&]() {
+			QElapsedTimer latencyTimer;
+			latencyTimer.start();
+			if( VeyonCore::platform().userFunctions().authenticate( username, password ) == false )
+			{
+				failures.fetchAndAddRelaxed( 1 );
+			}
+			return latencyTimer.nsecsElapsed();
+		} ) );
+	}
+
+	QVector<qint64> latencies;
+	latencies.reserve( count );
+	for( auto& future : futures )
+	{
+		latencies.append( future.result() );
+	}
+
+	const auto elapsed = timer.nsecsElapsed();
+
+	std::sort( latencies.begin(), latencies.end() );
+	const auto percentile = [&latencies]( int p ) {
+		return double( latencies[qMin( latencies.count() - 1, latencies.count() * p / 100 )] ) / 1000000;
+	};
+
+	CommandLineIO::print( QStringLiteral("Performed %1 authentications with concurrency %2 in %3 ms (%4 per second), %5 failed")
+						  .arg( count ).arg( concurrency )
+						  .arg( double( elapsed ) / 1000000, 0, 'f', 1 )
+						  .arg( double( count ) * 1000000000 / double( elapsed ), 0, 'f', 1 )
+						  .arg( int( failures ) ) );
+	CommandLineIO::print( QStringLiteral("Latency p50: %1 ms, p95: %2 ms, p99: %3 ms")
+						  .arg( percentile( 50 ), 0, 'f', 1 )
+						  .arg( percentile( 95 ), 0, 'f', 1 )
+						  .arg( percentile( 99 ), 0, 'f', 1 ) );
+
+	return Successful;
+}
+
+
+
+CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_benchmarkupdateparser( const QStringList& arguments )
+{
+	bool countValid = true;
+	const auto count = arguments.count() > 0 ? arguments[0].toInt( &countValid ) : DefaultBenchmarkUpdateCount;
+
+	if( countValid == false || count <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	const auto update = generateBenchmarkUpdate();
+
+	QByteArray stream;
+	stream.reserve( update.size() * count );
+	for( int i = 0; i < count; ++i )
+	{
+		stream.append( update );
+	}
+
+	rfbPixelFormat pixelFormat{};
+	pixelFormat.bitsPerPixel = 32;
+	pixelFormat.depth = 24;
+	pixelFormat.trueColour = 1;
+	pixelFormat.redMax = 255;
+	pixelFormat.greenMax = 255;
+	pixelFormat.blueMax = 255;
+	pixelFormat.redShift = 16;
+	pixelFormat.greenShift = 8;
+	pixelFormat.blueShift = 0;
+
+	bool success = true;
+
+	// segment sizes from single bytes over typical TCP segments up to large reads
+	for( const auto segmentSize : { 1, 64, 1460, 16384, 262144 } )
+	{
+		QBuffer buffer;
+		buffer.open( QIODevice::ReadWrite );
+
+		BenchmarkVncClientProtocol protocol( &buffer );
+		protocol.setPixelFormat( pixelFormat );
+		buffer.buffer().clear();
+		buffer.seek( 0 );
+
+		int updates = 0;
+		qint64 updateBytes = 0;
+
+		QElapsedTimer timer;
+		timer.start();
+
+		for( int offset = 0; offset < stream.size() && buffer.isOpen(); offset += segmentSize )
+		{
+			buffer.buffer().append( stream.constData() + offset, qMin( segmentSize, int(stream.size()) - offset ) );
+
+			while( buffer.isOpen() && protocol.receiveMessage() )
+			{
+				++updates;
+				updateBytes += protocol.lastMessage().size();
+			}
+
+			// drop data which has been parsed already
+			if( buffer.bytesAvailable() == 0 )
+			{
+				buffer.buffer().clear();
+				buffer.seek( 0 );
+			}
+		}
+
+		const auto elapsed = timer.nsecsElapsed();
+
+		// each update has to be received completely and exactly once regardless of the segment size
+		const auto valid = updates == count && updateBytes == stream.size();
+		success &= valid;
+
+		CommandLineIO::print( QStringLiteral("Segment size %1: parsed %2 updates (%3 MB) in %4 ms (%5 MB/s)%6")
+							  .arg( segmentSize ).arg( updates )
+							  .arg( double( updateBytes ) / ( 1024 * 1024 ), 0, 'f', 1 )
+							  .arg( double( elapsed ) / 1000000, 0, 'f', 1 )
+							  .arg( double( updateBytes ) * 1000000000 / ( 1024 * 1024 ) / double( qMax<qint64>( 1, elapsed ) ), 0, 'f', 1 )
+							  .arg( valid ? QString() : QStringLiteral(" - FAIL") ) );
+	}
+
+	return success ? Successful : Failed;
+}
+
+
+
+CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_benchmarkscaler( const QStringList& arguments )
+{
+	bool widthValid = true;
+	bool heightValid = true;
+	bool iterationsValid = true;
+	const auto width = arguments.count() > 0 ? arguments[0].toInt( &widthValid ) : DefaultBenchmarkScalerWidth;
+	const auto height = arguments.count() > 1 ? arguments[1].toInt( &heightValid ) : DefaultBenchmarkScalerHeight;
+	const auto iterations = arguments.count() > 2 ? arguments[2].toInt( &iterationsValid ) : DefaultBenchmarkScalerIterations;
+
+	if( widthValid == false || heightValid == false || iterationsValid == false ||
+		width < BenchmarkScalerFactor || height < BenchmarkScalerFactor || iterations <= 0 )
+	{
+		return InvalidArguments;
+	}
+
+	// fixed seed so that subsequent runs scale identical images
+	QRandomGenerator random( 3 );
+
+	QImage source( width, height, QImage::Format_RGB32 );
+	for( int y = 0; y < height; ++y )
+	{
+		random.fillRange( reinterpret_cast<quint32 *>( source.scanLine( y ) ), width );
+	}
+
+	// also use a size which does not divide the source size evenly
+	const QList<QSize> targetSizes{ { width / BenchmarkScalerFactor, height / BenchmarkScalerFactor },
+									{ width * 2 / ( BenchmarkScalerFactor * 3 ), height * 2 / ( BenchmarkScalerFactor * 3 ) } };
+
+	using Implementation = FramebufferScaler::Implementation;
+	const QList<QPair<Implementation, QString>> implementations{
+		{ Implementation::Scalar, QStringLiteral("Scalar") },
+		{ Implementation::SSE2, QStringLiteral("SSE2") },
+		{ Implementation::AVX2, QStringLiteral("AVX2") },
+		{ Implementation::NEON, QStringLiteral("NEON") } };
+
+	const auto benchmark = [&]( const std::function<QImage()>& scale ) {
+		QElapsedTimer timer;
+		timer.start();
+		for( int i = 0; i < iterations; ++i )
+		{
+			scale();
+		}
+		return double( timer.nsecsElapsed() ) / 1000000 / iterations;
+	};
+
+	bool success = true;
+
+	for( const auto& targetSize : targetSizes )
+	{
+		if( targetSize.isEmpty() )
+		{
+			continue;
+		}
+
+		const auto qtTime = benchmark( [&]() {
+			return source.scaled( targetSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation );
+		} );
+
+		CommandLineIO::print( QStringLiteral("%1x%2 -> %3x%4: QImage::scaled(): %5 ms")
+							  .arg( width ).arg( height ).arg( targetSize.width() ).arg( targetSize.height() )
+							  .arg( qtTime, 0, 'f', 2 ) );
+
+		const auto reference = FramebufferScaler::scaled( source, targetSize, Qt::IgnoreAspectRatio, Implementation::Scalar );
+
+		for( const auto& implementation : implementations )
+		{
+			if( FramebufferScaler::isSupported( implementation.first ) == false )
+			{
+				continue;
+			}
+
+			const auto time = benchmark( [&]() {
+				return FramebufferScaler::scaled( source, targetSize, Qt::IgnoreAspectRatio, implementation.first );
+			} );
+
+			// accelerated implementations have to produce exactly the same pixels as the scalar reference
+			const auto exact = FramebufferScaler::scaled( source, targetSize, Qt::IgnoreAspectRatio, implementation.first ) == reference;
+			success &= exact;
+
+			CommandLineIO::print( QStringLiteral("%1x%2 -> %3x%4: %5: %6 ms (%7x faster than QImage::scaled()), %8")
+								  .arg( width ).arg( height ).arg( targetSize.width() ).arg( targetSize.height() )
+								  .arg( implementation.second )
+								  .arg( time, 0, 'f', 2 )
+								  .arg( qtTime / qMax( time, 0.001 ), 0, 'f', 1 )
+								  .arg( exact ? QStringLiteral("pixel-exact") : QStringLiteral("FAIL - differs from scalar reference") ) );
+		}
+	}
+
+	return success ? Successful : Failed;
+}
+
+
+
 CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_ping( const QStringList& arguments )
 {
 	if( arguments.count() < 1 )
@@ -135,3 +474,122 @@ CommandLinePluginInterface::RunResult TestingCommandLinePlugin::handle_ping( con
 
 	return VeyonCore::platform().networkFunctions().ping( arguments.first() ) == PlatformNetworkFunctions::PingResult::ReplyReceived ? Successful : Failed;
 }
+
+
+
+QJsonArray TestingCommandLinePlugin::generateBenchmarkRules( int count )
+{
+	using Condition = AccessControlRule::Condition;
+	using Subject = AccessControlRule::Subject;
+
+	QRandomGenerator random( 2 );
+
+	QJsonArray rules;
+
+	for( int i = 0; i < count; ++i )
+	{
+		AccessControlRule rule;
+		rule.setName( QStringLiteral("Benchmark rule %1").arg( i ) );
+
+		switch( i % 3 )
+		{
+		case 0: rule.setAction( AccessControlRule::Action::Allow ); break;
+		case 1: rule.setAction( AccessControlRule::Action::Deny ); break;
+		default: rule.setAction( AccessControlRule::Action::AskForPermission ); break;
+		}
+
+		const auto group = QStringLiteral("benchmark-group-%1").arg( random.bounded( count ) );
+		const auto location = QStringLiteral("benchmark-location-%1").arg( random.bounded( count ) );
+
+		// mix literal arguments, regular expressions and wildcards as well as conditions
+		// with and without lookups in the user groups backend and the network object directory
+		switch( i % 6 )
+		{
+		case 0:
+			rule.setConditionEnabled( Condition::MemberOfGroup, true );
+			rule.setSubject( Condition::MemberOfGroup, Subject::AccessingUser );
+			rule.setArgument( Condition::MemberOfGroup, group );
+			break;
+		case 1:
+			rule.setConditionEnabled( Condition::MemberOfGroup, true );
+			rule.setSubject( Condition::MemberOfGroup, Subject::AccessingUser );
+			rule.setArgument( Condition::MemberOfGroup, QStringLiteral("/%1\\d+/").arg( group ) );
+			break;
+		case 2:
+			rule.setConditionEnabled( Condition::MemberOfGroup, true );
+			rule.setSubject( Condition::MemberOfGroup, Subject::LocalUser );
+			rule.setArgument( Condition::MemberOfGroup, group + QLatin1Char('*') );
+			break;
+		case 3:
+			rule.setConditionEnabled( Condition::LocatedAt, true );
+			rule.setSubject( Condition::LocatedAt, Subject::AccessingComputer );
+			rule.setArgument( Condition::LocatedAt, location );
+			break;
+		case 4:
+			rule.setConditionEnabled( Condition::AccessFromAlreadyConnectedUser, true );
+			rule.setConditionEnabled( Condition::AuthenticationMethod, true );
+			rule.setArgument( Condition::AuthenticationMethod, Plugin::Uid::createUuid().toString() );
+			break;
+		default:
+			rule.setConditionEnabled( Condition::AccessFromSameUser, true );
+			rule.setConditionInverted( Condition::AccessFromSameUser, true );
+			rule.setConditionEnabled( Condition::GroupsInCommon, true );
+			rule.setConditionEnabled( Condition::LocationsInCommon, true );
+			break;
+		}
+
+		rules.append( rule.toJson() );
+	}
+
+	return rules;
+}
+
+
+
+QByteArray TestingCommandLinePlugin::generateBenchmarkUpdate()
+{
+	const auto appendRectHeader = []( QByteArray& data, int x, int y, int encoding ) {
+		rfbFramebufferUpdateRectHeader header{};
+		header.r.x = qToBigEndian<uint16_t>( uint16_t(x) );
+		header.r.y = qToBigEndian<uint16_t>( uint16_t(y) );
+		header.r.w = qToBigEndian<uint16_t>( BenchmarkRectSize );
+		header.r.h = qToBigEndian<uint16_t>( BenchmarkRectSize );
+		header.encoding = qToBigEndian<uint32_t>( uint32_t(encoding) );
+		data.append( reinterpret_cast<const char *>( &header ), sz_rfbFramebufferUpdateRectHeader );
+	};
+
+	rfbFramebufferUpdateMsg message{};
+	message.type = rfbFramebufferUpdate;
+	message.nRects = qToBigEndian<uint16_t>( BenchmarkHextileRectCount + BenchmarkRawRectCount );
+
+	QByteArray update( reinterpret_cast<const char *>( &message ), sz_rfbFramebufferUpdateMsg );
+
+	// hextile rects with a background color and a few subrects per tile require parsing tile by tile
+	QByteArray tile( 1, char(rfbHextileBackgroundSpecified | rfbHextileAnySubrects) );
+	tile.append( 4, char(0x7f) );
+	tile.append( char(4) );
+	for( int i = 0; i < 4; ++i )
+	{
+		tile.append( char( i * 0x44 ) );
+		tile.append( char( 0x33 ) );
+	}
+
+	constexpr auto TilesPerRect = ( BenchmarkRectSize / 16 ) * ( BenchmarkRectSize / 16 );
+
+	for( int i = 0; i < BenchmarkHextileRectCount; ++i )
+	{
+		appendRectHeader( update, i * BenchmarkRectSize, 0, rfbEncodingHextile );
+		for( int t = 0; t < TilesPerRect; ++t )
+		{
+			update.append( tile );
+		}
+	}
+
+	for( int i = 0; i < BenchmarkRawRectCount; ++i )
+	{
+		appendRectHeader( update, i * BenchmarkRectSize, BenchmarkRectSize, rfbEncodingRaw );
+		update.append( BenchmarkRectSize * BenchmarkRectSize * 4, char(0x55) );
+	}
+
+	return update;
+}
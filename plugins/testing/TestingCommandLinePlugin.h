@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QJsonArray>
+
 #include "CommandLinePluginInterface.h"
 #include "VeyonConfiguration.h"
 
@@ -84,9 +86,31 @@ public Q_SLOTS:
 	CommandLinePluginInterface::RunResult handle_authorizedgroups( const QStringList& arguments );
 	CommandLinePluginInterface::RunResult handle_accesscontrolrules( const QStringList& arguments );
 	CommandLinePluginInterface::RunResult handle_isaccessdeniedbylocalstate( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_benchmarkaccesscontrolrules( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_benchmarkauthentication( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_benchmarkupdateparser( const QStringList& arguments );
+	CommandLinePluginInterface::RunResult handle_benchmarkscaler( const QStringList& arguments );
 	CommandLinePluginInterface::RunResult handle_ping( const QStringList& arguments );
 
 private:
+	static constexpr int DefaultBenchmarkRuleCount = 1000;
+	static constexpr int DefaultBenchmarkDecisionCount = 10000;
+	static constexpr int BenchmarkUserCount = 256;
+	static constexpr int BenchmarkComputerCount = 256;
+	static constexpr int DefaultBenchmarkAuthenticationCount = 100;
+	static constexpr int DefaultBenchmarkAuthenticationConcurrency = 4;
+	static constexpr int DefaultBenchmarkUpdateCount = 100;
+	static constexpr int BenchmarkRectSize = 64;
+	static constexpr int BenchmarkHextileRectCount = 16;
+	static constexpr int BenchmarkRawRectCount = 4;
+	static constexpr int DefaultBenchmarkScalerWidth = 1920;
+	static constexpr int DefaultBenchmarkScalerHeight = 1080;
+	static constexpr int DefaultBenchmarkScalerIterations = 100;
+	static constexpr int BenchmarkScalerFactor = 4;
+
+	static QJsonArray generateBenchmarkRules( int count );
+	static QByteArray generateBenchmarkUpdate();
+
 	QMap<QString, QString> m_commands;
 
 };
@@ -27,10 +27,13 @@ extern "C" {
 }
 
 #include <array>
+#include <memory>
 
+#include <QElapsedTimer>
 #include <QImage>
 
 #include "HeadlessVncServer.h"
+#include "SyntheticWorkload.h"
 #include "VeyonConfiguration.h"
 
 
@@ -44,6 +47,7 @@ struct HeadlessVncScreen
 	rfbScreenInfoPtr rfbScreen{nullptr};
 	std::array<char *, 2> passwords{};
 	QImage framebuffer;
+	std::unique_ptr<SyntheticWorkload> workload;
 
 };
 
@@ -72,11 +76,41 @@ bool HeadlessVncServer::runServer( int serverPort, const Password& password )
 		return false;
 	}
 
-	while( true )
-	{
-		QThread::msleep( DefaultSleepTime );
+	// all times in microseconds
+	const qint64 frameInterval = 1000000 / qBound( 1, m_configuration.workloadDamageRate(), MaximumDamageRate );
+	qint64 nextFrameTime = 0;
+
+	QElapsedTimer timer;
+	timer.start();
 
-		rfbProcessEvents( screen.rfbScreen, 0 );
+	while( QThread::currentThread()->isInterruptionRequested() == false )
+	{
+		qint64 timeout = IdleTimeout * 1000;
+
+		if( screen.workload )
+		{
+			const auto now = timer.nsecsElapsed() / 1000;
+			if( now >= nextFrameTime )
+			{
+				for( const auto& rect : screen.workload->nextFrame() )
+				{
+					rfbMarkRectAsModified( screen.rfbScreen, rect.left(), rect.top(), rect.right() + 1, rect.bottom() + 1 );
+				}
+
+				// keep a steady frame rate but do not try to catch up after delays
+				nextFrameTime += frameInterval;
+				if( nextFrameTime <= now )
+				{
+					nextFrameTime = now + frameInterval;
+				}
+			}
+
+			timeout = qMin( timeout, nextFrameTime - now );
+		}
+
+		// block until a client sends data or the next frame is due - modified areas are sent
+		// to clients with pending update requests right away
+		rfbProcessEvents( screen.rfbScreen, long( qMax<qint64>( 0, timeout ) ) );
 	}
 
 	rfbShutdownServer( screen.rfbScreen, true );
@@ -89,9 +123,18 @@ bool HeadlessVncServer::runServer( int serverPort, const Password& password )
 
 bool HeadlessVncServer::initScreen( HeadlessVncScreen* screen )
 {
-	screen->framebuffer = QImage( DefaultFramebufferWidth, DefaultFramebufferHeight, QImage::Format_RGB32 );
+	screen->framebuffer = QImage( qBound( 1, m_configuration.framebufferWidth(), MaximumFramebufferSize ),
+								  qBound( 1, m_configuration.framebufferHeight(), MaximumFramebufferSize ),
+								  QImage::Format_RGB32 );
 	screen->framebuffer.fill( m_configuration.backgroundColor() );
 
+	const auto workloadMode = SyntheticWorkload::Mode( m_configuration.workloadMode() );
+	if( workloadMode > SyntheticWorkload::Mode::None && workloadMode <= SyntheticWorkload::Mode::Typing )
+	{
+		screen->workload = std::make_unique<SyntheticWorkload>( workloadMode, quint32( m_configuration.workloadSeed() ),
+																screen->framebuffer, m_configuration.backgroundColor() );
+	}
+
 	return true;
 }
 
@@ -132,7 +175,8 @@ bool HeadlessVncServer::initVncServer( int serverPort, const VncServerPluginInte
 
 	rfbScreen->alwaysShared = true;
 	rfbScreen->handleEventsEagerly = true;
-	rfbScreen->deferUpdateTime = 5;
+	// send updates immediately as all modifications of a frame are marked at once
+	rfbScreen->deferUpdateTime = 0;
 
 	rfbScreen->screenData = screen;
 
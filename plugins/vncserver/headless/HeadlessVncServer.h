@@ -98,9 +98,9 @@ public:
 	}
 
 private:
-	static constexpr auto DefaultFramebufferWidth = 640;
-	static constexpr auto DefaultFramebufferHeight = 480;
-	static constexpr auto DefaultSleepTime = 25;
+	static constexpr auto MaximumFramebufferSize = 8192;
+	static constexpr auto IdleTimeout = 100;
+	static constexpr auto MaximumDamageRate = 1000;
 
 	bool initScreen( HeadlessVncScreen* screen );
 	bool initVncServer( int serverPort, const VncServerPluginInterface::Password& password,
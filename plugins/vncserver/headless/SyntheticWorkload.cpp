@@ -0,0 +1,308 @@
+/*
+ * SyntheticWorkload.cpp - implementation of SyntheticWorkload class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QFontMetrics>
+#include <QPainter>
+
+#include "SyntheticWorkload.h"
+
+
+SyntheticWorkload::SyntheticWorkload( Mode mode, quint32 seed, QImage& framebuffer, const QColor& backgroundColor ) :
+	m_mode( mode ),
+	m_random( seed ),
+	m_framebuffer( framebuffer ),
+	m_backgroundColor( backgroundColor ),
+	m_font( QStringLiteral("monospace"), FontSize )
+{
+	m_font.setStyleHint( QFont::Monospace );
+
+	const QFontMetrics fontMetrics( m_font );
+	m_characterSize = { qMax( 1, fontMetrics.averageCharWidth() ), qMax( 1, fontMetrics.height() ) };
+
+	m_framebuffer.fill( m_backgroundColor );
+
+	const auto width = m_framebuffer.width();
+	const auto height = m_framebuffer.height();
+
+	switch( m_mode )
+	{
+	case Mode::ScrollingText:
+		m_textArea = m_framebuffer.rect();
+		m_framebuffer.fill( Qt::black );
+		break;
+
+	case Mode::MovingWindows:
+		for( int i = 0; i < WindowCount; ++i )
+		{
+			const QSize size( width / 4 + int( m_random.bounded( width / 4 + 1 ) ),
+							  height / 4 + int( m_random.bounded( height / 4 + 1 ) ) );
+			const QPoint position( int( m_random.bounded( width - size.width() + 1 ) ),
+								   int( m_random.bounded( height - size.height() + 1 ) ) );
+			const QPoint velocity( int( m_random.bounded( 1, 9 ) ), int( m_random.bounded( 1, 9 ) ) );
+
+			m_windows.append( { QRect( position, size ), velocity, randomColor() } );
+		}
+
+		for( const auto& window : std::as_const( m_windows ) )
+		{
+			drawWindow( window );
+		}
+		break;
+
+	case Mode::IdleDesktop:
+	case Mode::Typing:
+		// a single text editor window in the middle of the desktop
+		m_windows.append( { QRect( width / 8, height / 8, width * 3 / 4, height * 3 / 4 ), {}, randomColor() } );
+		drawWindow( m_windows.constFirst() );
+
+		m_textArea = m_windows.constFirst().geometry.adjusted( 4, TitleBarHeight + 4, -4, -4 );
+		m_cursorPosition = m_textArea.topLeft();
+
+		if( m_mode == Mode::IdleDesktop )
+		{
+			QPainter painter( &m_framebuffer );
+			painter.setFont( m_font );
+			painter.setPen( Qt::black );
+			painter.drawText( m_textArea, Qt::TextWordWrap, randomText( m_textArea.width() / m_characterSize.width() * 4 ) );
+
+			m_cursorPosition.ry() += m_characterSize.height() * 4;
+		}
+		break;
+
+	case Mode::VideoNoise:
+	case Mode::None:
+		break;
+	}
+}
+
+
+
+QVector<QRect> SyntheticWorkload::nextFrame()
+{
+	switch( m_mode )
+	{
+	case Mode::ScrollingText: return { scrollText() };
+	case Mode::MovingWindows: return moveWindows();
+	case Mode::VideoNoise: return { renderNoise() };
+	case Mode::IdleDesktop: return { toggleCursor() };
+	case Mode::Typing: return typeCharacter();
+	case Mode::None: break;
+	}
+
+	return {};
+}
+
+
+
+QRect SyntheticWorkload::scrollText()
+{
+	const auto lineHeight = m_characterSize.height();
+	const auto bytesPerLine = m_framebuffer.bytesPerLine();
+	const auto height = m_framebuffer.height();
+
+	if( height > lineHeight )
+	{
+		// scroll the whole terminal by one line
+		memmove( m_framebuffer.bits(), m_framebuffer.constBits() + lineHeight * bytesPerLine,
+				 size_t( ( height - lineHeight ) * bytesPerLine ) );
+	}
+
+	const QRect newLine( 0, qMax( 0, height - lineHeight ), m_framebuffer.width(), qMin( lineHeight, height ) );
+
+	QPainter painter( &m_framebuffer );
+	painter.fillRect( newLine, Qt::black );
+	painter.setFont( m_font );
+	painter.setPen( Qt::green );
+	painter.drawText( newLine, Qt::AlignLeft | Qt::AlignVCenter,
+					  randomText( int( m_random.bounded( m_framebuffer.width() / m_characterSize.width() + 1 ) ) ) );
+
+	return m_textArea;
+}
+
+
+
+QVector<QRect> SyntheticWorkload::moveWindows()
+{
+	QVector<QRect> modifiedRects;
+	modifiedRects.reserve( m_windows.size() * 2 );
+
+	const auto bounds = m_framebuffer.rect();
+
+	QPainter painter( &m_framebuffer );
+
+	for( auto& window : m_windows )
+	{
+		painter.fillRect( window.geometry, m_backgroundColor );
+		modifiedRects.append( window.geometry );
+
+		auto geometry = window.geometry.translated( window.velocity );
+		if( geometry.left() < bounds.left() || geometry.right() > bounds.right() )
+		{
+			window.velocity.rx() = -window.velocity.x();
+		}
+		if( geometry.top() < bounds.top() || geometry.bottom() > bounds.bottom() )
+		{
+			window.velocity.ry() = -window.velocity.y();
+		}
+
+		window.geometry.translate( window.velocity );
+		modifiedRects.append( window.geometry );
+	}
+
+	painter.end();
+
+	// redraw all windows in their stacking order since they may overlap
+	for( const auto& window : std::as_const( m_windows ) )
+	{
+		drawWindow( window );
+	}
+
+	return modifiedRects;
+}
+
+
+
+QRect SyntheticWorkload::renderNoise()
+{
+	// coarse random blocks with fine-grained noise resemble the entropy of video content
+	static constexpr int BlockSize = 8;
+
+	const auto width = m_framebuffer.width();
+	const auto height = m_framebuffer.height();
+
+	for( int blockY = 0; blockY < height; blockY += BlockSize )
+	{
+		for( int blockX = 0; blockX < width; blockX += BlockSize )
+		{
+			const auto baseColor = m_random.generate() & 0x00f0f0f0;
+
+			for( int y = blockY; y < qMin( blockY + BlockSize, height ); ++y )
+			{
+				auto line = reinterpret_cast<QRgb *>( m_framebuffer.scanLine( y ) );
+				const auto noise = m_random.generate();
+
+				for( int x = blockX; x < qMin( blockX + BlockSize, width ); ++x )
+				{
+					line[x] = 0xff000000 | baseColor | ( ( noise >> ( x - blockX ) ) & 0x000f0f0f );
+				}
+			}
+		}
+	}
+
+	return m_framebuffer.rect();
+}
+
+
+
+QRect SyntheticWorkload::toggleCursor()
+{
+	const QRect cursor( m_cursorPosition, QSize( CursorWidth, m_characterSize.height() ) );
+
+	m_cursorVisible = !m_cursorVisible;
+
+	QPainter painter( &m_framebuffer );
+	painter.fillRect( cursor, m_cursorVisible ? Qt::black : m_windows.constFirst().color );
+
+	return cursor;
+}
+
+
+
+QVector<QRect> SyntheticWorkload::typeCharacter()
+{
+	QVector<QRect> modifiedRects;
+
+	QPainter painter( &m_framebuffer );
+	painter.setFont( m_font );
+
+	if( m_cursorPosition.y() + m_characterSize.height() > m_textArea.bottom() )
+	{
+		// page is full - start with an empty one
+		painter.fillRect( m_textArea, m_windows.constFirst().color );
+		modifiedRects.append( m_textArea );
+		m_cursorPosition = m_textArea.topLeft();
+	}
+
+	const QRect character( m_cursorPosition, m_characterSize );
+
+	painter.fillRect( character, m_windows.constFirst().color );
+	painter.setPen( Qt::black );
+	painter.drawText( character, Qt::AlignLeft | Qt::AlignVCenter, randomText( 1 ) );
+	modifiedRects.append( character );
+
+	m_cursorPosition.rx() += m_characterSize.width();
+
+	// finish words and lines randomly like a human typist
+	if( m_cursorPosition.x() + m_characterSize.width() > m_textArea.right() || m_random.bounded( 40 ) == 0 )
+	{
+		m_cursorPosition = { m_textArea.left(), m_cursorPosition.y() + m_characterSize.height() };
+	}
+
+	if( m_cursorPosition.y() + m_characterSize.height() <= m_textArea.bottom() )
+	{
+		const QRect cursor( m_cursorPosition, QSize( CursorWidth, m_characterSize.height() ) );
+		painter.fillRect( cursor, Qt::black );
+		modifiedRects.append( cursor );
+	}
+
+	return modifiedRects;
+}
+
+
+
+void SyntheticWorkload::drawWindow( const Window& window )
+{
+	QPainter painter( &m_framebuffer );
+
+	painter.fillRect( window.geometry, window.color );
+	painter.fillRect( QRect( window.geometry.topLeft(), QSize( window.geometry.width(), TitleBarHeight ) ),
+					  window.color.darker() );
+	painter.setPen( Qt::black );
+	painter.drawRect( window.geometry.adjusted( 0, 0, -1, -1 ) );
+}
+
+
+
+QString SyntheticWorkload::randomText( int length )
+{
+	QString text;
+	text.reserve( length );
+
+	for( int i = 0; i < length; ++i )
+	{
+		// roughly one blank per word of five characters
+		const auto value = m_random.bounded( 32 );
+		text.append( value >= 26 ? QLatin1Char(' ') : QLatin1Char( char( 'a' + value ) ) );
+	}
+
+	return text;
+}
+
+
+
+QColor SyntheticWorkload::randomColor()
+{
+	// light colors as typically used for window contents
+	return QColor::fromHsv( int( m_random.bounded( 360 ) ), int( m_random.bounded( 32, 96 ) ), 240 );
+}
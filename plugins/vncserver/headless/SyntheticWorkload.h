@@ -0,0 +1,94 @@
+/*
+ * SyntheticWorkload.h - declaration of SyntheticWorkload class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QVector>
+
+// generates reproducible screen content with typical change patterns for
+// benchmarking encoders and decoders without a real desktop session
+class SyntheticWorkload
+{
+public:
+	enum class Mode
+	{
+		None,
+		ScrollingText,
+		MovingWindows,
+		VideoNoise,
+		IdleDesktop,
+		Typing
+	};
+
+	SyntheticWorkload( Mode mode, quint32 seed, QImage& framebuffer, const QColor& backgroundColor );
+
+	Mode mode() const
+	{
+		return m_mode;
+	}
+
+	// draws the next frame into the framebuffer and returns the modified areas
+	QVector<QRect> nextFrame();
+
+private:
+	struct Window
+	{
+		QRect geometry;
+		QPoint velocity;
+		QColor color;
+	};
+
+	static constexpr int WindowCount = 4;
+	static constexpr int TitleBarHeight = 20;
+	static constexpr int CursorWidth = 2;
+	static constexpr int FontSize = 10;
+
+	QRect scrollText();
+	QVector<QRect> moveWindows();
+	QRect renderNoise();
+	QRect toggleCursor();
+	QVector<QRect> typeCharacter();
+
+	void drawWindow( const Window& window );
+	QString randomText( int length );
+	QColor randomColor();
+
+	const Mode m_mode;
+	QRandomGenerator m_random;
+	QImage& m_framebuffer;
+	const QColor m_backgroundColor;
+
+	QFont m_font;
+	QSize m_characterSize;
+
+	QVector<Window> m_windows;
+	QRect m_textArea;
+	QPoint m_cursorPosition;
+	bool m_cursorVisible{false};
+
+} ;
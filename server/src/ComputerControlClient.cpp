@@ -23,10 +23,12 @@
  */
 
 #include <QTcpSocket>
+#include <QtEndian>
 
 #include "VeyonCore.h"
 #include "ComputerControlClient.h"
 #include "ComputerControlServer.h"
+#include "ThumbnailFramebuffer.h"
 
 
 ComputerControlClient::ComputerControlClient( ComputerControlServer* server,
@@ -43,12 +45,31 @@ ComputerControlClient::ComputerControlClient( ComputerControlServer* server,
 	m_clientProtocol( vncServerSocket(), vncServerPassword )
 {
 	m_framebufferUpdateTimer.start();
+
+	// continue protocol processing as soon as an authentication step finished in a worker thread
+	connect(&m_serverClient, &VncServerClient::authenticationFinished, this, &ComputerControlClient::readFromClient);
+
+	m_continuousFramebufferUpdateTimer.setSingleShot(true);
+	connect(&m_continuousFramebufferUpdateTimer, &QTimer::timeout,
+			this, &ComputerControlClient::requestContinuousFramebufferUpdate);
+	connect(clientSocket, &QTcpSocket::bytesWritten, this, &ComputerControlClient::handleClientBytesWritten);
+
+	m_deferredFramebufferUpdateRequestTimer.setSingleShot(true);
+	connect(&m_deferredFramebufferUpdateRequestTimer, &QTimer::timeout,
+			this, &ComputerControlClient::forwardDeferredFramebufferUpdateRequest);
 }
 
 
 
 ComputerControlClient::~ComputerControlClient()
 {
+	if (m_bandwidthLimit.statistics().deferrals > 0)
+	{
+		vDebug() << "deferred" << m_bandwidthLimit.statistics().deferrals << "framebuffer update requests while sending"
+				 << m_bandwidthLimit.statistics().consumedBytes << "bytes with a bandwidth limit of"
+				 << m_bandwidthLimit.rate() << "bytes/s";
+	}
+
 	m_server->accessControlManager().removeClient( &m_serverClient );
 }
 
@@ -69,8 +90,25 @@ bool ComputerControlClient::receiveClientMessage()
 		return m_server->handleFeatureMessage(this);
 	}
 
-	// filter framebuffer update requests when minimum framebuffer update interval is set
-	if (messageType == rfbFramebufferUpdateRequest && m_minimumFramebufferUpdateInterval > 0)
+	if (messageType == rfbSetPixelFormat)
+	{
+		return receiveSetPixelFormatMessage();
+	}
+
+	if (messageType == rfbSetEncodings)
+	{
+		return receiveSetEncodingsMessage();
+	}
+
+	if (messageType == rfbFramebufferUpdateRequest && m_thumbnailFramebuffer)
+	{
+		return receiveThumbnailFramebufferUpdateRequestMessage();
+	}
+
+	// filter framebuffer update requests when minimum framebuffer update interval or bandwidth limit
+	// is set or when incremental updates are requested by ourselves
+	if (messageType == rfbFramebufferUpdateRequest &&
+		(m_minimumFramebufferUpdateInterval > 0 || m_continuousFramebufferUpdates || m_bandwidthLimit.isEnabled()))
 	{
 		if (socket->bytesAvailable() < sz_rfbFramebufferUpdateRequestMsg)
 		{
@@ -81,13 +119,34 @@ bool ComputerControlClient::receiveClientMessage()
 		const auto updateRequestMessage = reinterpret_cast<const rfbFramebufferUpdateRequestMsg *>(messageData.constData());
 
 		if (updateRequestMessage->incremental &&
-			m_framebufferUpdateTimer.hasExpired(m_minimumFramebufferUpdateInterval) == false)
+			(m_continuousFramebufferUpdates ||
+			 (m_minimumFramebufferUpdateInterval > 0 &&
+			  m_framebufferUpdateTimer.hasExpired(m_minimumFramebufferUpdateInterval) == false)))
 		{
 			// discard update request
 			return true;
 		}
 
+		const auto delay = m_bandwidthLimit.defer();
+		if (delay > 0 || m_pendingPixelFormat.has_value())
+		{
+			// never replace a pending request for a full update by an incremental one
+			if (m_deferredFramebufferUpdateRequest.isEmpty() || updateRequestMessage->incremental == 0 ||
+				reinterpret_cast<const rfbFramebufferUpdateRequestMsg *>(m_deferredFramebufferUpdateRequest.constData())->incremental)
+			{
+				m_deferredFramebufferUpdateRequest = messageData;
+			}
+
+			// requests held back due to a pending pixel format are forwarded once it has been applied
+			if (delay > 0 && m_deferredFramebufferUpdateRequestTimer.isActive() == false)
+			{
+				m_deferredFramebufferUpdateRequestTimer.start(delay);
+			}
+			return true;
+		}
+
 		// forward request to server
+		m_framebufferUpdateRequestPending = true;
 		m_framebufferUpdateTimer.restart();
 		return vncServerSocket()->write(messageData) == messageData.size();
 	}
@@ -101,3 +160,461 @@ void ComputerControlClient::setMinimumFramebufferUpdateInterval(int interval)
 {
 	m_minimumFramebufferUpdateInterval = interval;
 }
+
+
+
+void ComputerControlClient::setContinuousFramebufferUpdates(bool enabled)
+{
+	// an update requested before stays pending until it has been received so that pixel format
+	// changes are never applied while an update is in flight
+	m_continuousFramebufferUpdates = enabled;
+
+	if (enabled)
+	{
+		m_deferredFramebufferUpdateRequest.clear();
+		requestContinuousFramebufferUpdate();
+	}
+	else if (m_thumbnailFramebuffer == nullptr)
+	{
+		m_continuousFramebufferUpdateTimer.stop();
+	}
+}
+
+
+
+void ComputerControlClient::setBandwidthLimit(int bytesPerSecond)
+{
+	m_bandwidthLimit.setRate(bytesPerSecond);
+
+	// apply new limit to deferred requests right away
+	if (m_deferredFramebufferUpdateRequestTimer.isActive())
+	{
+		m_deferredFramebufferUpdateRequestTimer.start(0);
+	}
+
+	if (m_continuousFramebufferUpdateTimer.isActive())
+	{
+		m_continuousFramebufferUpdateTimer.stop();
+		requestContinuousFramebufferUpdate();
+	}
+}
+
+
+
+QSize ComputerControlClient::setThumbnailSize(QSize size)
+{
+	m_requestedThumbnailSize = size;
+
+	const QSize framebufferSize{m_clientProtocol.framebufferWidth(), m_clientProtocol.framebufferHeight()};
+
+	if (size.isEmpty() ||
+		m_clientProtocol.state() != VncClientProtocol::State::Running ||
+		ThumbnailFramebuffer::thumbnailSize(framebufferSize, size).isEmpty() ||
+		ThumbnailFramebuffer::isSupportedPixelFormat(m_clientProtocol.pixelFormat()) == false ||
+		// client has to follow framebuffer size changes
+		m_clientEncodings.contains(rfbEncodingNewFBSize) == false)
+	{
+		disableThumbnailFramebuffer();
+		return {};
+	}
+
+	if (m_thumbnailFramebuffer)
+	{
+		if (m_thumbnailFramebuffer->requestedSize() != size)
+		{
+			m_thumbnailFramebuffer->resize(framebufferSize, size);
+			m_fullFramebufferUpdateRequired = true;
+			requestContinuousFramebufferUpdate();
+		}
+
+		return m_thumbnailFramebuffer->size();
+	}
+
+	m_thumbnailFramebuffer = std::make_unique<ThumbnailFramebuffer>(framebufferSize, size);
+	m_thumbnailFramebuffer->setClientPixelFormat(m_clientProtocol.pixelFormat());
+	m_thumbnailFramebuffer->setClientEncodings(m_clientEncodings);
+
+	m_clientFramebufferSize = {};
+	m_thumbnailFramebufferUpdateRequested = false;
+	m_fullFramebufferUpdateRequired = true;
+
+	// receive updates which can be applied without any decoding, the client keeps showing
+	// the full framebuffer until the thumbnail has been built up completely
+	m_clientProtocol.setEncodings({rfbEncodingRaw, rfbEncodingNewFBSize});
+
+	requestContinuousFramebufferUpdate();
+
+	return m_thumbnailFramebuffer->size();
+}
+
+
+
+bool ComputerControlClient::receiveServerMessage()
+{
+	if (m_thumbnailFramebuffer || m_pendingPixelFormat.has_value())
+	{
+		if (m_clientProtocol.receiveMessage() == false)
+		{
+			return false;
+		}
+
+		if (m_clientProtocol.lastMessageType() != rfbFramebufferUpdate)
+		{
+			proxyClientSocket()->write(m_clientProtocol.lastMessage());
+		}
+		else if (m_thumbnailFramebuffer)
+		{
+			updateThumbnailFramebuffer();
+		}
+		else
+		{
+			// the update is still encoded using the previous pixel format while the client decodes
+			// using the new one already, therefore drop it in favor of a full update
+			m_fullFramebufferUpdateRequired = true;
+			if (m_continuousFramebufferUpdates == false)
+			{
+				rfbFramebufferUpdateRequestMsg updateRequestMessage{};
+				updateRequestMessage.type = rfbFramebufferUpdateRequest;
+				updateRequestMessage.incremental = 0;
+				updateRequestMessage.w = qToBigEndian<uint16_t>(m_clientProtocol.framebufferWidth());
+				updateRequestMessage.h = qToBigEndian<uint16_t>(m_clientProtocol.framebufferHeight());
+				m_deferredFramebufferUpdateRequest = QByteArray(reinterpret_cast<const char *>(&updateRequestMessage),
+																 sz_rfbFramebufferUpdateRequestMsg);
+			}
+		}
+	}
+	else if (VncProxyConnection::receiveServerMessage() == false)
+	{
+		return false;
+	}
+
+	if (clientProtocol().lastMessageType() == rfbFramebufferUpdate)
+	{
+		m_framebufferUpdateRequestPending = false;
+		applyPendingPixelFormat();
+		requestContinuousFramebufferUpdate();
+	}
+
+	return true;
+}
+
+
+
+void ComputerControlClient::requestContinuousFramebufferUpdate()
+{
+	// keep exactly one update request pending at the VNC server so that updates are
+	// sent without waiting for a full round trip to the client for each of them
+	if ((m_continuousFramebufferUpdates == false && m_thumbnailFramebuffer == nullptr) ||
+		m_framebufferUpdateRequestPending ||
+		m_pendingPixelFormat.has_value() ||
+		m_clientProtocol.state() != VncClientProtocol::State::Running ||
+		// let the client connection drain first
+		proxyClientSocket()->bytesToWrite() > MaximumPendingFramebufferUpdateData ||
+		// update is scheduled already
+		m_continuousFramebufferUpdateTimer.isActive())
+	{
+		return;
+	}
+
+	if (m_minimumFramebufferUpdateInterval > 0)
+	{
+		const auto remainingInterval = m_minimumFramebufferUpdateInterval - m_framebufferUpdateTimer.elapsed();
+		if (remainingInterval > 0)
+		{
+			m_continuousFramebufferUpdateTimer.start(int(remainingInterval));
+			return;
+		}
+	}
+
+	const auto delay = m_bandwidthLimit.defer();
+	if (delay > 0)
+	{
+		m_continuousFramebufferUpdateTimer.start(delay);
+		return;
+	}
+
+	rfbFramebufferUpdateRequestMsg updateRequestMessage{};
+	updateRequestMessage.type = rfbFramebufferUpdateRequest;
+	updateRequestMessage.incremental = m_fullFramebufferUpdateRequired ? 0 : 1;
+	updateRequestMessage.w = qToBigEndian<uint16_t>(m_clientProtocol.framebufferWidth());
+	updateRequestMessage.h = qToBigEndian<uint16_t>(m_clientProtocol.framebufferHeight());
+
+	m_framebufferUpdateRequestPending = true;
+	m_fullFramebufferUpdateRequired = false;
+	m_framebufferUpdateTimer.restart();
+
+	vncServerSocket()->write(reinterpret_cast<const char *>(&updateRequestMessage), sz_rfbFramebufferUpdateRequestMsg);
+}
+
+
+
+void ComputerControlClient::forwardDeferredFramebufferUpdateRequest()
+{
+	if (m_deferredFramebufferUpdateRequest.isEmpty() ||
+		m_pendingPixelFormat.has_value() ||
+		m_clientProtocol.state() != VncClientProtocol::State::Running)
+	{
+		return;
+	}
+
+	const auto delay = m_bandwidthLimit.defer();
+	if (delay > 0)
+	{
+		m_deferredFramebufferUpdateRequestTimer.start(delay);
+		return;
+	}
+
+	m_framebufferUpdateRequestPending = true;
+	m_framebufferUpdateTimer.restart();
+	vncServerSocket()->write(m_deferredFramebufferUpdateRequest);
+	m_deferredFramebufferUpdateRequest.clear();
+}
+
+
+
+void ComputerControlClient::applyPendingPixelFormat()
+{
+	if (m_pendingPixelFormat.has_value() == false)
+	{
+		return;
+	}
+
+	m_clientProtocol.setPixelFormat(*m_pendingPixelFormat);
+	m_pendingPixelFormat.reset();
+
+	// forward requests which have been held back meanwhile
+	if (m_deferredFramebufferUpdateRequestTimer.isActive() == false)
+	{
+		forwardDeferredFramebufferUpdateRequest();
+	}
+}
+
+
+
+void ComputerControlClient::handleClientBytesWritten(qint64 bytes)
+{
+	m_bandwidthLimit.consume(bytes);
+
+	requestContinuousFramebufferUpdate();
+}
+
+
+
+bool ComputerControlClient::receiveSetPixelFormatMessage()
+{
+	auto socket = proxyClientSocket();
+
+	if (socket->bytesAvailable() < sz_rfbSetPixelFormatMsg)
+	{
+		return false;
+	}
+
+	rfbSetPixelFormatMsg message;
+	if (socket->read(reinterpret_cast<char *>(&message), sz_rfbSetPixelFormatMsg) != sz_rfbSetPixelFormatMsg)
+	{
+		return false;
+	}
+
+	auto pixelFormat = message.format;
+	pixelFormat.redMax = qFromBigEndian(pixelFormat.redMax);
+	pixelFormat.greenMax = qFromBigEndian(pixelFormat.greenMax);
+	pixelFormat.blueMax = qFromBigEndian(pixelFormat.blueMax);
+
+	if (m_thumbnailFramebuffer)
+	{
+		if (ThumbnailFramebuffer::isSupportedPixelFormat(pixelFormat))
+		{
+			m_thumbnailFramebuffer->setClientPixelFormat(pixelFormat);
+		}
+		else
+		{
+			disableThumbnailFramebuffer();
+		}
+	}
+
+	// updates requested before would still be encoded using the previous pixel format, so hold
+	// back the new pixel format and further requests until the pending update has been received
+	if (m_framebufferUpdateRequestPending)
+	{
+		m_pendingPixelFormat = pixelFormat;
+		return true;
+	}
+
+	// forward through the client protocol so that it decodes further updates properly
+	return m_clientProtocol.setPixelFormat(pixelFormat);
+}
+
+
+
+bool ComputerControlClient::receiveSetEncodingsMessage()
+{
+	auto socket = proxyClientSocket();
+
+	rfbSetEncodingsMsg message;
+	if (socket->peek(reinterpret_cast<char *>(&message), sz_rfbSetEncodingsMsg) != sz_rfbSetEncodingsMsg)
+	{
+		return false;
+	}
+
+	const auto nEncodings = qFromBigEndian(message.nEncodings);
+	const auto messageSize = sz_rfbSetEncodingsMsg + nEncodings * int(sizeof(uint32_t));
+
+	if (nEncodings > MAX_ENCODINGS || socket->bytesAvailable() < messageSize)
+	{
+		// let VncProxyConnection reject invalid messages
+		return VncProxyConnection::receiveClientMessage();
+	}
+
+	const auto messageData = socket->peek(messageSize);
+
+	m_clientEncodings.clear();
+	for (int i = 0; i < nEncodings; ++i)
+	{
+		m_clientEncodings.append(qFromBigEndian<uint32_t>(messageData.constData() + sz_rfbSetEncodingsMsg + i * int(sizeof(uint32_t))));
+	}
+
+	if (m_thumbnailFramebuffer)
+	{
+		// encodings are sent to the server when switching back to the full framebuffer
+		m_thumbnailFramebuffer->setClientEncodings(m_clientEncodings);
+		return socket->read(messageSize).size() == messageSize;
+	}
+
+	if (VncProxyConnection::receiveClientMessage() == false)
+	{
+		return false;
+	}
+
+	// thumbnail size may have been requested before the client announced its encodings
+	if (m_requestedThumbnailSize.isEmpty() == false)
+	{
+		setThumbnailSize(m_requestedThumbnailSize);
+	}
+
+	return true;
+}
+
+
+
+bool ComputerControlClient::receiveThumbnailFramebufferUpdateRequestMessage()
+{
+	auto socket = proxyClientSocket();
+
+	rfbFramebufferUpdateRequestMsg message;
+	if (socket->bytesAvailable() < sz_rfbFramebufferUpdateRequestMsg ||
+		socket->read(reinterpret_cast<char *>(&message), sz_rfbFramebufferUpdateRequestMsg) != sz_rfbFramebufferUpdateRequestMsg)
+	{
+		return false;
+	}
+
+	// requests are answered from the thumbnail which is updated continuously
+	if (message.incremental == 0)
+	{
+		m_thumbnailFramebuffer->invalidate();
+	}
+
+	m_thumbnailFramebufferUpdateRequested = true;
+
+	sendThumbnailFramebufferUpdate();
+
+	return true;
+}
+
+
+
+void ComputerControlClient::disableThumbnailFramebuffer()
+{
+	if (m_thumbnailFramebuffer == nullptr)
+	{
+		return;
+	}
+
+	m_thumbnailFramebuffer.reset();
+	m_thumbnailFramebufferUpdateRequested = false;
+	m_fullFramebufferUpdateRequired = false;
+	m_clientFramebufferSize = {};
+
+	if (m_clientEncodings.isEmpty() == false)
+	{
+		m_clientProtocol.setEncodings(m_clientEncodings);
+	}
+
+	// makes the client request the full framebuffer again
+	proxyClientSocket()->write(ThumbnailFramebuffer::framebufferSizeMessage({m_clientProtocol.framebufferWidth(),
+																			  m_clientProtocol.framebufferHeight()}));
+
+	if (m_continuousFramebufferUpdates == false)
+	{
+		m_continuousFramebufferUpdateTimer.stop();
+	}
+}
+
+
+
+void ComputerControlClient::updateThumbnailFramebuffer()
+{
+	const auto& message = m_clientProtocol.lastMessage();
+
+	for (const auto& rect : m_clientProtocol.lastRects())
+	{
+		const auto& header = rect.header;
+
+		if (header.encoding == rfbEncodingRaw)
+		{
+			m_thumbnailFramebuffer->updateRect(QRect(header.r.x, header.r.y, header.r.w, header.r.h),
+											   message.constData() + rect.dataOffset, rect.dataSize,
+											   m_clientProtocol.pixelFormat());
+		}
+		else if (header.encoding == rfbEncodingNewFBSize || header.encoding == rfbEncodingExtDesktopSize)
+		{
+			const QSize framebufferSize{m_clientProtocol.framebufferWidth(), m_clientProtocol.framebufferHeight()};
+			if (framebufferSize == m_thumbnailFramebuffer->framebufferSize())
+			{
+				continue;
+			}
+
+			if (ThumbnailFramebuffer::thumbnailSize(framebufferSize, m_thumbnailFramebuffer->requestedSize()).isEmpty())
+			{
+				disableThumbnailFramebuffer();
+				return;
+			}
+
+			m_thumbnailFramebuffer->resize(framebufferSize, m_thumbnailFramebuffer->requestedSize());
+			m_fullFramebufferUpdateRequired = true;
+		}
+		else if (int32_t(header.encoding) >= 0)
+		{
+			// rect of an update requested before switching to raw encoding
+			m_fullFramebufferUpdateRequired = true;
+		}
+	}
+
+	sendThumbnailFramebufferUpdate();
+}
+
+
+
+void ComputerControlClient::sendThumbnailFramebufferUpdate()
+{
+	if (m_thumbnailFramebuffer == nullptr || m_thumbnailFramebuffer->isValid() == false)
+	{
+		return;
+	}
+
+	if (m_clientFramebufferSize != m_thumbnailFramebuffer->size())
+	{
+		// the client requests the whole framebuffer after resizing it
+		m_clientFramebufferSize = m_thumbnailFramebuffer->size();
+		m_thumbnailFramebufferUpdateRequested = false;
+		m_thumbnailFramebuffer->invalidate();
+
+		proxyClientSocket()->write(ThumbnailFramebuffer::framebufferSizeMessage(m_clientFramebufferSize));
+		return;
+	}
+
+	if (m_thumbnailFramebufferUpdateRequested && m_thumbnailFramebuffer->hasChanges())
+	{
+		m_thumbnailFramebufferUpdateRequested = false;
+		proxyClientSocket()->write(m_thumbnailFramebuffer->framebufferUpdateMessage());
+	}
+}
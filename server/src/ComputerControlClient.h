@@ -25,13 +25,19 @@
 #pragma once
 
 #include <QElapsedTimer>
+#include <QTimer>
 
+#include <memory>
+#include <optional>
+
+#include "TokenBucket.h"
 #include "VncClientProtocol.h"
 #include "VncProxyConnection.h"
 #include "VncServerClient.h"
 #include "VeyonServerProtocol.h"
 
 class ComputerControlServer;
+class ThumbnailFramebuffer;
 
 class ComputerControlClient : public VncProxyConnection
 {
@@ -54,8 +60,31 @@ public:
 	}
 
 	void setMinimumFramebufferUpdateInterval(int interval);
+	void setContinuousFramebufferUpdates(bool enabled);
+
+	// returns the effective thumbnail size or an empty size if the full framebuffer is served
+	QSize setThumbnailSize(QSize size);
+
+	void setBandwidthLimit(int bytesPerSecond);
+
+	const TokenBucket::Statistics& bandwidthLimitStatistics() const
+	{
+		return m_bandwidthLimit.statistics();
+	}
+
+	int asyncFeatureStateVersion() const
+	{
+		return m_asyncFeatureStateVersion;
+	}
+
+	void setAsyncFeatureStateVersion(int version)
+	{
+		m_asyncFeatureStateVersion = version;
+	}
 
 protected:
+	bool receiveServerMessage() override;
+
 	VncClientProtocol& clientProtocol() override
 	{
 		return m_clientProtocol;
@@ -67,6 +96,22 @@ protected:
 	}
 
 private:
+	// do not request further updates while this amount of data is still waiting to be sent to the client
+	static constexpr qint64 MaximumPendingFramebufferUpdateData = 64 * 1024;
+
+	bool receiveSetPixelFormatMessage();
+	bool receiveSetEncodingsMessage();
+	bool receiveThumbnailFramebufferUpdateRequestMessage();
+
+	void requestContinuousFramebufferUpdate();
+	void forwardDeferredFramebufferUpdateRequest();
+	void applyPendingPixelFormat();
+	void handleClientBytesWritten(qint64 bytes);
+
+	void disableThumbnailFramebuffer();
+	void updateThumbnailFramebuffer();
+	void sendThumbnailFramebufferUpdate();
+
 	ComputerControlServer* m_server;
 
 	VncServerClient m_serverClient{};
@@ -77,4 +122,26 @@ private:
 	int m_minimumFramebufferUpdateInterval{-1};
 	QElapsedTimer m_framebufferUpdateTimer;
 
+	bool m_continuousFramebufferUpdates{false};
+	bool m_framebufferUpdateRequestPending{false};
+	QTimer m_continuousFramebufferUpdateTimer{};
+
+	// pixel format set by the client which is applied once the pending update has been received
+	std::optional<rfbPixelFormat> m_pendingPixelFormat{};
+
+	QVector<uint32_t> m_clientEncodings{};
+
+	QSize m_requestedThumbnailSize{};
+	std::unique_ptr<ThumbnailFramebuffer> m_thumbnailFramebuffer;
+	QSize m_clientFramebufferSize{};
+	bool m_thumbnailFramebufferUpdateRequested{false};
+	bool m_fullFramebufferUpdateRequired{false};
+
+	TokenBucket m_bandwidthLimit;
+	QByteArray m_deferredFramebufferUpdateRequest;
+	QTimer m_deferredFramebufferUpdateRequestTimer{};
+
+	// version of the async feature state sent to the client, initially differs from any server state
+	int m_asyncFeatureStateVersion{-1};
+
 } ;
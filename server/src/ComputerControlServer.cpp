@@ -164,6 +164,57 @@ void ComputerControlServer::setMinimumFramebufferUpdateInterval(const MessageCon
 
 
 
+bool ComputerControlServer::setContinuousFramebufferUpdates(const MessageContext& context, bool enabled)
+{
+	auto client = qobject_cast<ComputerControlClient *>(context.connection());
+	if (client)
+	{
+		client->setContinuousFramebufferUpdates(enabled);
+		return enabled;
+	}
+
+	return false;
+}
+
+
+
+QSize ComputerControlServer::setThumbnailSize(const MessageContext& context, QSize size)
+{
+	auto client = qobject_cast<ComputerControlClient *>(context.connection());
+	if (client)
+	{
+		return client->setThumbnailSize(size);
+	}
+
+	return {};
+}
+
+
+
+void ComputerControlServer::setBandwidthLimit(const MessageContext& context, int bytesPerSecond)
+{
+	auto client = qobject_cast<ComputerControlClient *>(context.connection());
+	if (client)
+	{
+		client->setBandwidthLimit(bytesPerSecond);
+	}
+}
+
+
+
+QByteArray ComputerControlServer::issueAuthenticationTicket(const MessageContext& context)
+{
+	auto client = qobject_cast<ComputerControlClient *>(context.connection());
+	if (client)
+	{
+		return m_serverAuthenticationManager.issueAuthenticationTicket(client->serverClient());
+	}
+
+	return {};
+}
+
+
+
 void ComputerControlServer::checkForIncompleteAuthentication( VncServerClient* client )
 {
 	// connection to client closed during authentication?
@@ -278,9 +329,34 @@ QFutureWatcher<void>* ComputerControlServer::resolveFQDNs( const QStringList& ho
 
 
 
+void ComputerControlServer::notifyAsyncFeatureStateChanged()
+{
+	++m_asyncFeatureStateVersion;
+
+	// connections only receive messages from the VNC server occasionally (e.g. in monitoring mode
+	// with a low update rate) so send the changed state right away instead of waiting for them
+	for (auto connection : m_vncProxyServer.clients())
+	{
+		if (connection->isRunning())
+		{
+			sendAsyncFeatureMessages(connection);
+		}
+	}
+}
+
+
+
 void ComputerControlServer::sendAsyncFeatureMessages(VncProxyConnection* connection)
 {
-	VeyonCore::featureManager().sendAsyncFeatureMessages(*this, MessageContext{connection->proxyClientSocket()});
+	auto client = qobject_cast<ComputerControlClient *>(connection);
+	if (client == nullptr || client->asyncFeatureStateVersion() == m_asyncFeatureStateVersion)
+	{
+		return;
+	}
+
+	client->setAsyncFeatureStateVersion(m_asyncFeatureStateVersion);
+
+	VeyonCore::featureManager().sendAsyncFeatureMessages(*this, MessageContext{connection->proxyClientSocket(), client});
 }
 
 
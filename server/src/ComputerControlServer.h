@@ -76,6 +76,18 @@ public:
 	}
 
 	void setMinimumFramebufferUpdateInterval(const MessageContext& context, int interval) override;
+	bool setContinuousFramebufferUpdates(const MessageContext& context, bool enabled) override;
+	QSize setThumbnailSize(const MessageContext& context, QSize size) override;
+	void setBandwidthLimit(const MessageContext& context, int bytesPerSecond) override;
+
+	QByteArray issueAuthenticationTicket(const MessageContext& context) override;
+
+	int authenticationTicketLifetime() const override
+	{
+		return m_serverAuthenticationManager.authenticationTicketLifetime();
+	}
+
+	void notifyAsyncFeatureStateChanged() override;
 
 private:
 	void checkForIncompleteAuthentication( VncServerClient* client );
@@ -86,6 +98,8 @@ private:
 	void sendAsyncFeatureMessages(VncProxyConnection* connection);
 	void updateTrayIconToolTip();
 
+	int m_asyncFeatureStateVersion{0};
+
 	QMutex m_dataMutex{};
 	QStringList m_allowedIPs{};
 
@@ -26,6 +26,8 @@
 #include "AccessControlProvider.h"
 #include "AuthenticationManager.h"
 #include "DesktopAccessDialog.h"
+#include "PlatformSessionFunctions.h"
+#include "PlatformUserFunctions.h"
 #include "VeyonConfiguration.h"
 
 
@@ -36,6 +38,9 @@ ServerAccessControlManager::ServerAccessControlManager( FeatureWorkerManager& fe
 	m_featureWorkerManager( featureWorkerManager ),
 	m_desktopAccessDialog( desktopAccessDialog )
 {
+	// rules or other access control settings might have changed
+	connect( &VeyonCore::config(), &VeyonConfiguration::configurationChanged,
+			 this, &ServerAccessControlManager::reloadConfiguration );
 }
 
 
@@ -114,11 +119,7 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 		break;
 	}
 
-	AccessControlProvider accessControlProvider;
-	const auto checkResult = accessControlProvider.checkAccess(client->username(),
-															   client->hostAddress(),
-															   connectedUsers(),
-															   client->authMethodUid());
+	const auto checkResult = checkAccess( client );
 
 	switch (checkResult.access)
 	{
@@ -149,6 +150,116 @@ void ServerAccessControlManager::performAccessControl( VncServerClient* client )
 
 
 
+void ServerAccessControlManager::reloadConfiguration()
+{
+	// compile the current rules once for all following decisions
+	m_accessControlProvider = AccessControlProvider();
+
+	m_decisionCache.clear();
+}
+
+
+
+AccessControlProvider::CheckResult ServerAccessControlManager::checkAccess( VncServerClient* client )
+{
+	const auto users = connectedUsers();
+
+	const auto isAccessRestrictedToUserGroups = VeyonCore::config().isAccessRestrictedToUserGroups();
+	const auto isRulesProcessingEnabled = VeyonCore::config().isAccessControlRulesProcessingEnabled();
+
+	// access is granted without any lookups if no access control method is configured
+	if( isAccessRestrictedToUserGroups == false && isRulesProcessingEnabled == false )
+	{
+		return m_accessControlProvider.checkAccess( client->username(), client->hostAddress(),
+													users, client->authMethodUid() );
+	}
+
+	// all inputs of the access control which may differ between connections or change during a
+	// session, everything else is covered by the limited lifetime of the decisions - session state
+	// is only queried if referenced by any rule as it may involve expensive platform queries and
+	// the set of referenced inputs does not change until the cache is cleared with the next
+	// configuration change
+	QStringList key{ client->username(),
+					 client->hostAddress(),
+					 client->authMethodUid().toString() };
+
+	if( isAccessRestrictedToUserGroups == false )
+	{
+		using Condition = AccessControlRule::Condition;
+
+		const auto& provider = m_accessControlProvider;
+		auto& userFunctions = VeyonCore::platform().userFunctions();
+		const auto& sessionFunctions = VeyonCore::platform().sessionFunctions();
+
+		if( provider.isConditionUsed( Condition::AccessFromSameUser ) ||
+			provider.isConditionUsed( Condition::GroupsInCommon ) ||
+			provider.isConditionUsed( Condition::MemberOfGroup, AccessControlRule::Subject::LocalUser ) )
+		{
+			key.append( userFunctions.currentUser() );
+		}
+		if( provider.isConditionUsed( Condition::UserSession ) )
+		{
+			key.append( QString::number( sessionFunctions.currentSessionHasUser() ) );
+		}
+		if( provider.isConditionUsed( Condition::AccessedUserLoggedInLocally ) )
+		{
+			key.append( QString::number( sessionFunctions.currentSessionIsRemote() ) );
+		}
+		if( provider.isConditionUsed( Condition::NoUserLoggedInLocally ) )
+		{
+			key.append( QString::number( userFunctions.isAnyUserLoggedInLocally() ) );
+		}
+		if( provider.isConditionUsed( Condition::NoUserLoggedInRemotely ) )
+		{
+			key.append( QString::number( userFunctions.isAnyUserLoggedInRemotely() ) );
+		}
+		if( provider.isConditionUsed( Condition::AccessFromAlreadyConnectedUser ) ||
+			provider.isConditionUsed( Condition::ComputerAlreadyBeingAccessed ) )
+		{
+			auto sortedUsers = users;
+			sortedUsers.sort();
+			key.append( sortedUsers.join( QLatin1Char(',') ) );
+		}
+	}
+
+	const auto cacheKey = key.join( QLatin1Char('\n') );
+
+	const auto it = m_decisionCache.constFind( cacheKey );
+	if( it != m_decisionCache.constEnd() && it->expiry.hasExpired() == false )
+	{
+		++m_decisionCacheHits;
+		vDebug() << "using cached decision for" << client->username() << client->hostAddress()
+				 << "- hits:" << m_decisionCacheHits << "misses:" << m_decisionCacheMisses;
+		return it->result;
+	}
+
+	++m_decisionCacheMisses;
+
+	const auto checkResult = m_accessControlProvider.checkAccess( client->username(),
+																  client->hostAddress(),
+																  users,
+																  client->authMethodUid() );
+
+	if( m_decisionCache.size() >= MaximumDecisionCacheSize )
+	{
+		for( auto entry = m_decisionCache.begin(); entry != m_decisionCache.end(); )
+		{
+			entry = entry->expiry.hasExpired() ? m_decisionCache.erase( entry ) : std::next( entry );
+		}
+
+		if( m_decisionCache.size() >= MaximumDecisionCacheSize )
+		{
+			m_decisionCache.clear();
+		}
+	}
+
+	m_decisionCache[cacheKey] = { checkResult, QDeadlineTimer( DecisionCacheLifetime ) };
+
+	return checkResult;
+}
+
+
+
 VncServerClient::AccessControlState ServerAccessControlManager::confirmDesktopAccess( VncServerClient* client )
 {
 	const HostUserPair hostUserPair( client->username(), client->hostAddress() );
@@ -24,6 +24,10 @@
 
 #pragma once
 
+#include <QDeadlineTimer>
+#include <QHash>
+
+#include "AccessControlProvider.h"
 #include "DesktopAccessDialog.h"
 #include "VncServerClient.h"
 
@@ -40,14 +44,24 @@ public:
 	void addClient( VncServerClient* client );
 	void removeClient( VncServerClient* client );
 
-
 Q_SIGNALS:
 	void finished( VncServerClient* client );
 
 private:
 	static constexpr int ClientWaitInterval = 1000;
+	static constexpr int DecisionCacheLifetime = 30000;
+	static constexpr int MaximumDecisionCacheSize = 256;
+
+	struct CachedDecision
+	{
+		AccessControlProvider::CheckResult result;
+		QDeadlineTimer expiry;
+	};
+
+	void reloadConfiguration();
 
 	void performAccessControl( VncServerClient* client );
+	AccessControlProvider::CheckResult checkAccess( VncServerClient* client );
 	VncServerClient::AccessControlState confirmDesktopAccess( VncServerClient* client );
 	void finishDesktopAccessConfirmation( VncServerClient* client );
 
@@ -63,4 +77,10 @@ private:
 
 	DesktopAccessChoiceMap m_desktopAccessChoices{};
 
+	AccessControlProvider m_accessControlProvider{};
+
+	QHash<QString, CachedDecision> m_decisionCache{};
+	quint64 m_decisionCacheHits{0};
+	quint64 m_decisionCacheMisses{0};
+
 } ;
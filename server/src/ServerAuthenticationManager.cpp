@@ -22,14 +22,27 @@
  *
  */
 
+#include <QBuffer>
+#include <QtConcurrent>
+
 #include "AuthenticationManager.h"
 #include "ServerAuthenticationManager.h"
+#include "VariantArrayMessage.h"
 #include "VeyonConfiguration.h"
 
 
 ServerAuthenticationManager::ServerAuthenticationManager( QObject* parent ) :
-	QObject( parent )
+	QObject( parent ),
+	m_authenticationTicketLifetime( VeyonCore::config().authenticationTicketLifetime() )
 {
+	m_threadPool.setMaxThreadCount( qBound( 1, QThread::idealThreadCount(), MaximumWorkerThreadCount ) );
+}
+
+
+
+ServerAuthenticationManager::~ServerAuthenticationManager()
+{
+	m_threadPool.waitForDone();
 }
 
 
@@ -42,18 +55,157 @@ void ServerAuthenticationManager::processAuthenticationMessage( VncServerClient*
 			 << "host" << client->hostAddress()
 			 << "user" << client->username();
 
-	auto authPlugin = VeyonCore::authenticationManager().plugins().value( client->authMethodUid() );
+	// frame the received message again so that it can be received from a buffer in the worker thread
+	QByteArray messageData;
+	if( message.data().isEmpty() == false )
+	{
+		const auto messageSize = qToBigEndian<VariantArrayMessage::MessageSize>(
+									 static_cast<VariantArrayMessage::MessageSize>( message.data().size() ) );
+		messageData = QByteArray( reinterpret_cast<const char *>( &messageSize ), sizeof(messageSize) ) + message.data();
+	}
 
-	if( authPlugin &&
-		VeyonCore::authenticationManager().isEnabled( client->authMethodUid() ) )
+	const AuthenticationStep step{
+		client,
+		message.ioDevice(),
+		messageData,
+		{},
+		client->authState(),
+		client->authMethodUid(),
+		client->isAuthenticatedByTicket(),
+		client->username(),
+		client->hostAddress(),
+		client->challenge(),
+		client->privateKey()
+	};
+
+	client->setAuthState( VncServerClient::AuthState::Pending );
+
+	auto watcher = new QFutureWatcher<AuthenticationStep>( this );
+	connect( watcher, &QFutureWatcher<AuthenticationStep>::finished, this, [this, watcher]() {
+		finishAuthenticationStep( watcher->result() );
+		watcher->deleteLater();
+	} );
+	watcher->setFuture( QtConcurrent::run( &m_threadPool, [this, step]() { return performAuthenticationStep( step ); } ) );
+}
+
+
+
+QByteArray ServerAuthenticationManager::issueAuthenticationTicket( const VncServerClient* client )
+{
+	if( m_authenticationTicketLifetime <= 0 ||
+		client->authState() != VncServerClient::AuthState::Successful ||
+		client->isAuthenticatedByTicket() )
 	{
-		client->setAuthState( authPlugin->performAuthentication( client, message ) );
+		return {};
+	}
+
+	const auto ticket = CryptoCore::generateChallenge().left( TicketSize );
+	if( ticket.size() != TicketSize )
+	{
+		return {};
+	}
+
+	QMutexLocker locker( &m_authenticationTicketsMutex );
+
+	removeExpiredAuthenticationTickets();
+
+	// only keep the most recent ticket issued to a connection
+	for( auto it = m_authenticationTickets.begin(); it != m_authenticationTickets.end(); )
+	{
+		if( it->issuer == client )
+		{
+			it = m_authenticationTickets.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if( m_authenticationTickets.size() >= MaximumTicketCount )
+	{
+		vWarning() << "too many outstanding authentication tickets";
+		return {};
+	}
+
+	m_authenticationTickets[ticket] = {
+		client,
+		client->hostAddress(),
+		client->username(),
+		client->authMethodUid(),
+		QDeadlineTimer( qint64(m_authenticationTicketLifetime) * 1000 )
+	};
+
+	return ticket;
+}
+
+
+
+ServerAuthenticationManager::AuthenticationStep ServerAuthenticationManager::performAuthenticationStep( AuthenticationStep step )
+{
+	VncServerClient client;
+	client.setAuthState( step.authState );
+	client.setAuthMethodUid( step.authMethodUid );
+	client.setAuthenticatedByTicket( step.authenticatedByTicket );
+	client.setUsername( step.username );
+	client.setHostAddress( step.hostAddress );
+	client.setChallenge( step.challenge );
+	client.setPrivateKey( step.privateKey );
+
+	const auto messageSize = step.message.size();
+
+	// replies get appended to the received message in the buffer
+	QBuffer buffer( &step.message );
+	buffer.open( QBuffer::ReadWrite );
+
+	VariantArrayMessage message( &buffer );
+	if( messageSize > 0 && message.receive() == false )
+	{
+		client.setAuthState( VncServerClient::AuthState::Failed );
 	}
 	else
 	{
-		client->setAuthState( VncServerClient::AuthState::Failed );
+		performAuthentication( &client, message );
+	}
+
+	buffer.close();
+
+	step.reply = step.message.mid( messageSize );
+	step.authState = client.authState();
+	step.authMethodUid = client.authMethodUid();
+	step.authenticatedByTicket = client.isAuthenticatedByTicket();
+	step.username = client.username();
+	step.challenge = client.challenge();
+	step.privateKey = client.privateKey();
+
+	return step;
+}
+
+
+
+void ServerAuthenticationManager::finishAuthenticationStep( const AuthenticationStep& step )
+{
+	// connection closed in the meantime?
+	if( step.client.isNull() || step.socket.isNull() || step.socket->isOpen() == false ||
+		step.client->authState() != VncServerClient::AuthState::Pending )
+	{
+		return;
+	}
+
+	auto client = step.client.data();
+
+	if( step.reply.isEmpty() == false )
+	{
+		step.socket->write( step.reply );
 	}
 
+	client->setAuthMethodUid( step.authMethodUid );
+	client->setAuthenticatedByTicket( step.authenticatedByTicket );
+	client->setUsername( step.username );
+	client->setChallenge( step.challenge );
+	client->setPrivateKey( step.privateKey );
+	client->setAuthState( step.authState );
+
 	switch( client->authState() )
 	{
 	case VncServerClient::AuthState::Failed:
@@ -63,4 +215,107 @@ void ServerAuthenticationManager::processAuthenticationMessage( VncServerClient*
 	default:
 		break;
 	}
+
+	client->finishAuthentication();
+}
+
+
+
+void ServerAuthenticationManager::performAuthentication( VncServerClient* client, VariantArrayMessage& message )
+{
+	auto authPlugin = VeyonCore::authenticationManager().plugins().value( client->authMethodUid() );
+
+	if( client->authMethodUid() == AuthenticationManager::ticketAuthMethodUid() &&
+		m_authenticationTicketLifetime > 0 )
+	{
+		client->setAuthState( performTicketAuthentication( client, message ) );
+	}
+	else if( authPlugin &&
+		VeyonCore::authenticationManager().isEnabled( client->authMethodUid() ) )
+	{
+		client->setAuthState( authPlugin->performAuthentication( client, message ) );
+	}
+	else
+	{
+		client->setAuthState( VncServerClient::AuthState::Failed );
+	}
+}
+
+
+
+VncServerClient::AuthState ServerAuthenticationManager::performTicketAuthentication( VncServerClient* client,
+																					 VariantArrayMessage& message )
+{
+	if( client->authState() == VncServerClient::AuthState::Init )
+	{
+		// wait for the ticket sent by the client
+		return VncServerClient::AuthState::Stage1;
+	}
+
+	const auto ticketData = message.read().toByteArray(); // Flawfinder: ignore
+	const auto fallbackAuthMethodUid = message.read().toUuid(); // Flawfinder: ignore
+
+	AuthenticationTicket ticket{};
+
+	m_authenticationTicketsMutex.lock();
+	removeExpiredAuthenticationTickets();
+	const auto valid = ticketData.size() == TicketSize && m_authenticationTickets.contains( ticketData );
+	if( valid )
+	{
+		// tickets can be used only once
+		ticket = m_authenticationTickets.take( ticketData );
+	}
+	m_authenticationTicketsMutex.unlock();
+
+	// tickets are bound to the host they have been issued to
+	const auto accepted = valid && ticket.hostAddress == client->hostAddress();
+
+	if( VariantArrayMessage( message.ioDevice() ).write( accepted ).send() == false )
+	{
+		vWarning() << "failed to send ticket authentication reply";
+		return VncServerClient::AuthState::Failed;
+	}
+
+	if( accepted )
+	{
+		vDebug() << "SUCCESS";
+
+		// continue as if the client authenticated via the original method so that
+		// access control is performed exactly the same way
+		client->setAuthMethodUid( ticket.authMethodUid );
+		client->setAuthenticatedByTicket( true );
+		client->setUsername( ticket.username );
+		return VncServerClient::AuthState::Successful;
+	}
+
+	vDebug() << "ticket rejected, falling back to" << fallbackAuthMethodUid;
+
+	const auto fallbackAuthPlugin = VeyonCore::authenticationManager().plugins().value( fallbackAuthMethodUid );
+	if( fallbackAuthPlugin == nullptr ||
+		VeyonCore::authenticationManager().isEnabled( fallbackAuthMethodUid ) == false )
+	{
+		return VncServerClient::AuthState::Failed;
+	}
+
+	client->setAuthMethodUid( fallbackAuthMethodUid );
+	client->setAuthState( VncServerClient::AuthState::Init );
+
+	return fallbackAuthPlugin->performAuthentication( client, message );
+}
+
+
+
+void ServerAuthenticationManager::removeExpiredAuthenticationTickets()
+{
+	for( auto it = m_authenticationTickets.begin(); it != m_authenticationTickets.end(); )
+	{
+		if( it->expiry.hasExpired() )
+		{
+			it = m_authenticationTickets.erase( it );
+		}
+		else
+		{
+			++it;
+		}
+	}
 }
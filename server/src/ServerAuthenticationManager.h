@@ -24,8 +24,11 @@
 
 #pragma once
 
+#include <QDeadlineTimer>
 #include <QMutex>
+#include <QPointer>
 #include <QStringList>
+#include <QThreadPool>
 
 #include "VncServerClient.h"
 
@@ -42,10 +45,69 @@ public:
 	Q_ENUM(AuthResult)
 
 	explicit ServerAuthenticationManager( QObject* parent );
+	~ServerAuthenticationManager() override;
 
+	// processes the message asynchronously in a worker thread so that slow authentication
+	// methods (e.g. PAM or LDAP) and key generation do not block other connections
 	void processAuthenticationMessage( VncServerClient* client,
 									   VariantArrayMessage& message );
 
+	int authenticationTicketLifetime() const
+	{
+		return m_authenticationTicketLifetime;
+	}
+
+	// issues a single-use ticket which allows the successfully authenticated client to skip
+	// the full authentication when reconnecting from the same host within the ticket lifetime -
+	// clients which have been authenticated by a ticket themselves do not get a new one so
+	// that a full authentication is required at least every other connection
+	QByteArray issueAuthenticationTicket( const VncServerClient* client );
+
+private:
+	static constexpr int TicketSize = 32;
+	static constexpr int MaximumTicketCount = 4096;
+	static constexpr int MaximumWorkerThreadCount = 4;
+
+	// the data of a client an authentication step may read or modify - worker threads
+	// operate on a copy of it so that they never access the client object itself
+	struct AuthenticationStep
+	{
+		QPointer<VncServerClient> client;
+		QPointer<QIODevice> socket;
+		QByteArray message;
+		QByteArray reply;
+		VncServerClient::AuthState authState{VncServerClient::AuthState::Init};
+		Plugin::Uid authMethodUid;
+		bool authenticatedByTicket;
+		QString username;
+		QString hostAddress;
+		QByteArray challenge;
+		CryptoCore::PrivateKey privateKey;
+	};
+
+	struct AuthenticationTicket
+	{
+		QPointer<const VncServerClient> issuer;
+		QString hostAddress;
+		QString username;
+		Plugin::Uid authMethodUid;
+		QDeadlineTimer expiry;
+	};
+
+	AuthenticationStep performAuthenticationStep( AuthenticationStep step );
+	void finishAuthenticationStep( const AuthenticationStep& step );
+
+	void performAuthentication( VncServerClient* client, VariantArrayMessage& message );
+	VncServerClient::AuthState performTicketAuthentication( VncServerClient* client, VariantArrayMessage& message );
+	void removeExpiredAuthenticationTickets();
+
+	const int m_authenticationTicketLifetime;
+
+	QMutex m_authenticationTicketsMutex;
+	QHash<QByteArray, AuthenticationTicket> m_authenticationTickets;
+
+	QThreadPool m_threadPool{};
+
 
 Q_SIGNALS:
 	void finished( VncServerClient* client );
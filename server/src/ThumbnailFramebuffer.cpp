@@ -0,0 +1,486 @@
+/*
+ * ThumbnailFramebuffer.cpp - implementation of ThumbnailFramebuffer class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QBuffer>
+#include <QtEndian>
+
+#include "FramebufferScaler.h"
+#include "ThumbnailFramebuffer.h"
+
+
+// JPEG qualities for the Tight quality levels 0-9 as used by libvncserver
+static constexpr int JpegQualities[] = { 15, 29, 41, 42, 62, 77, 79, 86, 92, 100 };
+
+
+ThumbnailFramebuffer::ThumbnailFramebuffer( QSize framebufferSize, QSize requestedSize )
+{
+	resize( framebufferSize, requestedSize );
+}
+
+
+
+ThumbnailFramebuffer::~ThumbnailFramebuffer()
+{
+	if( m_zlibStreamInitialized )
+	{
+		deflateEnd( &m_zlibStream );
+	}
+}
+
+
+
+bool ThumbnailFramebuffer::isSupportedPixelFormat( const rfbPixelFormat& pixelFormat )
+{
+	return pixelFormat.trueColour &&
+		   pixelFormat.bitsPerPixel == 32 &&
+		   pixelFormat.depth == 24 &&
+		   pixelFormat.redMax == 255 &&
+		   pixelFormat.greenMax == 255 &&
+		   pixelFormat.blueMax == 255 &&
+		   pixelFormat.redShift % 8 == 0 && pixelFormat.redShift < 32 &&
+		   pixelFormat.greenShift % 8 == 0 && pixelFormat.greenShift < 32 &&
+		   pixelFormat.blueShift % 8 == 0 && pixelFormat.blueShift < 32;
+}
+
+
+
+QSize ThumbnailFramebuffer::thumbnailSize( QSize framebufferSize, QSize requestedSize )
+{
+	if( framebufferSize.isEmpty() || requestedSize.isEmpty() )
+	{
+		return {};
+	}
+
+	const auto size = framebufferSize.scaled( requestedSize, Qt::KeepAspectRatio ).expandedTo( { 1, 1 } );
+
+	if( size.width() >= framebufferSize.width() ||
+		size.height() >= framebufferSize.height() ||
+		FramebufferScaler::canScale( QImage( framebufferSize, QImage::Format_RGB32 ), size ) == false )
+	{
+		return {};
+	}
+
+	return size;
+}
+
+
+
+QByteArray ThumbnailFramebuffer::framebufferSizeMessage( QSize size )
+{
+	rfbFramebufferUpdateMsg message{};
+	message.type = rfbFramebufferUpdate;
+	message.nRects = qToBigEndian<uint16_t>( 1 );
+
+	rfbFramebufferUpdateRectHeader rectHeader{};
+	rectHeader.r.w = qToBigEndian<uint16_t>( uint16_t(size.width()) );
+	rectHeader.r.h = qToBigEndian<uint16_t>( uint16_t(size.height()) );
+	rectHeader.encoding = qToBigEndian<uint32_t>( rfbEncodingNewFBSize );
+
+	return QByteArray( reinterpret_cast<const char *>( &message ), sz_rfbFramebufferUpdateMsg ) +
+		   QByteArray( reinterpret_cast<const char *>( &rectHeader ), sz_rfbFramebufferUpdateRectHeader );
+}
+
+
+
+void ThumbnailFramebuffer::setClientPixelFormat( const rfbPixelFormat& pixelFormat )
+{
+	m_clientPixelFormat = pixelFormat;
+}
+
+
+
+void ThumbnailFramebuffer::setClientEncodings( const QVector<uint32_t>& encodings )
+{
+	m_tightEncoding = false;
+	m_jpegQuality = -1;
+
+	for( auto encoding : encodings )
+	{
+		if( encoding == rfbEncodingTight )
+		{
+			m_tightEncoding = true;
+		}
+		else if( encoding >= rfbEncodingQualityLevel0 && encoding <= rfbEncodingQualityLevel9 )
+		{
+			m_jpegQuality = JpegQualities[encoding - rfbEncodingQualityLevel0];
+		}
+		else if( encoding >= rfbEncodingCompressLevel0 && encoding <= rfbEncodingCompressLevel9 &&
+				 m_zlibStreamInitialized == false )
+		{
+			// changing the level of an active stream would emit data outside of any rect
+			m_compressLevel = int( encoding - rfbEncodingCompressLevel0 );
+		}
+	}
+}
+
+
+
+void ThumbnailFramebuffer::resize( QSize framebufferSize, QSize requestedSize )
+{
+	m_requestedSize = requestedSize;
+
+	m_framebuffer = QImage( framebufferSize, QImage::Format_RGB32 );
+	m_framebuffer.fill( Qt::black );
+
+	m_thumbnail = QImage( thumbnailSize( framebufferSize, requestedSize ), QImage::Format_RGB32 );
+	m_thumbnail.fill( Qt::black );
+
+	m_valid = false;
+	m_receivedRegion = {};
+	m_damagedRegion = m_thumbnail.rect();
+}
+
+
+
+void ThumbnailFramebuffer::updateRect( const QRect& rect, const char* data, int size, const rfbPixelFormat& pixelFormat )
+{
+	if( m_framebuffer.rect().contains( rect ) == false ||
+		rect.isEmpty() ||
+		size < rect.width() * rect.height() * 4 ||
+		isSupportedPixelFormat( pixelFormat ) == false )
+	{
+		return;
+	}
+
+	const auto redShift = pixelFormat.redShift;
+	const auto greenShift = pixelFormat.greenShift;
+	const auto blueShift = pixelFormat.blueShift;
+	const auto bigEndian = pixelFormat.bigEndian != 0;
+
+	auto source = reinterpret_cast<const uchar *>( data );
+
+	for( int y = rect.y(); y <= rect.bottom(); ++y )
+	{
+		auto target = reinterpret_cast<QRgb *>( m_framebuffer.scanLine( y ) ) + rect.x();
+
+		for( int x = 0; x < rect.width(); ++x )
+		{
+			const auto pixel = bigEndian ? qFromBigEndian<quint32>( source ) : qFromLittleEndian<quint32>( source );
+			target[x] = qRgb( ( pixel >> redShift ) & 0xff, ( pixel >> greenShift ) & 0xff, ( pixel >> blueShift ) & 0xff );
+			source += 4;
+		}
+	}
+
+	if( m_valid == false )
+	{
+		m_receivedRegion += rect;
+		if( ( QRegion( m_framebuffer.rect() ) - m_receivedRegion ).isEmpty() )
+		{
+			m_valid = true;
+			m_receivedRegion = {};
+		}
+	}
+
+	m_damagedRegion += scaledRect( rect );
+}
+
+
+
+void ThumbnailFramebuffer::invalidate()
+{
+	m_damagedRegion = m_thumbnail.rect();
+}
+
+
+
+QByteArray ThumbnailFramebuffer::framebufferUpdateMessage()
+{
+	auto region = m_damagedRegion & m_thumbnail.rect();
+	m_damagedRegion = {};
+
+	if( region.rectCount() > MaximumUpdateRects )
+	{
+		region = region.boundingRect();
+	}
+
+	QByteArray rects;
+	int rectCount = 0;
+
+	for( const auto& rect : region )
+	{
+		FramebufferScaler::scaleRect( m_framebuffer, m_thumbnail, rect );
+
+		if( m_tightEncoding )
+		{
+			const auto maximumRows = qMax( 1, TightMaximumDataSize / ( qMin( rect.width(), TightMaximumRectWidth ) * 3 ) );
+
+			for( int y = rect.y(); y <= rect.bottom(); y += maximumRows )
+			{
+				for( int x = rect.x(); x <= rect.right(); x += TightMaximumRectWidth )
+				{
+					appendTightRect( rects, QRect( x, y,
+												   qMin( TightMaximumRectWidth, rect.right() + 1 - x ),
+												   qMin( maximumRows, rect.bottom() + 1 - y ) ) );
+					++rectCount;
+				}
+			}
+		}
+		else
+		{
+			appendRawRect( rects, rect );
+			++rectCount;
+		}
+	}
+
+	rfbFramebufferUpdateMsg message{};
+	message.type = rfbFramebufferUpdate;
+	message.nRects = qToBigEndian<uint16_t>( uint16_t(rectCount) );
+
+	return QByteArray( reinterpret_cast<const char *>( &message ), sz_rfbFramebufferUpdateMsg ) + rects;
+}
+
+
+
+void ThumbnailFramebuffer::appendRect( QByteArray& message, const QRect& rect, uint32_t encoding ) const
+{
+	rfbFramebufferUpdateRectHeader rectHeader{};
+	rectHeader.r.x = qToBigEndian<uint16_t>( uint16_t(rect.x()) );
+	rectHeader.r.y = qToBigEndian<uint16_t>( uint16_t(rect.y()) );
+	rectHeader.r.w = qToBigEndian<uint16_t>( uint16_t(rect.width()) );
+	rectHeader.r.h = qToBigEndian<uint16_t>( uint16_t(rect.height()) );
+	rectHeader.encoding = qToBigEndian<uint32_t>( encoding );
+
+	message.append( reinterpret_cast<const char *>( &rectHeader ), sz_rfbFramebufferUpdateRectHeader );
+}
+
+
+
+void ThumbnailFramebuffer::appendRawRect( QByteArray& message, const QRect& rect ) const
+{
+	appendRect( message, rect, rfbEncodingRaw );
+
+	const auto offset = message.size();
+	message.resize( offset + rect.width() * rect.height() * 4 );
+
+	const auto bigEndian = m_clientPixelFormat.bigEndian != 0;
+	auto target = reinterpret_cast<uchar *>( message.data() + offset );
+
+	for( int y = rect.y(); y <= rect.bottom(); ++y )
+	{
+		const auto source = reinterpret_cast<const QRgb *>( m_thumbnail.constScanLine( y ) ) + rect.x();
+
+		for( int x = 0; x < rect.width(); ++x )
+		{
+			const auto pixel = quint32( ( uint(qRed(source[x])) << m_clientPixelFormat.redShift ) |
+										( uint(qGreen(source[x])) << m_clientPixelFormat.greenShift ) |
+										( uint(qBlue(source[x])) << m_clientPixelFormat.blueShift ) );
+			if( bigEndian )
+			{
+				qToBigEndian<quint32>( pixel, target );
+			}
+			else
+			{
+				qToLittleEndian<quint32>( pixel, target );
+			}
+			target += 4;
+		}
+	}
+}
+
+
+
+void ThumbnailFramebuffer::appendTightRect( QByteArray& message, const QRect& rect )
+{
+	if( appendTightFillRect( message, rect ) ||
+		( m_jpegQuality >= 0 && rect.width() * rect.height() >= MinimumJpegRectArea &&
+		  appendTightJpegRect( message, rect ) ) )
+	{
+		return;
+	}
+
+	appendTightBasicRect( message, rect );
+}
+
+
+
+bool ThumbnailFramebuffer::appendTightFillRect( QByteArray& message, const QRect& rect ) const
+{
+	const auto color = m_thumbnail.pixel( rect.topLeft() ) & RGB_MASK;
+
+	for( int y = rect.y(); y <= rect.bottom(); ++y )
+	{
+		const auto source = reinterpret_cast<const QRgb *>( m_thumbnail.constScanLine( y ) ) + rect.x();
+
+		for( int x = 0; x < rect.width(); ++x )
+		{
+			if( ( source[x] & RGB_MASK ) != color )
+			{
+				return false;
+			}
+		}
+	}
+
+	appendRect( message, rect, rfbEncodingTight );
+
+	message.append( char(rfbTightFill << 4) );
+	message.append( char(qRed(color)) );
+	message.append( char(qGreen(color)) );
+	message.append( char(qBlue(color)) );
+
+	return true;
+}
+
+
+
+bool ThumbnailFramebuffer::appendTightJpegRect( QByteArray& message, const QRect& rect ) const
+{
+	QByteArray jpegData;
+	QBuffer buffer( &jpegData );
+	buffer.open( QBuffer::WriteOnly ); // Flawfinder: ignore
+
+	// fails if the JPEG image format plugin is not available
+	if( m_thumbnail.copy( rect ).save( &buffer, "JPEG", m_jpegQuality ) == false ||
+		jpegData.isEmpty() )
+	{
+		return false;
+	}
+
+	appendRect( message, rect, rfbEncodingTight );
+
+	message.append( char(rfbTightJpeg << 4) );
+	appendCompactLength( message, jpegData.size() );
+	message.append( jpegData );
+
+	return true;
+}
+
+
+
+void ThumbnailFramebuffer::appendTightBasicRect( QByteArray& message, const QRect& rect )
+{
+	// basic compression with copy filter, i.e. plain RGB triplets
+	QByteArray pixels( rect.width() * rect.height() * 3, Qt::Uninitialized );
+	auto target = pixels.data();
+
+	for( int y = rect.y(); y <= rect.bottom(); ++y )
+	{
+		const auto source = reinterpret_cast<const QRgb *>( m_thumbnail.constScanLine( y ) ) + rect.x();
+
+		for( int x = 0; x < rect.width(); ++x )
+		{
+			*target++ = char(qRed(source[x]));
+			*target++ = char(qGreen(source[x]));
+			*target++ = char(qBlue(source[x]));
+		}
+	}
+
+	if( pixels.size() < TightMinimumDataSizeToCompress )
+	{
+		appendRect( message, rect, rfbEncodingTight );
+		message.append( char(TightZlibStream << 4) );
+		message.append( pixels );
+		return;
+	}
+
+	const auto resetStream = m_zlibStreamReset;
+
+	if( m_zlibStreamInitialized == false )
+	{
+		if( deflateInit2( &m_zlibStream, m_compressLevel, Z_DEFLATED, MAX_WBITS, MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY ) != Z_OK )
+		{
+			appendRawRect( message, rect );
+			return;
+		}
+		m_zlibStreamInitialized = true;
+	}
+	else if( resetStream )
+	{
+		deflateReset( &m_zlibStream );
+	}
+
+	m_zlibStream.next_in = reinterpret_cast<Bytef *>( pixels.data() );
+	m_zlibStream.avail_in = uInt(pixels.size());
+
+	const auto chunkSize = int( deflateBound( &m_zlibStream, uLong(pixels.size()) ) ) + 16;
+
+	QByteArray compressedData;
+	int status = Z_OK;
+
+	do
+	{
+		const auto offset = compressedData.size();
+		compressedData.resize( offset + chunkSize );
+
+		m_zlibStream.next_out = reinterpret_cast<Bytef *>( compressedData.data() + offset );
+		m_zlibStream.avail_out = uInt(chunkSize);
+
+		status = deflate( &m_zlibStream, Z_SYNC_FLUSH );
+
+		compressedData.resize( compressedData.size() - int(m_zlibStream.avail_out) );
+	} while( status == Z_OK && m_zlibStream.avail_out == 0 );
+
+	if( ( status != Z_OK && status != Z_BUF_ERROR ) || m_zlibStream.avail_in > 0 )
+	{
+		// stream state is unknown now so start over with the next rect
+		m_zlibStreamReset = true;
+		appendRawRect( message, rect );
+		return;
+	}
+
+	m_zlibStreamReset = false;
+
+	appendRect( message, rect, rfbEncodingTight );
+
+	message.append( char( ( TightZlibStream << 4 ) | ( resetStream ? ( 1 << TightZlibStream ) : 0 ) ) );
+	appendCompactLength( message, compressedData.size() );
+	message.append( compressedData );
+}
+
+
+
+void ThumbnailFramebuffer::appendCompactLength( QByteArray& data, int length )
+{
+	data.append( char( ( length & 0x7f ) | ( length > 0x7f ? 0x80 : 0 ) ) );
+	if( length > 0x7f )
+	{
+		data.append( char( ( ( length >> 7 ) & 0x7f ) | ( length > 0x3fff ? 0x80 : 0 ) ) );
+		if( length > 0x3fff )
+		{
+			data.append( char( ( length >> 14 ) & 0xff ) );
+		}
+	}
+}
+
+
+
+QRect ThumbnailFramebuffer::scaledRect( const QRect& rect ) const
+{
+	const auto sourceWidth = qint64(m_framebuffer.width());
+	const auto sourceHeight = qint64(m_framebuffer.height());
+	const auto targetWidth = qint64(m_thumbnail.width());
+	const auto targetHeight = qint64(m_thumbnail.height());
+
+	if( sourceWidth <= 0 || sourceHeight <= 0 )
+	{
+		return {};
+	}
+
+	// all thumbnail pixels whose source area intersects with rect
+	const auto left = int( rect.x() * targetWidth / sourceWidth );
+	const auto top = int( rect.y() * targetHeight / sourceHeight );
+	const auto right = int( ( ( rect.x() + rect.width() ) * targetWidth + sourceWidth - 1 ) / sourceWidth );
+	const auto bottom = int( ( ( rect.y() + rect.height() ) * targetHeight + sourceHeight - 1 ) / sourceHeight );
+
+	return QRect( left, top, right - left, bottom - top ) & m_thumbnail.rect();
+}
@@ -0,0 +1,128 @@
+/*
+ * ThumbnailFramebuffer.h - declaration of ThumbnailFramebuffer class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include "rfb/rfbproto.h"
+
+#include <zlib.h>
+
+#include <QImage>
+#include <QRegion>
+#include <QVector>
+
+// full size copy of a VNC server's framebuffer which is served to a VNC client
+// as a downscaled virtual framebuffer (thumbnail)
+class ThumbnailFramebuffer
+{
+public:
+	ThumbnailFramebuffer( QSize framebufferSize, QSize requestedSize );
+	~ThumbnailFramebuffer();
+
+	Q_DISABLE_COPY(ThumbnailFramebuffer)
+
+	// 32 bit true color formats with 8 bit per channel
+	static bool isSupportedPixelFormat( const rfbPixelFormat& pixelFormat );
+
+	// returns an empty size if the framebuffer can't be downscaled to the requested size
+	static QSize thumbnailSize( QSize framebufferSize, QSize requestedSize );
+
+	static QByteArray framebufferSizeMessage( QSize size );
+
+	QSize size() const
+	{
+		return m_thumbnail.size();
+	}
+
+	QSize framebufferSize() const
+	{
+		return m_framebuffer.size();
+	}
+
+	QSize requestedSize() const
+	{
+		return m_requestedSize;
+	}
+
+	// thumbnail is valid as soon as the whole framebuffer has been received once
+	bool isValid() const
+	{
+		return m_valid;
+	}
+
+	bool hasChanges() const
+	{
+		return m_damagedRegion.isEmpty() == false;
+	}
+
+	void setClientPixelFormat( const rfbPixelFormat& pixelFormat );
+	void setClientEncodings( const QVector<uint32_t>& encodings );
+
+	void resize( QSize framebufferSize, QSize requestedSize );
+
+	void updateRect( const QRect& rect, const char* data, int size, const rfbPixelFormat& pixelFormat );
+	void invalidate();
+
+	QByteArray framebufferUpdateMessage();
+
+private:
+	static constexpr int MaximumUpdateRects = 32;
+	static constexpr int MinimumJpegRectArea = 64*64;
+	static constexpr int TightMaximumRectWidth = 2048;
+	static constexpr int TightMaximumDataSize = 64*1024;
+	static constexpr int TightMinimumDataSizeToCompress = 12;
+	// libvncserver and other common Tight encoders only use the zlib streams 0-2
+	static constexpr int TightZlibStream = 3;
+	static constexpr int DefaultCompressLevel = 6;
+
+	void appendRect( QByteArray& message, const QRect& rect, uint32_t encoding ) const;
+	void appendRawRect( QByteArray& message, const QRect& rect ) const;
+	void appendTightRect( QByteArray& message, const QRect& rect );
+	bool appendTightFillRect( QByteArray& message, const QRect& rect ) const;
+	bool appendTightJpegRect( QByteArray& message, const QRect& rect ) const;
+	void appendTightBasicRect( QByteArray& message, const QRect& rect );
+
+	static void appendCompactLength( QByteArray& data, int length );
+
+	QRect scaledRect( const QRect& rect ) const;
+
+	QSize m_requestedSize;
+
+	QImage m_framebuffer;
+	QImage m_thumbnail;
+
+	bool m_valid{false};
+	QRegion m_receivedRegion;
+	QRegion m_damagedRegion;
+
+	rfbPixelFormat m_clientPixelFormat{};
+	bool m_tightEncoding{false};
+	int m_jpegQuality{-1};
+	int m_compressLevel{DefaultCompressLevel};
+
+	z_stream m_zlibStream{};
+	bool m_zlibStreamInitialized{false};
+	bool m_zlibStreamReset{true};
+
+} ;
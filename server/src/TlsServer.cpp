@@ -24,27 +24,54 @@
 
 #include <QSslKey>
 #include <QSslSocket>
+#include <QTimer>
 
 #include "TlsServer.h"
 
 
 TlsServer::TlsServer( const VeyonCore::TlsConfiguration& tlsConfig, QObject* parent ) :
 	QTcpServer( parent ),
-	m_tlsConfig( tlsConfig )
+	m_tlsConfig( tlsConfig ),
+	m_serverThread( QThread::currentThread() )
 {
+	if( m_tlsConfig.localCertificate().isNull() == false && m_tlsConfig.privateKey().isNull() == false )
+	{
+		// perform the CPU intensive handshakes without blocking the processing of established connections
+		m_handshakeThread.setObjectName( QStringLiteral("TlsHandshake") );
+		m_handshakeContext = new QObject;
+		m_handshakeContext->moveToThread( &m_handshakeThread );
+
+		connect( this, &TlsServer::handshakeRequested, m_handshakeContext,
+				 [this]( qintptr socketDescriptor ) { startHandshake( socketDescriptor ); } );
+		connect( this, &TlsServer::connectionEncrypted, this, &TlsServer::addEncryptedConnection );
+
+		m_handshakeThread.start();
+	}
+}
+
+
+
+TlsServer::~TlsServer()
+{
+	m_handshakeThread.quit();
+	m_handshakeThread.wait();
+
+	// also deletes all sockets with pending handshakes
+	delete m_handshakeContext;
 }
 
 
 
 void TlsServer::incomingConnection( qintptr socketDescriptor )
 {
-	if( m_tlsConfig.localCertificate().isNull() || m_tlsConfig.privateKey().isNull() )
+	if( m_handshakeContext == nullptr )
 	{
 		auto socket = new QTcpSocket;
 		if( socket->setSocketDescriptor(socketDescriptor) )
 		{
 			vDebug() << "accepting unencrypted connection for socket" << socketDescriptor;
 			addPendingConnection( socket );
+			Q_EMIT connectionReady();
 		}
 		else
 		{
@@ -54,32 +81,76 @@ void TlsServer::incomingConnection( qintptr socketDescriptor )
 	}
 	else
 	{
-		auto socket = new QSslSocket;
-		if( socket->setSocketDescriptor(socketDescriptor) )
-		{
-			connect(socket, QOverload<const QList<QSslError>&>::of(&QSslSocket::sslErrors),
-					 [this, socket]( const QList<QSslError> &errors) {
-						 for( const auto& err : errors )
-						 {
-							 vCritical() << "SSL error" << err;
-						 }
-
-						 Q_EMIT tlsErrors( socket, errors );
-					 } );
+		Q_EMIT handshakeRequested( socketDescriptor );
+	}
+}
 
-			connect(socket, &QSslSocket::encrypted, this,
-					 []() { vDebug() << "connection encryption established"; } );
 
-			socket->setSslConfiguration( m_tlsConfig );
-			socket->startServerEncryption();
 
-			vDebug() << "establishing TLS connection for socket" << socketDescriptor;
-			addPendingConnection( socket );
-		}
-		else
-		{
-			vCritical() << "failed to set socket descriptor for incoming TLS connection";
-			delete socket;
-		}
+void TlsServer::startHandshake( qintptr socketDescriptor )
+{
+	auto socket = new QSslSocket( m_handshakeContext );
+	if( socket->setSocketDescriptor(socketDescriptor) == false )
+	{
+		vCritical() << "failed to set socket descriptor for incoming TLS connection";
+		delete socket;
+		return;
 	}
+
+	connect(socket, QOverload<const QList<QSslError>&>::of(&QSslSocket::sslErrors),
+			 []( const QList<QSslError> &errors) {
+				 for( const auto& err : errors )
+				 {
+					 vCritical() << "SSL error" << err;
+				 }
+			 } );
+
+	// all handshake-specific connections use the timer as context so that they are
+	// removed at once when deleting the timer after the handshake has finished
+	auto handshakeTimer = new QTimer( m_handshakeContext );
+	handshakeTimer->setSingleShot( true );
+	connect( handshakeTimer, &QTimer::timeout, socket, [socket]() {
+		vWarning() << "TLS handshake timed out";
+		socket->abort();
+		socket->deleteLater();
+	} );
+	connect( socket, &QSslSocket::encrypted, handshakeTimer, [this, socket, handshakeTimer]() {
+		finishHandshake( socket, handshakeTimer );
+	} );
+	connect( socket, &QSslSocket::disconnected, handshakeTimer, [socket]() { socket->deleteLater(); } );
+	connect( socket, &QObject::destroyed, handshakeTimer, &QObject::deleteLater );
+	handshakeTimer->start( HandshakeTimeout );
+
+	socket->setSslConfiguration( m_tlsConfig );
+	socket->startServerEncryption();
+
+	vDebug() << "establishing TLS connection for socket" << socketDescriptor;
+}
+
+
+
+void TlsServer::finishHandshake( QSslSocket* socket, QTimer* handshakeTimer )
+{
+	vDebug() << "connection encryption established";
+
+	// remove all handshake-specific connections right now as the timer is deleted deferred only
+	// and e.g. a disconnect must not delete the socket once it has been handed over
+	handshakeTimer->stop();
+	socket->disconnect( handshakeTimer );
+	handshakeTimer->disconnect( socket );
+	handshakeTimer->deleteLater();
+
+	// hand over the socket to the thread processing established connections
+	socket->setParent( nullptr );
+	socket->moveToThread( m_serverThread );
+
+	Q_EMIT connectionEncrypted( socket );
+}
+
+
+
+void TlsServer::addEncryptedConnection( QSslSocket* socket )
+{
+	addPendingConnection( socket );
+	Q_EMIT connectionReady();
 }
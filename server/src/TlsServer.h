@@ -26,23 +26,41 @@
 
 #include <QSslConfiguration>
 #include <QTcpServer>
+#include <QThread>
 
 #include "VeyonCore.h"
 
+class QSslSocket;
+class QTimer;
+
+// accepts connections and performs TLS handshakes in a separate thread - connections
+// are reported via connectionReady() once they can be taken via nextPendingConnection()
 class TlsServer : public QTcpServer
 {
 	Q_OBJECT
 public:
 	TlsServer( const VeyonCore::TlsConfiguration& tlsConfig, QObject* parent = nullptr );
-	~TlsServer() override = default;
+	~TlsServer() override;
 
 protected:
 	void incomingConnection( qintptr socketDescriptor ) override;
 
 private:
+	static constexpr int HandshakeTimeout = 10000;
+
+	void startHandshake( qintptr socketDescriptor );
+	void finishHandshake( QSslSocket* socket, QTimer* handshakeTimer );
+	void addEncryptedConnection( QSslSocket* socket );
+
 	VeyonCore::TlsConfiguration m_tlsConfig;
 
+	QThread m_handshakeThread{};
+	QObject* m_handshakeContext{nullptr};
+	QThread* m_serverThread;
+
 Q_SIGNALS:
-	void tlsErrors( QSslSocket* socket, const QList<QSslError>& errors );
+	void connectionReady();
+	void handshakeRequested( qintptr socketDescriptor );
+	void connectionEncrypted( QSslSocket* socket );
 
 } ;
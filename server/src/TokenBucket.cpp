@@ -0,0 +1,90 @@
+/*
+ * TokenBucket.cpp - implementation of TokenBucket class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <QtGlobal>
+
+#include "TokenBucket.h"
+
+
+TokenBucket::TokenBucket()
+{
+	m_refillTimer.start();
+}
+
+
+
+void TokenBucket::setRate(qint64 bytesPerSecond)
+{
+	refill();
+
+	m_rate = qMax<qint64>(0, bytesPerSecond);
+	m_tokens = qMin(m_tokens, m_rate * BurstDuration / 1000);
+}
+
+
+
+void TokenBucket::consume(qint64 bytes)
+{
+	m_statistics.consumedBytes += quint64(bytes);
+
+	if (isEnabled())
+	{
+		refill();
+		m_tokens -= bytes;
+	}
+}
+
+
+
+int TokenBucket::defer()
+{
+	if (isEnabled() == false)
+	{
+		return 0;
+	}
+
+	refill();
+
+	if (m_tokens >= 0)
+	{
+		return 0;
+	}
+
+	++m_statistics.deferrals;
+
+	return int(qMin<qint64>(-m_tokens * 1000 / m_rate + 1, MaximumDelay));
+}
+
+
+
+void TokenBucket::refill()
+{
+	const auto elapsed = m_refillTimer.nsecsElapsed();
+	m_refillTimer.restart();
+
+	if (isEnabled())
+	{
+		m_tokens = qMin(m_tokens + qint64(double(elapsed) * double(m_rate) / 1000000000.0), m_rate * BurstDuration / 1000);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+ * TokenBucket.h - declaration of TokenBucket class
+ *
+ * Copyright (c) 2026 Tobias Junghans <tobydox@veyon.io>
+ *
+ * This file is part of Veyon - https://veyon.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+
+// limits the average data rate to a configurable number of bytes per second while
+// allowing short bursts, consumption may exceed the available budget (debt) since the
+// size of a framebuffer update is not known before requesting it
+class TokenBucket
+{
+public:
+	struct Statistics
+	{
+		quint64 consumedBytes{0};
+		quint64 deferrals{0};
+	};
+
+	TokenBucket();
+
+	// a rate of 0 disables the limit
+	void setRate(qint64 bytesPerSecond);
+
+	qint64 rate() const
+	{
+		return m_rate;
+	}
+
+	bool isEnabled() const
+	{
+		return m_rate > 0;
+	}
+
+	void consume(qint64 bytes);
+
+	// returns the number of milliseconds to wait until the budget is available again
+	int defer();
+
+	const Statistics& statistics() const
+	{
+		return m_statistics;
+	}
+
+private:
+	static constexpr int BurstDuration = 500;
+	static constexpr int MaximumDelay = 5000;
+
+	void refill();
+
+	qint64 m_rate{0};
+	qint64 m_tokens{0};
+	QElapsedTimer m_refillTimer;
+
+	Statistics m_statistics;
+
+} ;
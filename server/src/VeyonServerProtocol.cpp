@@ -48,7 +48,12 @@ VeyonServerProtocol::AuthMethodUids VeyonServerProtocol::supportedAuthMethodUids
 	const auto authPlugins = VeyonCore::authenticationManager().plugins();
 
 	AuthMethodUids authMethodUids;
-	authMethodUids.reserve( authPlugins.size() );
+	authMethodUids.reserve( authPlugins.size() + 1 );
+
+	if( m_serverAuthenticationManager.authenticationTicketLifetime() > 0 )
+	{
+		authMethodUids.append( AuthenticationManager::ticketAuthMethodUid() );
+	}
 
 	for( auto it = authPlugins.constBegin(), end = authPlugins.constEnd(); it != end; ++it )
 	{
@@ -22,10 +22,9 @@
  *
  */
 
-#include <QBuffer>
+#include <QElapsedTimer>
 #include <QHostAddress>
 #include <QTcpSocket>
-#include <QTimer>
 
 #include "VncClientProtocol.h"
 #include "VncProxyConnection.h"
@@ -49,6 +48,19 @@ VncProxyConnection::VncProxyConnection( QTcpSocket* clientSocket,
 	connect( m_proxyClientSocket, &QTcpSocket::readyRead, this, &VncProxyConnection::readFromClient );
 	connect( m_vncServerSocket, &QTcpSocket::readyRead, this, &VncProxyConnection::readFromServer );
 
+	// use one timer per direction so that retries do not pile up while waiting for the other side
+	m_readFromClientTimer.setSingleShot( true );
+	m_readFromServerTimer.setSingleShot( true );
+	connect( &m_readFromClientTimer, &QTimer::timeout, this, &VncProxyConnection::readFromClient );
+	connect( &m_readFromServerTimer, &QTimer::timeout, this, &VncProxyConnection::readFromServer );
+
+	connect( m_proxyClientSocket, &QTcpSocket::bytesWritten, this, [this]( qint64 bytes ) {
+		m_bytesWrittenToClient += quint64(bytes);
+	} );
+	connect( m_vncServerSocket, &QTcpSocket::bytesWritten, this, [this]( qint64 bytes ) {
+		m_bytesWrittenToServer += quint64(bytes);
+	} );
+
 	connect( m_vncServerSocket, &QTcpSocket::disconnected, this, &VncProxyConnection::clientConnectionClosed );
 	connect( m_proxyClientSocket, &QTcpSocket::disconnected, this, &VncProxyConnection::serverConnectionClosed );
 }
@@ -57,6 +69,14 @@ VncProxyConnection::VncProxyConnection( QTcpSocket* clientSocket,
 
 VncProxyConnection::~VncProxyConnection()
 {
+	if( m_bytesWrittenToClient > 0 )
+	{
+		const auto megabytes = qreal(m_bytesWrittenToClient + m_bytesWrittenToServer) / ( 1024 * 1024 );
+		vDebug() << "forwarded" << m_bytesWrittenToClient << "bytes to client and"
+				 << m_bytesWrittenToServer << "bytes to server using" << m_processingTime / 1000000 << "ms"
+				 << "processing time" << ( megabytes > 0 ? qreal(m_processingTime) / 1000000 / megabytes : 0 ) << "ms/MB";
+	}
+
 	// do not get notified about disconnects any longer
 	disconnect( m_vncServerSocket );
 	disconnect( m_proxyClientSocket );
@@ -74,18 +94,37 @@ void VncProxyConnection::start()
 
 
 
+bool VncProxyConnection::isRunning()
+{
+	return clientProtocol().state() == VncClientProtocol::State::Running &&
+			serverProtocol().state() == VncServerProtocol::State::Running;
+}
+
+
+
 void VncProxyConnection::readFromClient()
 {
+	QElapsedTimer processingTimer;
+	processingTimer.start();
+
 	if( serverProtocol().state() != VncServerProtocol::State::Running )
 	{
 		while( serverProtocol().read() ) // Flawfinder: ignore
 		{
 		}
 
-		// try again later in case we could not proceed because of
-		// external protocol dependencies or in case we're finished
-		// and already have RFB messages in receive queue
-		readFromClientLater();
+		if( serverProtocol().state() == VncServerProtocol::State::Running )
+		{
+			// process RFB messages which already are in the receive queues right away
+			m_readFromClientTimer.start( 0 );
+			m_readFromServerTimer.start( 0 );
+		}
+		else
+		{
+			// try again later in case we could not proceed because of
+			// external protocol dependencies
+			readFromClientLater();
+		}
 	}
 	else if( clientProtocol().state() == VncClientProtocol::State::Running )
 	{
@@ -106,12 +145,17 @@ void VncProxyConnection::readFromClient()
 
 		clientProtocol().start();
 	}
+
+	m_processingTime += processingTimer.nsecsElapsed();
 }
 
 
 
 void VncProxyConnection::readFromServer()
 {
+	QElapsedTimer processingTimer;
+	processingTimer.start();
+
 	if( clientProtocol().state() != VncClientProtocol::State::Running )
 	{
 		while( clientProtocol().read() ) // Flawfinder: ignore
@@ -127,7 +171,9 @@ void VncProxyConnection::readFromServer()
 			// we can forward to the real client
 			serverProtocol().setServerInitMessage( clientProtocol().serverInitMessage() );
 
-			readFromServerLater();
+			// continue immediately instead of waiting for the next retry
+			m_readFromServerTimer.start( 0 );
+			m_readFromClientTimer.start( 0 );
 		}
 	}
 	else if( serverProtocol().state() == VncServerProtocol::State::Running )
@@ -142,52 +188,64 @@ void VncProxyConnection::readFromServer()
 		// try again as server connection is not yet ready and we can't forward data
 		readFromServerLater();
 	}
+
+	m_processingTime += processingTimer.nsecsElapsed();
 }
 
 
 
 bool VncProxyConnection::forwardDataToClient( qint64 size )
 {
-	if( m_vncServerSocket->bytesAvailable() >= size )
-	{
-		const auto data = m_vncServerSocket->read( size ); // Flawfinder: ignore
-		if( data.size() == size )
-		{
-			return m_proxyClientSocket->write( data ) == size;
-		}
-	}
-
-	return false;
+	return forwardData( m_vncServerSocket, m_proxyClientSocket, size );
 }
 
 
 
 bool VncProxyConnection::forwardDataToServer( qint64 size )
 {
-	if( m_proxyClientSocket->bytesAvailable() >= size )
-	{
-		const auto data = m_proxyClientSocket->read( size ); // Flawfinder: ignore
-		if( data.size() == size )
-		{
-			return m_vncServerSocket->write( data ) == size;
-		}
-	}
-
-	return false;
+	return forwardData( m_proxyClientSocket, m_vncServerSocket, size );
 }
 
 
 
 void VncProxyConnection::readFromServerLater()
 {
-	QTimer::singleShot( ProtocolRetryTime, this, &VncProxyConnection::readFromServer );
+	if( m_readFromServerTimer.isActive() == false )
+	{
+		m_readFromServerTimer.start( ProtocolRetryTime );
+	}
 }
 
 
 
 void VncProxyConnection::readFromClientLater()
 {
-	QTimer::singleShot( ProtocolRetryTime, this, &VncProxyConnection::readFromClient );
+	if( m_readFromClientTimer.isActive() == false )
+	{
+		m_readFromClientTimer.start( ProtocolRetryTime );
+	}
+}
+
+
+
+bool VncProxyConnection::forwardData( QTcpSocket* source, QTcpSocket* target, qint64 size )
+{
+	if( source->bytesAvailable() < size )
+	{
+		return false;
+	}
+
+	if( m_forwardBuffer.size() < size )
+	{
+		m_forwardBuffer.resize( int(size) );
+	}
+
+	if( source->read( m_forwardBuffer.data(), size ) != size ) // Flawfinder: ignore
+	{
+		return false;
+	}
+
+	return target->write( m_forwardBuffer.constData(), size ) == size;
 }
 
 
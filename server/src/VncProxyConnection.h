@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <QTimer>
+
 #include "VeyonCore.h"
 
 class QBuffer;
@@ -51,6 +53,9 @@ public:
 		return m_vncServerSocket;
 	}
 
+	// both protocols have been initialized and messages are forwarded in both directions
+	bool isRunning();
+
 protected Q_SLOTS:
 	void readFromClient();
 	void readFromServer();
@@ -71,6 +76,8 @@ protected:
 private:
 	static constexpr int ProtocolRetryTime = 250;
 
+	bool forwardData( QTcpSocket* source, QTcpSocket* target, qint64 size );
+
 	const int m_vncServerPort;
 
 	QTcpSocket* m_proxyClientSocket;
@@ -78,6 +85,16 @@ private:
 
 	const QMap<int, int> m_rfbClientToServerMessageSizes;
 
+	// reused for all forwarded messages to avoid an allocation per message
+	QByteArray m_forwardBuffer;
+
+	QTimer m_readFromClientTimer{this};
+	QTimer m_readFromServerTimer{this};
+
+	quint64 m_bytesWrittenToClient{0};
+	quint64 m_bytesWrittenToServer{0};
+	qint64 m_processingTime{0};
+
 Q_SIGNALS:
 	void clientConnectionClosed();
 	void serverConnectionClosed();
@@ -41,7 +41,7 @@ VncProxyServer::VncProxyServer( const QHostAddress& listenAddress,
 	m_server( new TlsServer( VeyonCore::TlsConfiguration::defaultConfiguration(), this ) ),
 	m_connectionFactory( connectionFactory )
 {
-	connect( m_server, &QTcpServer::newConnection, this, &VncProxyServer::acceptConnection );
+	connect( m_server, &TlsServer::connectionReady, this, &VncProxyServer::acceptConnection );
 	connect( m_server, &QTcpServer::acceptError, this, &VncProxyServer::handleAcceptError );
 }
 
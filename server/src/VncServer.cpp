@@ -90,6 +90,10 @@ VncServer::VncServer( QObject* parent ) :
 VncServer::~VncServer()
 {
 	vDebug();
+
+	// allow VNC server plugins which check for interruption requests to shut down cleanly
+	requestInterruption();
+	wait( ShutdownTimeout );
 }
 
 
@@ -48,6 +48,8 @@ public:
 	Password password() const;
 
 private:
+	static constexpr auto ShutdownTimeout = 250;
+
 	void run() override;
 
 	VncServerPluginInterface* m_pluginInterface;
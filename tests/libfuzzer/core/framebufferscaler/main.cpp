@@ -0,0 +1,52 @@
+#include <QImage>
+
+#include "FramebufferScaler.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const char *data, size_t size)
+{
+	if (size < 4)
+	{
+		return 0;
+	}
+
+	const auto sourceWidth = 1 + uchar(data[0]) % 64;
+	const auto sourceHeight = 1 + uchar(data[1]) % 64;
+	const auto targetWidth = 1 + uchar(data[2]) % sourceWidth;
+	const auto targetHeight = 1 + uchar(data[3]) % sourceHeight;
+
+	QImage source(sourceWidth, sourceHeight, QImage::Format_RGB32);
+	const auto pixelData = QByteArray::fromRawData(data+4, int(size-4));
+	for (int i = 0; i < int(source.sizeInBytes()); ++i)
+	{
+		source.bits()[i] = pixelData.isEmpty() ? 0 : uchar(pixelData[i % pixelData.size()]);
+	}
+
+	const QSize targetSize(targetWidth, targetHeight);
+	const auto reference = FramebufferScaler::scaled(source, targetSize, Qt::IgnoreAspectRatio,
+													 FramebufferScaler::Implementation::Scalar);
+
+	// all accelerated implementations have to produce exactly the same pixels as the scalar reference
+	for (auto implementation : {FramebufferScaler::Implementation::SSE2,
+								FramebufferScaler::Implementation::AVX2,
+								FramebufferScaler::Implementation::NEON})
+	{
+		if (FramebufferScaler::isSupported(implementation) &&
+			FramebufferScaler::scaled(source, targetSize, Qt::IgnoreAspectRatio, implementation) != reference)
+		{
+			abort();
+		}
+	}
+
+	// updating parts of a scaled image has to match scaling the whole image
+	auto partial = reference;
+	partial.fill(Qt::black);
+	const auto splitY = targetHeight / 2;
+	FramebufferScaler::scaleRect(source, partial, QRect(0, 0, targetWidth, splitY));
+	FramebufferScaler::scaleRect(source, partial, QRect(0, splitY, targetWidth, targetHeight - splitY));
+	if (partial != reference)
+	{
+		abort();
+	}
+
+	return 0;
+}
@@ -1,5 +1,7 @@
 #include <QBuffer>
 
+#include <cstdlib>
+
 #include "VncClientProtocol.h"
 
 class VncClientProtocolTest : public VncClientProtocol
@@ -18,6 +20,38 @@ public:
 };
 
 
+// receive all messages while feeding the data in segments of the given size and
+// return the received messages along with the parsed rects of framebuffer updates
+static QByteArrayList receiveMessages(const QByteArray& data, int segmentSize)
+{
+	QBuffer buffer;
+	buffer.open(QIODevice::ReadWrite);
+
+	VncClientProtocolTest protocol(&buffer);
+	protocol.init(char(VncClientProtocol::State::Running));
+
+	QByteArrayList messages;
+
+	for (int offset = 0; offset < data.size() && buffer.isOpen(); offset += segmentSize)
+	{
+		buffer.buffer().append(data.mid(offset, segmentSize));
+
+		while (buffer.isOpen() && protocol.receiveMessage())
+		{
+			auto message = protocol.lastMessage();
+			for (const auto& rect : protocol.lastRects())
+			{
+				message.append(reinterpret_cast<const char *>(&rect.dataOffset), sizeof(rect.dataOffset));
+				message.append(reinterpret_cast<const char *>(&rect.dataSize), sizeof(rect.dataSize));
+			}
+			messages.append(message);
+		}
+	}
+
+	return messages;
+}
+
+
 extern "C" int LLVMFuzzerTestOneInput(const char *data, size_t size)
 {
 	if (size < 3)
@@ -25,14 +59,27 @@ extern "C" int LLVMFuzzerTestOneInput(const char *data, size_t size)
 		return 0;
 	}
 
+	const auto mode = data[0];
+	const auto state = data[1];
+
+	if (mode == 2)
+	{
+		// messages must not depend on how the data is split into segments while receiving
+		const auto input = QByteArray::fromRawData(data+2, size-2);
+		const auto segmentSize = 1 + uint8_t(state);
+		if (receiveMessages(input, input.size()) != receiveMessages(input, segmentSize))
+		{
+			abort();
+		}
+
+		return 0;
+	}
+
 	QBuffer buffer;
 	buffer.open(QIODevice::ReadWrite);
 
 	VncClientProtocolTest protocol(&buffer);
 
-	const auto mode = data[0];
-	const auto state = data[1];
-
 	protocol.init(state);
 
 	buffer.write(QByteArray::fromRawData(data+2, size-2));